@@ -17,10 +17,12 @@ Description :
 The application is composed of three sections :
 
 - System Initialization - Initializes peripherals and pins.
-- Application Initialization - Initializes UART interface, performs a reset of the device and powers up control of
-  Low Drop Out (LDO).
-- Application Task - (code snippet) - Always checks does response ready and, when is ready, processes a response.
-Note : The Sound library is used to play sound on buzzer every time when R interval on the ECG signal happened.
+- Application Initialization - Initializes UART interface, starts the reset of the device and the power up of the control
+  of Low Drop Out (LDO), initializes the processing while they run, and waits until the device is ready.
+- Application Task - (code snippet) - Puts the core in the idle mode until response is ready, processes a response
+  streams a part of the lead-off capture and writes a part of the log queue.
+Note : The Sound library is used to play sound on buzzer every time when the QRS detector finds a beat (R peak)
+on the ECG signal, while the leads are on.
 The Sound Play command can make a delay time which is necessary for play command to be performed.
 If you don't need to make sound on buzzer, please disable the Sound Init and Sound Play functions.
 
@@ -28,38 +30,87 @@ Additional Functions :
 
 - interrupt - Always checks does new data ready for reading from uart rx buffer, and if is it true reads one byte data from uart
   and makes a response sequence.
-- plotData - Sends a desired data (Raw Data) to the serial plotter.
-- logData - Sends data to the uart terminal and shows results.
+- logWrite - Writes a text of the log queue to the log link. The application task writes at most 6 bytes of the queue
+  (1 ms at 57600 baud) after every response, so the blocking write ends before the next response (1.95 ms).
+- logQueue - Returns the log queue occupancy, which sets the decimation level of the plot.
+- plotData - Queues a desired data (Raw Data) for the serial plotter. Raw Data is decimated to fit what the log queue
+  writes, keeping the minimum and maximum of every decimation window, so the QRS peaks stay visible.
+- logData - Queues data for the uart terminal and shows results.
+- logLeadoff - Shows the lead-off state detected from Raw Data, within tens of milliseconds.
+- captureStream - Streams the frozen capture window to the log queue in the background, one sample per response
+  while the queue has room, between a line with the window position and a line with the samples the history
+  could not keep meanwhile.
+- logDuty - Shows every 10 seconds the share of time the core spent in the idle mode, waiting for data.
 - makeResponse - Pars a response to the buffer.
-- processResponse - Processes a parsed response and makes a decide where response will be showed.
+- filterStage - Pipeline stage which removes the baseline wander and the 50 Hz mains interference from Raw Data
+  in place, so the next stages get the filtered data.
+- plotStage - Pipeline stage which decimates the filtered data and plots it, only while the sensor is on and settled.
+- beatStage - Pipeline stage which passes Raw Data to the QRS detector and the detected beats to the beat-to-beat heart rate,
+  also while the pipeline settles after the sensor is back on, when the QRS detector is re-initialized.
+- processResponse - Processes a parsed response and makes a decide where response will be showed. Raw Data is passed
+  to the event capture, to the lead-off detector and to the pipeline, which skips all stages while the sensor is off
+  (signal quality 0 or lead-off). The capture is triggered when the leads go off, so it keeps the Raw Data before
+  and after it.
+- timerInit - Starts TIM2 with a 1 ms interrupt, which calls ecg4_tick, the time base of the reset
+  sequence and of the idle time statistics.
+- waitReady - Polls the reset sequence driven by ecg4_tick until the first verified response, and shows the measured
+  ready time.
 
 */
 
 #include "Click_ECG_4_types.h"
 #include "Click_ECG_4_config.h"
+#include "__ecg4_decim.h"
+#include "__ecg4_logq.h"
+#include "__ecg4_pipeline.h"
+#include "__ecg4_filter.h"
+#include "__ecg4_qrs.h"
+#include "__ecg4_hr.h"
+#include "__ecg4_leadoff.h"
+#include "__ecg4_capture.h"
 
 const uint8_t RX_UART_READY = 1;
+const uint16_t LOG_TX_BUDGET = 6;
+const uint16_t LOG_QUALITY_LEN = 62;
+const uint16_t LOG_HEART_RATE_LEN = 38;
+const uint16_t LOG_CAPTURE_LEN = 64;
+const uint16_t LOG_DUTY_LEN = 26;
+const uint32_t LOG_DUTY_MS = 10000;
+const uint16_t RESET_TIMEOUT_MS = 1000;
 
 uint8_t response[ 256 ];
 uint8_t row_counter;
+T_ecg4_decim plot_decim;
+T_ecg4_logq log_q;
+T_ecg4_pipeline pipe;
+T_ecg4_filter flt;
+T_ecg4_qrs qrs;
+T_ecg4_hr hr;
+T_ecg4_leadoff leadoff;
+T_ecg4_capture cap;
+uint16_t capture_pos;
 uint32_t plot_x;
 uint8_t row_size_cnt;
-T_ECG4_RETVAL resp_ready;
+T_ecg4_duty duty;
+
+void logWrite( char *text )
+{
+    mikrobus_logWrite( text, _LOG_TEXT );
+}
+
+uint8_t logQueue()
+{
+    return ecg4_logq_occupancy( &log_q );
+}
 
 void plotData( int16_t plot_data )
 {
-    char plot_string[ 50 ];
+    char plot_string[ 20 ];
     
     IntToStr( plot_data, plot_string );
-    mikrobus_logWrite( plot_string, _LOG_TEXT );
-    mikrobus_logWrite( ",", _LOG_TEXT );
-    LongWordToStr( plot_x, plot_string );
-    mikrobus_logWrite( plot_string, _LOG_LINE );
-    
-    if (plot_data > 4000)
-    {
-        Sound_Play( 520, 25 );
-    }
+    plot_string[ 6 ] = ',';
+    LongWordToStr( plot_x, &plot_string[ 7 ] );
+    ecg4_logq_line( &log_q, plot_string );
     
     if (plot_x == 0xFFFFFFFF)
     {
@@ -69,27 +120,138 @@ void plotData( int16_t plot_data )
     {
         plot_x++;
     }
+}
+
+void filterStage( void *ctx, int16_t *samples, uint16_t n_samples )
+{
+    (void)ctx;
+    ecg4_filter_block( &flt, samples, n_samples );
+}
+
+void filterReset( void *ctx )
+{
+    (void)ctx;
+    ecg4_filter_init( &flt, 7, _ECG4_FILTER_NOTCH_50HZ );
+}
+
+void plotStage( void *ctx, int16_t *samples, uint16_t n_samples )
+{
+    int16_t plot_out[ 2 ];
+    uint8_t plot_cnt;
+    uint8_t plot_idx;
+    uint16_t cnt;
+    
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        plot_cnt = ecg4_decim_push( &plot_decim, samples[ cnt ], plot_out );
+        
+        for (plot_idx = 0; plot_idx < plot_cnt; plot_idx++)
+        {
+            plotData( plot_out[ plot_idx ] );
+        }
+    }
+}
+
+void beatStage( void *ctx, int16_t *samples, uint16_t n_samples )
+{
+    uint8_t beat;
+    uint16_t cnt;
     
-    Delay_ms( 3 );
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        beat = ecg4_qrs_process( &qrs, samples[ cnt ] );
+        ecg4_hr_update( &hr, &qrs, beat );
+        
+        if (beat && (ecg4_pipe_state( &pipe ) == _ECG4_PIPE_ON))
+        {
+            Sound_Play( 520, 25 );
+        }
+    }
+}
+
+void beatReset( void *ctx )
+{
+    ecg4_qrs_init( &qrs );
 }
 
 void logData( uint8_t code_val, uint8_t data_val )
 {
     char log_string[ 20 ];
 
-    if (code_val == _ECG4_SIGNAL_QUALITY_CODE_BYTE)
+    if ((code_val == _ECG4_SIGNAL_QUALITY_CODE_BYTE) && (ecg4_logq_free( &log_q ) >= LOG_QUALITY_LEN))
     {
-        mikrobus_logWrite( "** Signal Quality (0 - sensor off, 200 - sensor on) : ", _LOG_TEXT );
+        ecg4_logq_text( &log_q, "** Signal Quality (0 - sensor off, 200 - sensor on) : " );
         ByteToStr( data_val, log_string );
-        mikrobus_logWrite( log_string, _LOG_TEXT );
-        mikrobus_logWrite( " **", _LOG_LINE );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " **" );
     }
-    else if (code_val == _ECG4_HEART_RATE_CODE_BYTE)
+    else if ((code_val == _ECG4_HEART_RATE_CODE_BYTE) && (ecg4_logq_free( &log_q ) >= LOG_HEART_RATE_LEN))
     {
-        mikrobus_logWrite( "** Real-time Heart Rate : ", _LOG_TEXT );
+        ecg4_logq_text( &log_q, "** Real-time Heart Rate : " );
         ByteToStr( data_val, log_string );
-        mikrobus_logWrite( log_string, _LOG_TEXT );
-        mikrobus_logWrite( " BPM **", _LOG_LINE );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " BPM **" );
+    }
+}
+
+void logLeadoff()
+{
+    if (ecg4_leadoff_state( &leadoff ) == _ECG4_LEADS_OFF)
+    {
+        ecg4_logq_line( &log_q, "** Leads off **" );
+    }
+    else
+    {
+        ecg4_logq_line( &log_q, "** Leads on **" );
+    }
+}
+
+void logDuty()
+{
+    char log_string[ 20 ];
+
+    ecg4_duty_get( &duty );
+
+    if ((duty.total_ms < LOG_DUTY_MS) || (ecg4_logq_free( &log_q ) < LOG_DUTY_LEN))
+    {
+        return;
+    }
+
+    ecg4_logq_text( &log_q, "** CPU idle : " );
+    WordToStr( (uint16_t)(duty.idle_ms * 100 / duty.total_ms), log_string );
+    ecg4_logq_text( &log_q, log_string );
+    ecg4_logq_line( &log_q, " % **" );
+    ecg4_duty_clear();
+}
+
+void captureStream()
+{
+    T_ecg4_capture_info info;
+    int16_t sample;
+    char log_string[ 20 ];
+    
+    if (ecg4_capture_info( &cap, &info ) && (ecg4_logq_free( &log_q ) >= LOG_CAPTURE_LEN))
+    {
+        if (capture_pos == 0)
+        {
+            ecg4_logq_text( &log_q, "** Lead-off capture from sample " );
+            LongWordToStr( info.first_n, log_string );
+            ecg4_logq_text( &log_q, log_string );
+            ecg4_logq_line( &log_q, " **" );
+        }
+        
+        ecg4_capture_read( &cap, &sample, 1 );
+        capture_pos++;
+        IntToStr( sample, log_string );
+        ecg4_logq_line( &log_q, log_string );
+        
+        if (capture_pos == info.len)
+        {
+            ecg4_logq_text( &log_q, "** Capture end, history gap of " );
+            LongWordToStr( info.missed, log_string );
+            ecg4_logq_text( &log_q, log_string );
+            ecg4_logq_line( &log_q, " samples **" );
+        }
     }
 }
 
@@ -130,7 +292,32 @@ void processResponse()
             raw_data <<= 8;
             raw_data |= response[ idx_cnt + 3 ];
             
-            plotData( raw_data );
+            if (ecg4_capture_push( &cap, raw_data ))
+            {
+                capture_pos = 0;
+            }
+            
+            if (ecg4_leadoff_process( &leadoff, raw_data ))
+            {
+                ecg4_pipe_leadoff( &pipe, ecg4_leadoff_state( &leadoff ) == _ECG4_LEADS_OFF );
+                logLeadoff();
+                
+                if (ecg4_leadoff_state( &leadoff ) == _ECG4_LEADS_OFF)
+                {
+                    ecg4_capture_trigger( &cap, _ECG4_CAPTURE_LEADOFF );
+                }
+            }
+            
+            ecg4_pipe_process( &pipe, &raw_data, 1 );
+        }
+        else if (response[ idx_cnt ] == _ECG4_SIGNAL_QUALITY_CODE_BYTE)
+        {
+            ecg4_hr_quality( &hr, response[ idx_cnt + 2 ] );
+            ecg4_pipe_quality( &pipe, response[ idx_cnt + 2 ] );
+        }
+        else if (response[ idx_cnt ] == _ECG4_HEART_RATE_CODE_BYTE)
+        {
+            ecg4_hr_device( &hr, response[ idx_cnt + 2 ] );
         }
         
         /*if ((response[ idx_cnt ] == _ECG4_SIGNAL_QUALITY_CODE_BYTE) || (response[ idx_cnt ] == _ECG4_HEART_RATE_CODE_BYTE))
@@ -142,6 +329,42 @@ void processResponse()
     }
 }
 
+void timerInit()
+{
+    // 72 MHz / (1 + 1) / (35999 + 1) = 1 kHz
+    TIM2EN_bit = 1;
+    CEN_TIM2_CR1_bit = 0;
+    TIM2_PSC = 1;
+    TIM2_ARR = 35999;
+    NVIC_IntEnable( IVT_INT_TIM2 );
+    UIE_TIM2_DIER_bit = 1;
+    CEN_TIM2_CR1_bit = 1;
+}
+
+void waitReady()
+{
+    char log_string[ 20 ];
+    uint8_t reset_state;
+
+    do
+    {
+        reset_state = ecg4_reset_poll();
+    }
+    while (reset_state == _ECG4_RESET_IN_PROGRESS);
+
+    if (reset_state == _ECG4_RESET_READY)
+    {
+        ecg4_logq_text( &log_q, "** ECG 4 is ready after " );
+        WordToStr( ecg4_reset_ready_time(), log_string );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " ms **" );
+    }
+    else
+    {
+        ecg4_logq_line( &log_q, "** ECG 4 does not respond **" );
+    }
+}
+
 void systemInit()
 {
     mikrobus_gpioInit( _MIKROBUS1, _MIKROBUS_RST_PIN, _GPIO_OUTPUT );
@@ -159,31 +382,41 @@ void applicationInit()
 {
     ecg4_uartDriverInit( (T_ECG4_P)&_MIKROBUS1_GPIO, (T_ECG4_P)&_MIKROBUS1_UART );
     ecg4_response_handler_set( &makeResponse );
-    Delay_ms( 300 );
-    
-    ecg4_reset();
-    ecg4_enable_LDO_ctrl( _ECG4_ENABLE_LDO_CTRL );
+    ecg4_reset_start( RESET_TIMEOUT_MS );
     Sound_Init( &GPIOE_ODR, 14 );
-    Delay_ms( 200 );
+    
+    ecg4_logq_init( &log_q, &logWrite );
+    ecg4_decim_init( &plot_decim, 57600, 512, 256, 4 );
+    ecg4_decim_queue( &plot_decim, &logQueue );
+    ecg4_filter_init( &flt, 7, _ECG4_FILTER_NOTCH_50HZ );
+    ecg4_qrs_init( &qrs );
+    ecg4_hr_init( &hr );
+    ecg4_leadoff_init( &leadoff );
+    ecg4_capture_init( &cap );
+    ecg4_pipe_init( &pipe, 512 );
+    ecg4_pipe_register( &pipe, &filterStage, &filterReset, 0, _ECG4_PIPE_RUN_SETTLING );
+    ecg4_pipe_register( &pipe, &beatStage, &beatReset, 0, _ECG4_PIPE_RUN_SETTLING );
+    ecg4_pipe_register( &pipe, &plotStage, 0, 0, 0 );
 	
 	plot_x = 0;
 
     RXNEIE_USART3_CR1_bit = 1;
     NVIC_IntEnable( IVT_INT_USART3 );
+    timerInit();
     EnableInterrupts();
     
-    mikrobus_logWrite( "** ECG 4 is initialized **", _LOG_LINE );
-    mikrobus_logWrite( "", _LOG_LINE );
+    waitReady();
+    ecg4_logq_line( &log_q, "** ECG 4 is initialized **" );
+    ecg4_logq_line( &log_q, "" );
 }
 
 void applicationTask()
 {
-    resp_ready = ecg4_responseReady();
-    
-    if (resp_ready == _ECG4_RESPONSE_READY)
-    {
-        processResponse();
-    }
+    ecg4_wait_for_data();
+    processResponse();
+    captureStream();
+    logDuty();
+    ecg4_logq_drain( &log_q, LOG_TX_BUDGET );
 }
 
 void main()
@@ -204,3 +437,9 @@ void RX_ISR() iv IVT_INT_USART3 ics ICS_AUTO
         ecg4_uart_isr();
     }
 }
+
+void Timer2_ISR() iv IVT_INT_TIM2 ics ICS_AUTO
+{
+    UIF_TIM2_SR_bit = 0;
+    ecg4_tick();
+}
@@ -17,40 +17,73 @@ Description :
 The application is composed of three sections :
 
 - System Initialization - Initializes peripherals and pins.
-- Application Initialization - Initializes UART interface, performs a reset of the device and powers up control of
-  Low Drop Out (LDO).
-- Application Task - (code snippet) - Always checks does response ready and, when is ready, processes a response.
+- Application Initialization - Initializes UART interface, starts the reset of the device and the power up of the control
+  of Low Drop Out (LDO), initializes the processing while they run, and waits until the device is ready.
+- Application Task - (code snippet) - Puts the core in the idle mode until response is ready, processes a response
+  and writes a part of the log queue.
 
 Additional Functions :
 
 - interrupt - Always checks does new data ready for reading from uart rx buffer, and if is it true reads one byte data from uart
   and makes a response sequence.
-- plotData - Sends a desired data (Raw Data) to the serial plotter.
-- logData - Sends data to the uart terminal and shows results.
+- logWrite - Writes a text of the log queue to the log link. The application task writes at most 6 bytes of the queue
+  (1 ms at 57600 baud) after every response, so the blocking write ends before the next response (1.95 ms).
+- logQueue - Returns the log queue occupancy, which sets the decimation level of the plot.
+- plotData - Queues a desired data (Raw Data) for the serial plotter. Raw Data is decimated to fit what the log queue
+  writes, keeping the minimum and maximum of every decimation window, so the QRS peaks stay visible.
+- logData - Queues data for the uart terminal and shows results.
+- logDuty - Shows every 10 seconds the share of time the core spent in the idle mode, waiting for data.
 - makeResponse - Pars a response to the buffer.
-- processResponse - Processes a parsed response and makes a decide where response will be showed.
+- plotStage - Pipeline stage which decimates Raw Data and plots it, only while the sensor is on and settled.
+- processResponse - Processes a parsed response and makes a decide where response will be showed. Raw Data is passed
+  to the pipeline, which skips plotting while the signal quality reports the sensor off.
+- timerInit - Starts the Timer 0 A with a 1 ms interrupt, which calls ecg4_tick, the time base of the reset
+  sequence and of the idle time statistics.
+- waitReady - Polls the reset sequence driven by ecg4_tick until the first verified response, and shows the measured
+  ready time.
 
 */
 
 #include "Click_ECG_4_types.h"
 #include "Click_ECG_4_config.h"
+#include "__ecg4_decim.h"
+#include "__ecg4_logq.h"
+#include "__ecg4_pipeline.h"
 
 const uint8_t RX_UART_READY = 1;
+const uint16_t LOG_TX_BUDGET = 6;
+const uint16_t LOG_QUALITY_LEN = 62;
+const uint16_t LOG_HEART_RATE_LEN = 38;
+const uint16_t LOG_DUTY_LEN = 26;
+const uint32_t LOG_DUTY_MS = 10000;
+const uint16_t RESET_TIMEOUT_MS = 1000;
 
 uint8_t response[ 256 ];
 uint8_t row_counter;
-T_ECG4_RETVAL resp_ready;
+T_ecg4_decim plot_decim;
+T_ecg4_logq log_q;
+T_ecg4_pipeline pipe;
+T_ecg4_duty duty;
+
+void logWrite( char *text )
+{
+    mikrobus_logWrite( text, _LOG_TEXT );
+}
+
+uint8_t logQueue()
+{
+    return ecg4_logq_occupancy( &log_q );
+}
 
 void plotData( int16_t plot_data )
 {
     static uint32_t plot_x = 0;
-    char plot_string[ 50 ];
+    char plot_string[ 20 ];
     
     IntToStr( plot_data, plot_string );
-    mikrobus_logWrite( plot_string, _LOG_TEXT );
-    mikrobus_logWrite( ",", _LOG_TEXT );
-    LongWordToStr( plot_x, plot_string );
-    mikrobus_logWrite( plot_string, _LOG_LINE );
+    plot_string[ 6 ] = ',';
+    LongWordToStr( plot_x, &plot_string[ 7 ] );
+    ecg4_logq_line( &log_q, plot_string );
     
     if (plot_x == 0xFFFFFFFF)
     {
@@ -60,28 +93,62 @@ void plotData( int16_t plot_data )
     {
         plot_x++;
     }
+}
+
+void plotStage( void *ctx, int16_t *samples, uint16_t n_samples )
+{
+    int16_t plot_out[ 2 ];
+    uint8_t plot_cnt;
+    uint8_t plot_idx;
+    uint16_t cnt;
     
-    Delay_ms( 4 );
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        plot_cnt = ecg4_decim_push( &plot_decim, samples[ cnt ], plot_out );
+        
+        for (plot_idx = 0; plot_idx < plot_cnt; plot_idx++)
+        {
+            plotData( plot_out[ plot_idx ] );
+        }
+    }
 }
 
 void logData( uint8_t code_val, uint8_t data_val )
 {
     char log_string[ 20 ];
 
-    if (code_val == _ECG4_SIGNAL_QUALITY_CODE_BYTE)
+    if ((code_val == _ECG4_SIGNAL_QUALITY_CODE_BYTE) && (ecg4_logq_free( &log_q ) >= LOG_QUALITY_LEN))
     {
-        mikrobus_logWrite( "** Signal Quality (0 - sensor off, 200 - sensor on) : ", _LOG_TEXT );
+        ecg4_logq_text( &log_q, "** Signal Quality (0 - sensor off, 200 - sensor on) : " );
         ByteToStr( data_val, log_string );
-        mikrobus_logWrite( log_string, _LOG_TEXT );
-        mikrobus_logWrite( " **", _LOG_LINE );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " **" );
     }
-    else if (code_val == _ECG4_HEART_RATE_CODE_BYTE)
+    else if ((code_val == _ECG4_HEART_RATE_CODE_BYTE) && (ecg4_logq_free( &log_q ) >= LOG_HEART_RATE_LEN))
     {
-        mikrobus_logWrite( "** Real-time Heart Rate : ", _LOG_TEXT );
+        ecg4_logq_text( &log_q, "** Real-time Heart Rate : " );
         ByteToStr( data_val, log_string );
-        mikrobus_logWrite( log_string, _LOG_TEXT );
-        mikrobus_logWrite( " BPM **", _LOG_LINE );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " BPM **" );
+    }
+}
+
+void logDuty()
+{
+    char log_string[ 20 ];
+
+    ecg4_duty_get( &duty );
+
+    if ((duty.total_ms < LOG_DUTY_MS) || (ecg4_logq_free( &log_q ) < LOG_DUTY_LEN))
+    {
+        return;
     }
+
+    ecg4_logq_text( &log_q, "** CPU idle : " );
+    WordToStr( (uint16_t)(duty.idle_ms * 100 / duty.total_ms), log_string );
+    ecg4_logq_text( &log_q, log_string );
+    ecg4_logq_line( &log_q, " % **" );
+    ecg4_duty_clear();
 }
 
 void makeResponse( uint8_t *opCode, uint8_t *rowSize, uint8_t *rxBuff, uint8_t *rowCnt )
@@ -122,7 +189,11 @@ void processResponse()
             raw_data <<= 8;
             raw_data |= response[ idx_cnt + 3 ];
             
-            plotData( raw_data );
+            ecg4_pipe_process( &pipe, &raw_data, 1 );
+        }
+        else if (response[ idx_cnt ] == _ECG4_SIGNAL_QUALITY_CODE_BYTE)
+        {
+            ecg4_pipe_quality( &pipe, response[ idx_cnt + 2 ] );
         }
         
         /*if ((response[ idx_cnt ] == _ECG4_SIGNAL_QUALITY_CODE_BYTE) || (response[ idx_cnt ] == _ECG4_HEART_RATE_CODE_BYTE))
@@ -134,6 +205,43 @@ void processResponse()
     }
 }
 
+void timerInit()
+{
+    // 120 MHz / (119999 + 1) = 1 kHz, 32-bit periodic mode
+    SYSCTL_RCGCTIMER |= 1;
+    TIMER0_CTL = 0;
+    TIMER0_CFG = 0;
+    TIMER0_TAMR = 2;
+    TIMER0_TAILR = 119999;
+    TIMER0_IMR = 1;
+    NVIC_IntEnable( IVT_INT_TIMER0A );
+    TIMER0_CTL = 1;
+}
+
+void waitReady()
+{
+    char log_string[ 20 ];
+    uint8_t reset_state;
+
+    do
+    {
+        reset_state = ecg4_reset_poll();
+    }
+    while (reset_state == _ECG4_RESET_IN_PROGRESS);
+
+    if (reset_state == _ECG4_RESET_READY)
+    {
+        ecg4_logq_text( &log_q, "** ECG 4 is ready after " );
+        WordToStr( ecg4_reset_ready_time(), log_string );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " ms **" );
+    }
+    else
+    {
+        ecg4_logq_line( &log_q, "** ECG 4 does not respond **" );
+    }
+}
+
 void systemInit()
 {
     mikrobus_gpioInit( _MIKROBUS1, _MIKROBUS_RST_PIN, _GPIO_OUTPUT );
@@ -151,29 +259,30 @@ void applicationInit()
 {
     ecg4_uartDriverInit( (T_ECG4_P)&_MIKROBUS1_GPIO, (T_ECG4_P)&_MIKROBUS1_UART );
     ecg4_response_handler_set( &makeResponse );
-    Delay_ms( 300 );
+    ecg4_reset_start( RESET_TIMEOUT_MS );
     
-    ecg4_reset();
-    ecg4_enable_LDO_ctrl( _ECG4_ENABLE_LDO_CTRL );
-    Delay_ms( 200 );
-
-    RC1IE_bit  = 1;
-    RC1IF_bit  = 0;
-    PEIE_bit   = 1;
-    GIE_bit    = 1;
+    ecg4_logq_init( &log_q, &logWrite );
+    ecg4_decim_init( &plot_decim, 57600, 512, 256, 4 );
+    ecg4_decim_queue( &plot_decim, &logQueue );
+    ecg4_pipe_init( &pipe, 512 );
+    ecg4_pipe_register( &pipe, &plotStage, 0, 0, 0 );
+
+    RXIM_UART2_IM_bit = 1;
+    NVIC_IntEnable( IVT_INT_UART2 );
+    timerInit();
+    EnableInterrupts();
     
-    mikrobus_logWrite( "** ECG 4 is initialized **", _LOG_LINE );
-    mikrobus_logWrite( "", _LOG_LINE );
+    waitReady();
+    ecg4_logq_line( &log_q, "** ECG 4 is initialized **" );
+    ecg4_logq_line( &log_q, "" );
 }
 
 void applicationTask()
 {
-    resp_ready = ecg4_responseReady();
-    
-    if (resp_ready == _ECG4_RESPONSE_READY)
-    {
-        processResponse();
-    }
+    ecg4_wait_for_data();
+    processResponse();
+    logDuty();
+    ecg4_logq_drain( &log_q, LOG_TX_BUDGET );
 }
 
 void main()
@@ -187,10 +296,16 @@ void main()
     }
 }
 
-void interrupt()
+void RX_ISR() iv IVT_INT_UART2 ics ICS_AUTO
 {
-    if (RC1IF_bit == RX_UART_READY)
+    if (RXMIS_UART2_MIS_bit == RX_UART_READY)
     {
         ecg4_uart_isr();
     }
 }
+
+void Timer_ISR() iv IVT_INT_TIMER0A ics ICS_AUTO
+{
+    TIMER0_ICR = 1;
+    ecg4_tick();
+}
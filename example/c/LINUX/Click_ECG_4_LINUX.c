@@ -0,0 +1,487 @@
+/*
+Example for ECG_4 Click
+
+    Date          : Dec 2018.
+    Author        : Nemanja Medakovic
+
+Test configuration LINUX :
+    
+    Host             : Linux (x86-64, ARM)
+    Compiler         : gcc or clang
+    UART             : capture file, pipe or pty given by ECG4_UART (default - stdin)
+
+Build, from this folder :
+
+    gcc -O2 -I. -I../../../library -I../../../library/HAL -I../../../host -o Click_ECG_4_LINUX \
+        Click_ECG_4_LINUX.c ../../../library/__ecg4_driver.c ../../../library/__ecg4_parser.c \
+        ../../../library/__ecg4_decim.c ../../../library/__ecg4_logq.c ../../../library/__ecg4_qrs.c \
+        ../../../library/__ecg4_hr.c ../../../library/__ecg4_leadoff.c ../../../library/__ecg4_pipeline.c \
+        ../../../library/__ecg4_filter.c ../../../library/__ecg4_capture.c ../../../library/__ecg4_warm.c \
+        ../../../library/__ecg4_crc.c ../../../host/mikrosdk_linux.c
+
+Run against a capture of the BMD101 stream, or a serial adapter :
+
+    ECG4_UART=capture.bin ./Click_ECG_4_LINUX > log.txt
+    ECG4_UART=/dev/ttyUSB0 ECG4_DELAY=1 ./Click_ECG_4_LINUX
+
+---
+
+Description :
+
+The application is composed of three sections :
+
+- System Initialization - Initializes peripherals and pins.
+- Application Initialization - Initializes UART interface, performs a reset of the device and powers up control of
+  Low Drop Out (LDO).
+- Application Task - (code snippet) - Puts the core in the idle mode until response is ready, processes a response
+  streams a part of the lead-off capture and writes a part of the log queue.
+Note : The Sound library is used to play sound on buzzer every time when the QRS detector finds a beat (R peak)
+on the ECG signal, while the leads are on.
+The Sound Play command can make a delay time which is necessary for play command to be performed.
+If you don't need to make sound on buzzer, please disable the Sound Init and Sound Play functions.
+
+Additional Functions :
+
+- interrupt - Called by the mikroSDK stubs for every byte received from the UART file while the core is in the idle mode,
+  reads one byte data from uart and makes a response sequence.
+- logWrite - Writes a text of the log queue to the log link. The application task writes at most 6 bytes of the queue
+  (1 ms at 57600 baud) after every response, so the blocking write ends before the next response (1.95 ms).
+- logQueue - Returns the log queue occupancy, which sets the decimation level of the plot.
+- plotData - Queues a desired data (Raw Data) for the serial plotter. Raw Data is decimated to fit what the log queue
+  writes, keeping the minimum and maximum of every decimation window, so the QRS peaks stay visible.
+- logData - Queues data for the uart terminal and shows results.
+- logLeadoff - Shows the lead-off state detected from Raw Data, within tens of milliseconds.
+- captureStream - Streams the frozen capture window to the log queue in the background, one sample per response
+  while the queue has room, between a line with the window position and a line with the samples the history
+  could not keep meanwhile.
+- makeResponse - Pars a response to the buffer.
+- filterStage - Pipeline stage which removes the baseline wander and the 50 Hz mains interference from Raw Data
+  in place, so the next stages get the filtered data.
+- plotStage - Pipeline stage which decimates the filtered data and plots it, only while the sensor is on and settled.
+- beatStage - Pipeline stage which passes Raw Data to the QRS detector and the detected beats to the beat-to-beat heart rate,
+  also while the pipeline settles after the sensor is back on, when the QRS detector is warm started.
+- beatReset - Warm starts the QRS detector from the EEPROM when the sensor is back on, or cold starts it when
+  no valid snapshot is stored.
+- nvmRead, nvmWrite - EEPROM hooks (T_ecg4_nvm) of the warm start snapshot. The write only copies the snapshot to
+  a RAM shadow, which the read returns from then on.
+- nvmFlush - Writes one changed byte of the shadow to the EEPROM at most every NVM_WRITE_MS, so the write of one
+  byte has finished in the background before the next one starts and the parser never waits for the EEPROM.
+- processResponse - Processes a parsed response and makes a decide where response will be showed. Raw Data is passed
+  to the event capture, to the lead-off detector and to the pipeline, which skips all stages while the sensor is off
+  (signal quality 0 or lead-off). The capture is triggered when the leads go off, so it keeps the Raw Data before
+  and after it. When the leads go off while the heart rate is confident, the state of the QRS detector and of the
+  heart rate is saved to the EEPROM, so a restart or the sensor back on skips the 2 s learning of the detector.
+
+*/
+
+#include "mikrosdk_linux.h"
+#include "__ecg4_driver.h"
+#include "Click_ECG_4_types.h"
+#include "Click_ECG_4_config.h"
+#include "__ecg4_decim.h"
+#include "__ecg4_logq.h"
+#include "__ecg4_pipeline.h"
+#include "__ecg4_filter.h"
+#include "__ecg4_qrs.h"
+#include "__ecg4_hr.h"
+#include "__ecg4_leadoff.h"
+#include "__ecg4_warm.h"
+#include "__ecg4_capture.h"
+
+const uint16_t LOG_TX_BUDGET = 6;
+const uint16_t LOG_QUALITY_LEN = 62;
+const uint16_t LOG_HEART_RATE_LEN = 38;
+const uint16_t NVM_WARM_ADDR = 0x0000;
+const uint32_t NVM_WRITE_MS = 20;
+const uint16_t LOG_CAPTURE_LEN = 64;
+
+uint8_t response[ 256 ];
+uint8_t row_counter;
+T_ecg4_decim plot_decim;
+T_ecg4_logq log_q;
+T_ecg4_pipeline pipe;
+T_ecg4_filter flt;
+T_ecg4_qrs qrs;
+T_ecg4_hr hr;
+T_ecg4_leadoff leadoff;
+T_ecg4_nvm nvm;
+uint8_t nvm_shadow[ ECG4_WARM_BLOB_LEN ];
+uint8_t nvm_shadowed;
+uint16_t nvm_flush_pos;
+uint32_t nvm_write_ms;
+T_ecg4_capture cap;
+uint16_t capture_pos;
+uint32_t plot_x;
+uint8_t row_size_cnt;
+
+void RX_ISR();
+
+void logWrite( char *text )
+{
+    mikrobus_logWrite( text, _LOG_TEXT );
+}
+
+uint8_t logQueue()
+{
+    return ecg4_logq_occupancy( &log_q );
+}
+
+void plotData( int16_t plot_data )
+{
+    char plot_string[ 20 ];
+    
+    IntToStr( plot_data, plot_string );
+    plot_string[ 6 ] = ',';
+    LongWordToStr( plot_x, &plot_string[ 7 ] );
+    ecg4_logq_line( &log_q, plot_string );
+    
+    if (plot_x == 0xFFFFFFFF)
+    {
+        plot_x = 0;
+    }
+    else
+    {
+        plot_x++;
+    }
+}
+
+void filterStage( void *ctx, int16_t *samples, uint16_t n_samples )
+{
+    (void)ctx;
+    ecg4_filter_block( &flt, samples, n_samples );
+}
+
+void filterReset( void *ctx )
+{
+    (void)ctx;
+    ecg4_filter_init( &flt, 7, _ECG4_FILTER_NOTCH_50HZ );
+}
+
+void plotStage( void *ctx, int16_t *samples, uint16_t n_samples )
+{
+    int16_t plot_out[ 2 ];
+    uint8_t plot_cnt;
+    uint8_t plot_idx;
+    uint16_t cnt;
+    
+    (void)ctx;
+    
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        plot_cnt = ecg4_decim_push( &plot_decim, samples[ cnt ], plot_out );
+        
+        for (plot_idx = 0; plot_idx < plot_cnt; plot_idx++)
+        {
+            plotData( plot_out[ plot_idx ] );
+        }
+    }
+}
+
+void beatStage( void *ctx, int16_t *samples, uint16_t n_samples )
+{
+    uint8_t beat;
+    uint16_t cnt;
+    
+    (void)ctx;
+    
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        beat = ecg4_qrs_process( &qrs, samples[ cnt ] );
+        ecg4_hr_update( &hr, &qrs, beat );
+        
+        if (beat && (ecg4_pipe_state( &pipe ) == _ECG4_PIPE_ON))
+        {
+            Sound_Play( 520, 25 );
+        }
+    }
+}
+
+uint8_t nvmRead( uint16_t addr, uint8_t *buf, uint16_t len )
+{
+    uint16_t cnt;
+    
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        if (nvm_shadowed && (addr + cnt >= NVM_WARM_ADDR) && (addr + cnt < NVM_WARM_ADDR + ECG4_WARM_BLOB_LEN))
+        {
+            buf[ cnt ] = nvm_shadow[ addr + cnt - NVM_WARM_ADDR ];
+        }
+        else
+        {
+            buf[ cnt ] = EEPROM_Read( addr + cnt );
+        }
+    }
+    
+    return 0;
+}
+
+uint8_t nvmWrite( uint16_t addr, const uint8_t *buf, uint16_t len )
+{
+    uint16_t cnt;
+    
+    if ((addr < NVM_WARM_ADDR) || (addr + len > NVM_WARM_ADDR + ECG4_WARM_BLOB_LEN))
+    {
+        return 1;
+    }
+    
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        nvm_shadow[ addr + cnt - NVM_WARM_ADDR ] = buf[ cnt ];
+    }
+    
+    nvm_shadowed = 1;
+    nvm_flush_pos = 0;
+    
+    return 0;
+}
+
+void nvmFlush()
+{
+    if ((ecg4_time_ms() - nvm_write_ms) < NVM_WRITE_MS)
+    {
+        return;
+    }
+    
+    while (nvm_flush_pos < ECG4_WARM_BLOB_LEN)
+    {
+        if (EEPROM_Read( NVM_WARM_ADDR + nvm_flush_pos ) != nvm_shadow[ nvm_flush_pos ])
+        {
+            EEPROM_Write( NVM_WARM_ADDR + nvm_flush_pos, nvm_shadow[ nvm_flush_pos ] );
+            nvm_write_ms = ecg4_time_ms();
+            nvm_flush_pos++;
+            
+            return;
+        }
+        
+        nvm_flush_pos++;
+    }
+}
+
+void beatReset( void *ctx )
+{
+    (void)ctx;
+    ecg4_warm_load( &nvm, &qrs, 0, 0 );
+}
+
+void logData( uint8_t code_val, uint8_t data_val )
+{
+    char log_string[ 20 ];
+
+    if ((code_val == _ECG4_SIGNAL_QUALITY_CODE_BYTE) && (ecg4_logq_free( &log_q ) >= LOG_QUALITY_LEN))
+    {
+        ecg4_logq_text( &log_q, "** Signal Quality (0 - sensor off, 200 - sensor on) : " );
+        ByteToStr( data_val, log_string );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " **" );
+    }
+    else if ((code_val == _ECG4_HEART_RATE_CODE_BYTE) && (ecg4_logq_free( &log_q ) >= LOG_HEART_RATE_LEN))
+    {
+        ecg4_logq_text( &log_q, "** Real-time Heart Rate : " );
+        ByteToStr( data_val, log_string );
+        ecg4_logq_text( &log_q, log_string );
+        ecg4_logq_line( &log_q, " BPM **" );
+    }
+}
+
+void logLeadoff()
+{
+    if (ecg4_leadoff_state( &leadoff ) == _ECG4_LEADS_OFF)
+    {
+        ecg4_logq_line( &log_q, "** Leads off **" );
+    }
+    else
+    {
+        ecg4_logq_line( &log_q, "** Leads on **" );
+    }
+}
+
+void captureStream()
+{
+    T_ecg4_capture_info info;
+    int16_t sample;
+    char log_string[ 20 ];
+    
+    if (ecg4_capture_info( &cap, &info ) && (ecg4_logq_free( &log_q ) >= LOG_CAPTURE_LEN))
+    {
+        if (capture_pos == 0)
+        {
+            ecg4_logq_text( &log_q, "** Lead-off capture from sample " );
+            LongWordToStr( info.first_n, log_string );
+            ecg4_logq_text( &log_q, log_string );
+            ecg4_logq_line( &log_q, " **" );
+        }
+        
+        ecg4_capture_read( &cap, &sample, 1 );
+        capture_pos++;
+        IntToStr( sample, log_string );
+        ecg4_logq_line( &log_q, log_string );
+        
+        if (capture_pos == info.len)
+        {
+            ecg4_logq_text( &log_q, "** Capture end, history gap of " );
+            LongWordToStr( info.missed, log_string );
+            ecg4_logq_text( &log_q, log_string );
+            ecg4_logq_line( &log_q, " samples **" );
+        }
+    }
+}
+
+void makeResponse( uint8_t *opCode, uint8_t *rowSize, uint8_t *rxBuff, uint8_t *rowCnt )
+{
+    uint8_t idx_cnt;
+    
+    if (*rowCnt == 0)
+    {
+        row_size_cnt = 0;
+    }
+    
+    response[ row_size_cnt ] = *opCode;
+    response[ row_size_cnt + 1 ] = *rowSize;
+
+    for (idx_cnt = 0; idx_cnt < *rowSize; idx_cnt++)
+    {
+        response[ row_size_cnt + 2 + idx_cnt ] = rxBuff[ idx_cnt ];
+    }
+    
+    row_size_cnt += (*rowSize + 2);
+    row_counter = *rowCnt;
+}
+
+void processResponse()
+{
+    uint8_t cnt;
+    uint8_t idx_cnt;
+    int16_t raw_data;
+    
+    idx_cnt = 0;
+    
+    for (cnt = 0; cnt <= row_counter; cnt++)
+    {
+        if (response[ idx_cnt ] == _ECG4_RAW_DATA_CODE_BYTE)
+        {
+            raw_data = response[ idx_cnt + 2 ];
+            raw_data <<= 8;
+            raw_data |= response[ idx_cnt + 3 ];
+            
+            if (ecg4_capture_push( &cap, raw_data ))
+            {
+                capture_pos = 0;
+            }
+            
+            if (ecg4_leadoff_process( &leadoff, raw_data ))
+            {
+                ecg4_pipe_leadoff( &pipe, ecg4_leadoff_state( &leadoff ) == _ECG4_LEADS_OFF );
+                logLeadoff();
+                
+                if ((ecg4_leadoff_state( &leadoff ) == _ECG4_LEADS_OFF) && ecg4_hr_confident( &hr ))
+                {
+                    ecg4_warm_save( &nvm, &qrs, &flt, &hr );
+                }
+                
+                if (ecg4_leadoff_state( &leadoff ) == _ECG4_LEADS_OFF)
+                {
+                    ecg4_capture_trigger( &cap, _ECG4_CAPTURE_LEADOFF );
+                }
+            }
+            
+            ecg4_pipe_process( &pipe, &raw_data, 1 );
+        }
+        else if (response[ idx_cnt ] == _ECG4_SIGNAL_QUALITY_CODE_BYTE)
+        {
+            ecg4_hr_quality( &hr, response[ idx_cnt + 2 ] );
+            ecg4_pipe_quality( &pipe, response[ idx_cnt + 2 ] );
+        }
+        else if (response[ idx_cnt ] == _ECG4_HEART_RATE_CODE_BYTE)
+        {
+            ecg4_hr_device( &hr, response[ idx_cnt + 2 ] );
+        }
+        
+        /*if ((response[ idx_cnt ] == _ECG4_SIGNAL_QUALITY_CODE_BYTE) || (response[ idx_cnt ] == _ECG4_HEART_RATE_CODE_BYTE))
+        {
+            logData( response[ idx_cnt ], response[ idx_cnt + 2 ] );
+        }*/
+        
+        idx_cnt += (response[ idx_cnt + 1 ] + 2);
+    }
+}
+
+void systemInit()
+{
+    mikrobus_gpioInit( _MIKROBUS1, _MIKROBUS_RST_PIN, _GPIO_OUTPUT );
+    mikrobus_gpioInit( _MIKROBUS1, _MIKROBUS_CS_PIN, _GPIO_OUTPUT );
+
+    mikrobus_uartInit( _MIKROBUS1, &_ECG4_UART_CFG[0] );
+
+    mikrobus_logInit( _LOG_USBUART_A, 57600 );
+    mikrobus_logWrite( "*** Initializing... ***", _LOG_LINE );
+
+    Delay_ms( 100 );
+}
+
+void applicationInit()
+{
+    ecg4_uartDriverInit( (T_ECG4_P)&_MIKROBUS1_GPIO, (T_ECG4_P)&_MIKROBUS1_UART );
+    ecg4_response_handler_set( &makeResponse );
+    Delay_ms( 300 );
+    
+    ecg4_reset();
+    ecg4_enable_LDO_ctrl( _ECG4_ENABLE_LDO_CTRL );
+    Sound_Init( 0, 0 );
+    Delay_ms( 200 );
+    
+    ecg4_logq_init( &log_q, &logWrite );
+    ecg4_decim_init( &plot_decim, 57600, 512, 256, 4 );
+    ecg4_decim_queue( &plot_decim, &logQueue );
+    ecg4_filter_init( &flt, 7, _ECG4_FILTER_NOTCH_50HZ );
+    ecg4_hr_init( &hr );
+    nvm.read = &nvmRead;
+    nvm.write = &nvmWrite;
+    nvm.addr = NVM_WARM_ADDR;
+    nvm_shadowed = 0;
+    nvm_flush_pos = ECG4_WARM_BLOB_LEN;
+    nvm_write_ms = 0;
+    
+    if (ecg4_warm_load( &nvm, &qrs, &flt, &hr ) == _ECG4_WARM_OK)
+    {
+        ecg4_logq_line( &log_q, "** QRS detector warm started from the EEPROM **" );
+    }
+    
+    ecg4_leadoff_init( &leadoff );
+    ecg4_capture_init( &cap );
+    ecg4_pipe_init( &pipe, 512 );
+    ecg4_pipe_register( &pipe, &filterStage, &filterReset, 0, _ECG4_PIPE_RUN_SETTLING );
+    ecg4_pipe_register( &pipe, &beatStage, &beatReset, 0, _ECG4_PIPE_RUN_SETTLING );
+    ecg4_pipe_register( &pipe, &plotStage, 0, 0, 0 );
+	
+	plot_x = 0;
+
+    mikrobus_uartInterrupt( _MIKROBUS1, &RX_ISR );
+    
+    ecg4_logq_line( &log_q, "** ECG 4 is initialized **" );
+    ecg4_logq_line( &log_q, "" );
+}
+
+void applicationTask()
+{
+    ecg4_wait_for_data();
+    processResponse();
+    captureStream();
+    nvmFlush();
+    ecg4_logq_drain( &log_q, LOG_TX_BUDGET );
+}
+
+int main()
+{
+    systemInit();
+    applicationInit();
+
+    while (1)
+    {
+        applicationTask();
+    }
+}
+
+void RX_ISR()
+{
+    ecg4_uart_isr();
+}
@@ -0,0 +1,9 @@
+#include "Click_ECG_4_types.h"
+
+const uint32_t _ECG4_UART_CFG [ 4 ] = 
+{
+	57600, 
+	_UART_8_BIT_DATA, 
+    _UART_NOPARITY, 
+    _UART_ONE_STOPBIT
+};
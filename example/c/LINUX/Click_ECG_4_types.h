@@ -0,0 +1,12 @@
+#ifndef _ECG4_T_
+#define _ECG4_T_
+
+#include "stdint.h"
+
+#ifndef _ECG4_H_
+
+#define T_ECG4_P const uint8_t* 
+#define T_ECG4_RETVAL  uint8_t
+
+#endif
+#endif
\ No newline at end of file
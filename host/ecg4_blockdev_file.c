@@ -0,0 +1,234 @@
+/*
+    ecg4_blockdev_file.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_blockdev_file.c
+@brief    ECG_4 File Backed Block Device
+*/
+
+#define _XOPEN_SOURCE 700
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ecg4_blockdev_file.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define BDF_PAGE_MAX            4096
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint8_t bdf_read( void *ctx, uint32_t page, uint16_t offset, uint8_t *buf, uint16_t len )
+{
+    T_ecg4_bdfile *bdf;
+    off_t pos;
+
+    bdf = ctx;
+
+    if (bdf->dead)
+    {
+        return 1;
+    }
+
+    pos = (off_t)page * bdf->page_size + offset;
+
+    if (pread( bdf->fd, buf, len, pos ) != len)
+    {
+        return 1;
+    }
+
+    bdf->reads++;
+    bdf->read_bytes += len;
+
+    return 0;
+}
+
+static uint8_t bdf_prog( void *ctx, uint32_t page, const uint8_t *buf )
+{
+    T_ecg4_bdfile *bdf;
+    uint8_t cell[ BDF_PAGE_MAX ];
+    off_t pos;
+    uint16_t len;
+    uint16_t cnt;
+
+    bdf = ctx;
+
+    if (bdf->dead)
+    {
+        return 1;
+    }
+
+    pos = (off_t)page * bdf->page_size;
+
+    if (pread( bdf->fd, cell, bdf->page_size, pos ) != bdf->page_size)
+    {
+        return 1;
+    }
+
+    len = bdf->page_size;
+    bdf->progs++;
+
+    if ((bdf->cut_after != 0) && (bdf->progs == bdf->cut_after))
+    {
+        len = bdf->cut_bytes;
+        bdf->dead = 1;
+    }
+
+    // NOR flash: programming only clears bits
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        cell[ cnt ] &= buf[ cnt ];
+    }
+
+    if (pwrite( bdf->fd, cell, bdf->page_size, pos ) != bdf->page_size)
+    {
+        return 1;
+    }
+
+    return bdf->dead;
+}
+
+static uint8_t bdf_erase( void *ctx, uint32_t block )
+{
+    T_ecg4_bdfile *bdf;
+    uint8_t cell[ BDF_PAGE_MAX ];
+    off_t pos;
+    uint16_t cnt;
+
+    bdf = ctx;
+
+    if (bdf->dead)
+    {
+        return 1;
+    }
+
+    memset( cell, 0xFF, bdf->page_size );
+    pos = (off_t)block * bdf->erase_pages * bdf->page_size;
+
+    for (cnt = 0; cnt < bdf->erase_pages; cnt++)
+    {
+        if (pwrite( bdf->fd, cell, bdf->page_size, pos + (off_t)cnt * bdf->page_size ) != bdf->page_size)
+        {
+            return 1;
+        }
+    }
+
+    bdf->erases++;
+
+    return 0;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int ecg4_bdfile_open( T_ecg4_bdfile *bdf, T_ecg4_blockdev *dev, const char *path,
+                      uint16_t page_size, uint16_t erase_pages, uint32_t n_pages )
+{
+    uint8_t cell[ BDF_PAGE_MAX ];
+    struct stat st;
+    off_t size;
+    off_t pos;
+
+    if ((page_size == 0) || (page_size > BDF_PAGE_MAX))
+    {
+        return -1;
+    }
+
+    memset( bdf, 0, sizeof( *bdf ) );
+    bdf->page_size = page_size;
+    bdf->erase_pages = erase_pages;
+    bdf->fd = open( path, O_RDWR | O_CREAT, 0644 );
+
+    if (bdf->fd < 0)
+    {
+        return -1;
+    }
+
+    size = (off_t)page_size * n_pages;
+
+    if (fstat( bdf->fd, &st ) != 0)
+    {
+        close( bdf->fd );
+        return -1;
+    }
+
+    memset( cell, 0xFF, page_size );
+
+    for (pos = st.st_size - st.st_size % page_size; pos < size; pos += page_size)
+    {
+        if (pwrite( bdf->fd, cell, page_size, pos ) != page_size)
+        {
+            close( bdf->fd );
+            return -1;
+        }
+    }
+
+    dev->ctx = bdf;
+    dev->page_size = page_size;
+    dev->erase_pages = erase_pages;
+    dev->n_pages = n_pages;
+    dev->read = bdf_read;
+    dev->prog = bdf_prog;
+    dev->erase = bdf_erase;
+
+    return 0;
+}
+
+void ecg4_bdfile_close( T_ecg4_bdfile *bdf )
+{
+    if (bdf->fd >= 0)
+    {
+        close( bdf->fd );
+        bdf->fd = -1;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_blockdev_file.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
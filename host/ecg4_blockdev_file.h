@@ -0,0 +1,107 @@
+/*
+    ecg4_blockdev_file.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_blockdev_file.h
+@brief    ECG_4 File Backed Block Device
+
+File backed __ecg4_recorder block device for Linux. Programming follows NOR flash rules (bits can only be
+cleared, erase sets a block to 0xFF), and a power cut can be injected after a given number of programmed
+pages, leaving the page being programmed partly written.
+*/
+
+#include <stdint.h>
+#include "__ecg4_recorder.h"
+
+#ifndef _ECG4_BLOCKDEV_FILE_H_
+#define _ECG4_BLOCKDEV_FILE_H_
+
+/**
+ * @struct T_ecg4_bdfile
+ * @brief File backed block device
+ */
+typedef struct
+{
+    int      fd;
+    uint16_t page_size;
+    uint16_t erase_pages;
+    uint32_t cut_after;         /**< Power cut at this programmed page, 0 - never */
+    uint16_t cut_bytes;         /**< Bytes of the page programmed when the power is cut */
+    uint8_t  dead;              /**< Power cut happened, every access fails */
+    uint64_t reads;
+    uint64_t read_bytes;
+    uint64_t progs;
+    uint64_t erases;
+
+}T_ecg4_bdfile;
+
+/**
+ * @brief File Block Device Open function
+ *
+ * @param[out] bdf          File backed block device
+ * @param[out] dev          Block device HAL for ecg4_rec_init
+ * @param[in]  path         Image file, created erased when missing or smaller than the device
+ * @param[in]  page_size    Page size in bytes
+ * @param[in]  erase_pages  Pages in an erase block
+ * @param[in]  n_pages      Number of pages
+ *
+ * @returns 0 - success, -1 - error (errno is set)
+ */
+int ecg4_bdfile_open( T_ecg4_bdfile *bdf, T_ecg4_blockdev *dev, const char *path,
+                      uint16_t page_size, uint16_t erase_pages, uint32_t n_pages );
+
+/**
+ * @brief File Block Device Close function
+ */
+void ecg4_bdfile_close( T_ecg4_bdfile *bdf );
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_blockdev_file.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
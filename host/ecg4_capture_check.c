@@ -0,0 +1,528 @@
+/*
+    ecg4_capture_check.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_capture_check.c
+@brief    ECG_4 Event Capture Check
+
+Drives __ecg4_capture with samples whose value tells their index, so every sample read from a frozen window can
+be compared with the sample it must be:
+
+| Scene    | Checks                                                                                      |
+|:--------:|:--------------------------------------------------------------------------------------------|
+| wrap     | trigger after the history wrapped three times, the window read in chunks across the ring    |
+|          | end, a trigger with a history shorter than ECG4_CAPTURE_PRE                                 |
+| freeze   | push and trigger results, the state, a background read keeping up with the pushes, the      |
+|          | window and the samples pushed while frozen as the pre-trigger samples of the next trigger   |
+| missed   | pushes into a full ring before the first read, pushes beyond the slots already read, the    |
+|          | missed count and the pre-trigger samples restarting after the gap                           |
+| soak     | random triggers, reader speeds and chunk sizes, rejected triggers and releases; the window  |
+|          | contents and, after every trigger, the pre-trigger length against the samples kept          |
+
+Exits with 1 on the first mismatch, or when the soak did not run both lossy and lossless windows.
+Build it once with the default sizes and once with the PIC and AVR sizes:
+
+    gcc -O2 -I../library -o ecg4_capture_check ecg4_capture_check.c ../library/__ecg4_capture.c
+    gcc -O2 -I../library -DECG4_CAPTURE_RAM_MAX=1024 -o ecg4_capture_check_s ecg4_capture_check.c \
+        ../library/__ecg4_capture.c
+
+    ecg4_capture_check [-n samples] [-s seed] [-c max_chunk]
+
+Defaults: 4000000 samples in the soak, seed 1, chunks of up to 64 samples.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "__ecg4_capture.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#if ECG4_CAPTURE_POST < 1 || ECG4_CAPTURE_LEN < 256
+#error "the scenes need at least one post-trigger sample and a 256 sample ring"
+#endif
+
+#define CHECK_TRIGGER_ODDS      1024        // one trigger in 1024 samples while armed
+#define CHECK_RELEASE_ODDS      256         // one read in 256 is a release instead
+
+#define CHECK_EQ( what, got, want ) \
+    do { if (check_eq( what, (uint32_t)(got), (uint32_t)(want) )) return 1; } while (0)
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    uint32_t windows;
+    uint32_t lossy;
+    uint32_t released;
+    uint32_t rejected;
+    uint32_t missed;
+
+}T_check_stats;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static uint32_t check_rng;
+static const char *check_scene;
+static T_ecg4_capture cap;
+static int16_t check_chunk[ ECG4_CAPTURE_LEN ];
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint32_t check_rand( void )
+{
+    check_rng ^= check_rng << 13;
+    check_rng ^= check_rng >> 17;
+    check_rng ^= check_rng << 5;
+
+    return check_rng;
+}
+
+// value of the sample with index n, the 16 low bits of n scrambled one to one
+static int16_t check_value( uint32_t n )
+{
+    return (int16_t)(uint16_t)(n * 40503u);
+}
+
+static uint16_t check_min( uint32_t a, uint32_t b )
+{
+    return (uint16_t)((a < b) ? a : b);
+}
+
+static int check_eq( const char *what, uint32_t got, uint32_t want )
+{
+    if (got != want)
+    {
+        printf( "%s: %s is %u, expected %u\n", check_scene, what, got, want );
+        return 1;
+    }
+
+    return 0;
+}
+
+// pushes the samples *n .. *n + count - 1, none of them may freeze a window
+static int check_push( uint32_t *n, uint32_t count )
+{
+    while (count--)
+    {
+        CHECK_EQ( "push result", ecg4_capture_push( &cap, check_value( *n ) ), 0 );
+        (*n)++;
+    }
+
+    return 0;
+}
+
+// triggers at sample *n and pushes the post-trigger samples, the window must hold pre_len samples before *n
+static int check_freeze( uint32_t *n, uint8_t reason, uint16_t pre_len, T_ecg4_capture_info *info )
+{
+    uint32_t trigger_n;
+
+    trigger_n = *n;
+    CHECK_EQ( "trigger result", ecg4_capture_trigger( &cap, reason ), 1 );
+    CHECK_EQ( "state", ecg4_capture_state( &cap ), _ECG4_CAPTURE_POST_TRIGGER );
+    CHECK_EQ( "second trigger result", ecg4_capture_trigger( &cap, reason ), 0 );
+    CHECK_EQ( "info result before the freeze", ecg4_capture_info( &cap, info ), 0 );
+
+    if (check_push( n, ECG4_CAPTURE_POST - 1 ))
+    {
+        return 1;
+    }
+
+    CHECK_EQ( "freezing push result", ecg4_capture_push( &cap, check_value( *n ) ), 1 );
+    (*n)++;
+    CHECK_EQ( "state", ecg4_capture_state( &cap ), _ECG4_CAPTURE_FROZEN );
+    CHECK_EQ( "info result", ecg4_capture_info( &cap, info ), 1 );
+    CHECK_EQ( "reason", info->reason, reason );
+    CHECK_EQ( "trigger_n", info->trigger_n, trigger_n );
+    CHECK_EQ( "first_n", info->first_n, trigger_n - pre_len );
+    CHECK_EQ( "window length", info->len, pre_len + ECG4_CAPTURE_POST );
+    CHECK_EQ( "missed", info->missed, 0 );
+
+    return 0;
+}
+
+// reads a chunk of up to max_samples and compares it with the window samples from *pos on
+static int check_read( const T_ecg4_capture_info *info, uint16_t max_samples, uint32_t *pos )
+{
+    uint16_t n_read;
+    uint16_t cnt;
+
+    n_read = ecg4_capture_read( &cap, check_chunk, max_samples );
+    CHECK_EQ( "read length", n_read, check_min( max_samples, info->len - *pos ) );
+
+    for (cnt = 0; cnt < n_read; cnt++)
+    {
+        if (check_chunk[ cnt ] != check_value( info->first_n + *pos + cnt ))
+        {
+            printf( "%s: window sample %u is %d, expected %d (sample %u)\n", check_scene, *pos + cnt,
+                    check_chunk[ cnt ], check_value( info->first_n + *pos + cnt ), info->first_n + *pos + cnt );
+            return 1;
+        }
+    }
+
+    *pos += n_read;
+
+    return 0;
+}
+
+static int check_read_all( const T_ecg4_capture_info *info, uint16_t chunk )
+{
+    uint32_t pos;
+
+    pos = 0;
+
+    while (pos < info->len)
+    {
+        if (check_read( info, chunk, &pos ))
+        {
+            return 1;
+        }
+    }
+
+    CHECK_EQ( "state after the read out", ecg4_capture_state( &cap ), _ECG4_CAPTURE_ARMED );
+    CHECK_EQ( "read after the read out", ecg4_capture_read( &cap, check_chunk, 1 ), 0 );
+
+    return 0;
+}
+
+static int check_wrap( void )
+{
+    T_ecg4_capture_info info;
+    uint32_t n;
+
+    check_scene = "wrap";
+    ecg4_capture_init( &cap );
+    n = 0;
+    CHECK_EQ( "state", ecg4_capture_state( &cap ), _ECG4_CAPTURE_ARMED );
+
+    // odd count, so the window and the 37 sample chunks straddle the end of the ring
+    if (check_push( &n, 3 * ECG4_CAPTURE_LEN + 17 ) ||
+        check_freeze( &n, _ECG4_CAPTURE_MANUAL, ECG4_CAPTURE_PRE, &info ) || check_read_all( &info, 37 ))
+    {
+        return 1;
+    }
+
+    check_scene = "short history";
+    ecg4_capture_init( &cap );
+    n = 0;
+
+    if (check_push( &n, 10 ) || check_freeze( &n, _ECG4_CAPTURE_MANUAL, 10, &info ) ||
+        check_read_all( &info, ECG4_CAPTURE_LEN ))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int check_freeze_scene( void )
+{
+    T_ecg4_capture_info info;
+    uint32_t n;
+    uint32_t pos;
+
+    check_scene = "freeze";
+    ecg4_capture_init( &cap );
+    n = 0;
+
+    if (check_push( &n, ECG4_CAPTURE_LEN ) || check_freeze( &n, _ECG4_CAPTURE_QUALITY, ECG4_CAPTURE_PRE, &info ))
+    {
+        return 1;
+    }
+
+    // background read out, a chunk read before the pushes it makes room for, nothing may be missed
+    pos = 0;
+
+    while (pos < info.len)
+    {
+        if (check_read( &info, 5, &pos ))
+        {
+            return 1;
+        }
+
+        if (pos < info.len)
+        {
+            if (check_push( &n, 5 ) || check_eq( "info result", ecg4_capture_info( &cap, &info ), 1 ) ||
+                check_eq( "missed", info.missed, 0 ))
+            {
+                return 1;
+            }
+        }
+    }
+
+    CHECK_EQ( "state after the read out", ecg4_capture_state( &cap ), _ECG4_CAPTURE_ARMED );
+
+    // the samples pushed while frozen are the pre-trigger samples of the next trigger
+    if (check_freeze( &n, _ECG4_CAPTURE_ARRHYTHMIA, ECG4_CAPTURE_PRE, &info ) || check_read_all( &info, 64 ))
+    {
+        return 1;
+    }
+
+    // and so is the window itself, read in one go, with only 3 samples pushed since
+    if (check_push( &n, 3 ) || check_freeze( &n, _ECG4_CAPTURE_MANUAL, ECG4_CAPTURE_PRE, &info ))
+    {
+        return 1;
+    }
+
+    return check_read_all( &info, ECG4_CAPTURE_LEN );
+}
+
+static int check_missed( void )
+{
+    T_ecg4_capture_info info;
+    uint32_t n;
+    uint32_t pos;
+
+    check_scene = "missed";
+    ecg4_capture_init( &cap );
+    n = 0;
+
+    // the window takes the whole ring, so nothing pushed before the first read is kept
+    if (check_push( &n, ECG4_CAPTURE_LEN ) || check_freeze( &n, _ECG4_CAPTURE_LEADOFF, ECG4_CAPTURE_PRE, &info ) ||
+        check_push( &n, 100 ))
+    {
+        return 1;
+    }
+
+    CHECK_EQ( "info result", ecg4_capture_info( &cap, &info ), 1 );
+    CHECK_EQ( "missed before the first read", info.missed, 100 );
+
+    // 100 samples fit in the slots read, the 101st finds none: those 100 are dropped and the history restarts
+    pos = 0;
+
+    if (check_read( &info, 100, &pos ) || check_push( &n, 150 ))
+    {
+        return 1;
+    }
+
+    CHECK_EQ( "info result", ecg4_capture_info( &cap, &info ), 1 );
+    CHECK_EQ( "missed after the gap", info.missed, 200 );
+
+    while (pos < info.len)
+    {
+        if (check_read( &info, 64, &pos ))
+        {
+            return 1;
+        }
+    }
+
+    CHECK_EQ( "state after the read out", ecg4_capture_state( &cap ), _ECG4_CAPTURE_ARMED );
+
+    // only the 50 samples since the gap precede the next trigger
+    if (check_freeze( &n, _ECG4_CAPTURE_LEADOFF, 50, &info ) || check_read_all( &info, 64 ))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int check_soak( uint32_t n_samples, uint16_t max_chunk, T_check_stats *stats )
+{
+    T_ecg4_capture_info info;
+    T_ecg4_capture_info now;
+    uint32_t n;
+    uint32_t pos;
+    uint32_t trigger_n;
+    uint32_t hist_lo;
+    uint32_t hist_hi;
+    uint32_t missed;
+    uint16_t pre_lo;
+    uint16_t pre_hi;
+    uint8_t state;
+    uint8_t read_pct;
+    uint8_t frozen;
+
+    check_scene = "soak";
+    ecg4_capture_init( &cap );
+
+    // the history holds the samples from hist_lo or hist_hi on, a gap leaves it unsaid which
+    hist_lo = 0;
+    hist_hi = 0;
+    trigger_n = 0;
+    pre_lo = 0;
+    pre_hi = 0;
+    pos = 0;
+    missed = 0;
+    read_pct = 0;
+    info.len = 0;
+
+    for (n = 0; n < n_samples; n++)
+    {
+        state = ecg4_capture_state( &cap );
+
+        if ((state == _ECG4_CAPTURE_ARMED) && (check_rand() % CHECK_TRIGGER_ODDS == 0))
+        {
+            CHECK_EQ( "trigger result", ecg4_capture_trigger( &cap, 1 + check_rand() % 4 ), 1 );
+            trigger_n = n;
+            pre_lo = check_min( ECG4_CAPTURE_PRE, n - hist_hi );
+            pre_hi = check_min( ECG4_CAPTURE_PRE, n - hist_lo );
+            state = _ECG4_CAPTURE_POST_TRIGGER;
+        }
+        else if ((state != _ECG4_CAPTURE_ARMED) && (check_rand() % 64 == 0))
+        {
+            CHECK_EQ( "trigger result while busy", ecg4_capture_trigger( &cap, _ECG4_CAPTURE_MANUAL ), 0 );
+            stats->rejected++;
+        }
+
+        if ((state == _ECG4_CAPTURE_FROZEN) && (check_rand() % 100 < read_pct))
+        {
+            if (check_rand() % CHECK_RELEASE_ODDS == 0)
+            {
+                ecg4_capture_release( &cap );
+                stats->released++;
+            }
+            else if (check_read( &info, 1 + check_rand() % max_chunk, &pos ))
+            {
+                return 1;
+            }
+
+            if (ecg4_capture_state( &cap ) == _ECG4_CAPTURE_ARMED)
+            {
+                stats->lossy += (missed != 0);
+                stats->missed += missed;
+            }
+        }
+
+        frozen = ecg4_capture_push( &cap, check_value( n ) );
+        CHECK_EQ( "push result", frozen, (state == _ECG4_CAPTURE_POST_TRIGGER) &&
+                                         (n == trigger_n + ECG4_CAPTURE_POST - 1) );
+
+        if (frozen)
+        {
+            CHECK_EQ( "info result", ecg4_capture_info( &cap, &info ), 1 );
+            CHECK_EQ( "trigger_n", info.trigger_n, trigger_n );
+            CHECK_EQ( "window length", info.len, info.trigger_n - info.first_n + ECG4_CAPTURE_POST );
+            CHECK_EQ( "missed", info.missed, 0 );
+
+            if ((info.len - ECG4_CAPTURE_POST < pre_lo) || (info.len - ECG4_CAPTURE_POST > pre_hi))
+            {
+                printf( "%s: %u pre-trigger samples at sample %u, expected %u - %u\n", check_scene,
+                        info.len - ECG4_CAPTURE_POST, trigger_n, pre_lo, pre_hi );
+                return 1;
+            }
+
+            // a new reader speed for every window, from well behind to well ahead of the pushes
+            read_pct = 1 + check_rand() % 10;
+            pos = 0;
+            missed = 0;
+            stats->windows++;
+        }
+        else if (ecg4_capture_info( &cap, &now ) && (now.missed != missed))
+        {
+            // a gap: the history restarts at this sample, or after it when the sample was dropped too
+            CHECK_EQ( "missed growing", now.missed > missed, 1 );
+            missed = now.missed;
+            hist_lo = n;
+            hist_hi = n + 1;
+        }
+    }
+
+    return 0;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    T_check_stats stats = { 0, 0, 0, 0, 0 };
+    uint32_t n_samples;
+    uint16_t max_chunk;
+    int opt;
+
+    n_samples = 4000000;
+    check_rng = 1;
+    max_chunk = 64;
+
+    while ((opt = getopt( argc, argv, "n:s:c:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': n_samples = atoi( optarg ); break;
+            case 's': check_rng = atoi( optarg ); break;
+            case 'c': max_chunk = atoi( optarg ); break;
+            default:
+                fprintf( stderr, "usage: %s [-n samples] [-s seed] [-c max_chunk]\n", argv[ 0 ] );
+                return 2;
+        }
+    }
+
+    if (check_rng == 0)
+    {
+        check_rng = 1;
+    }
+
+    if ((max_chunk == 0) || (max_chunk > ECG4_CAPTURE_LEN))
+    {
+        max_chunk = ECG4_CAPTURE_LEN;
+    }
+
+    if (check_wrap() || check_freeze_scene() || check_missed() || check_soak( n_samples, max_chunk, &stats ))
+    {
+        return 1;
+    }
+
+    printf( "window    : %u pre-trigger, %u post-trigger samples\n", ECG4_CAPTURE_PRE, ECG4_CAPTURE_POST );
+    printf( "scenes    : wrap, short history, freeze, missed passed\n" );
+    printf( "soak      : %u samples, %u windows, %u lossy, %u released, %u triggers rejected, %u samples missed\n",
+            n_samples, stats.windows, stats.lossy, stats.released, stats.rejected, stats.missed );
+
+    if ((stats.lossy == 0) || (stats.lossy == stats.windows))
+    {
+        printf( "soak did not run both lossy and lossless windows, use more samples or another seed\n" );
+        return 1;
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_capture_check.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,774 @@
+/*
+    ecg4_dsp_bench.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_dsp_bench.c
+@brief    ECG_4 DSP Kernel Benchmark
+
+Runs the signal processing kernels used on the 512 Hz raw data in several variants over the same synthetic
+ECG (ecg4_synth, with noise, baseline wander and 50 Hz mains), to pick a variant per target:
+
+| Kernel     | Operation                                                                  |
+|:----------:|:---------------------------------------------------------------------------|
+| biquad     | 40 Hz Butterworth low-pass, direct form I                                  |
+| fir        | 31 taps Hamming windowed-sinc low-pass, 40 Hz                              |
+| mwi        | 64 samples (125 ms) moving window integrator, running sum                  |
+| derivative | (2x(n) + x(n-1) - x(n-3) - 2x(n-4)) / 8, as in __ecg4_qrs                  |
+| notch      | 50 Hz IIR notch, pole radius 0.97, as in __ecg4_filter                     |
+
+| Variant | Implementation                                                                       |
+|:-------:|:-------------------------------------------------------------------------------------|
+| double  | reference, not timed, the error of the variants is measured against it               |
+| float   | scalar single precision, for MCUs with an FPU (Cortex-M4F, PIC32MZ EF) and gateways  |
+| q15     | 16 bit samples, 32 bit accumulators, Q15 coefficients (Q14 for the recursive ones),  |
+|         | for all MCUs; the notch is ecg4_filter_block of the library                          |
+| simd    | SSE2, built when the compiler targets it, for the non-recursive kernels              |
+
+The recursive kernels (biquad, notch) have no SIMD variant: their samples depend on the previous outputs, so a
+single channel does not vectorise.
+
+For every kernel and variant the best of -r runs over -n samples is reported: the throughput, the cycles per
+sample (time stamp counter on x86, the elapsed time times -g GHz elsewhere or when -g is given) and the max
+and rms error against the double reference, in LSB of the raw data.
+
+    gcc -O2 -I../library -I. -o ecg4_dsp_bench ecg4_dsp_bench.c ecg4_synth.c ecg4_frame.c \
+        ../library/__ecg4_filter.c -lm
+
+    ecg4_dsp_bench [-n samples] [-r repeats] [-g ghz] [-s seed]
+
+Defaults: 1048576 samples, best of 5 runs, time stamp counter on x86.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "__ecg4_filter.h"
+#include "ecg4_synth.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#define DSP_TSC                 1
+#endif
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define DSP_FS                  512
+#define DSP_PI                  3.14159265358979323846
+#define DSP_PAD                 64
+#define DSP_FIR_TAPS            31
+#define DSP_MWI_LEN             64
+#define DSP_CUTOFF              40.0
+#define DSP_MAINS               50.0
+#define DSP_NOTCH_R             0.97
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    const char  *kernel;
+    const char  *variant;
+    void        ( *run )( uint32_t n );
+    void        ( *ref )( uint32_t n );
+    uint8_t     out_float;
+
+}T_dsp_case;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static int16_t *xi;                 /**< Input samples, DSP_PAD zeros before xi[ 0 ] */
+static float   *xf;
+static int16_t *yi;
+static float   *yf;
+static double  *ref;
+
+static double  bq_b[ 3 ];
+static double  bq_a[ 3 ];
+static float   bq_bf[ 3 ];
+static float   bq_af[ 3 ];
+static int16_t bq_bq[ 3 ];          /**< Q14 */
+static int16_t bq_aq[ 3 ];
+
+static double  fir_h[ DSP_FIR_TAPS ];
+static float   fir_hf[ DSP_FIR_TAPS ];
+static int16_t fir_hq[ DSP_FIR_TAPS ];  /**< Q15 */
+
+static double  notch_b[ 3 ];
+static double  notch_a[ 3 ];
+static float   notch_bf[ 3 ];
+static float   notch_af[ 3 ];
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void dsp_usage( void )
+{
+    fprintf( stderr, "usage: ecg4_dsp_bench [-n samples] [-r repeats] [-g ghz] [-s seed]\n" );
+    exit( 2 );
+}
+
+static double dsp_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t dsp_cycles( void )
+{
+#ifdef DSP_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int16_t dsp_sat( int32_t y )
+{
+    if (y > 32767)
+    {
+        return 32767;
+    }
+    else if (y < -32768)
+    {
+        return -32768;
+    }
+
+    return (int16_t)y;
+}
+
+static void dsp_design( void )
+{
+    double k;
+    double norm;
+    double w;
+    double c;
+    double sum;
+    int16_t cnt;
+
+    // bilinear Butterworth low-pass
+    k = tan( DSP_PI * DSP_CUTOFF / DSP_FS );
+    norm = 1.0 / (1.0 + sqrt( 2.0 ) * k + k * k);
+    bq_b[ 0 ] = k * k * norm;
+    bq_b[ 1 ] = 2.0 * bq_b[ 0 ];
+    bq_b[ 2 ] = bq_b[ 0 ];
+    bq_a[ 0 ] = 1.0;
+    bq_a[ 1 ] = 2.0 * (k * k - 1.0) * norm;
+    bq_a[ 2 ] = (1.0 - sqrt( 2.0 ) * k + k * k) * norm;
+
+    // windowed-sinc low-pass, unity DC gain
+    sum = 0;
+
+    for (cnt = 0; cnt < DSP_FIR_TAPS; cnt++)
+    {
+        w = cnt - (DSP_FIR_TAPS - 1) / 2;
+        fir_h[ cnt ] = (w == 0) ? 2.0 * DSP_CUTOFF / DSP_FS :
+                       sin( 2.0 * DSP_PI * DSP_CUTOFF / DSP_FS * w ) / (DSP_PI * w);
+        fir_h[ cnt ] *= 0.54 - 0.46 * cos( 2.0 * DSP_PI * cnt / (DSP_FIR_TAPS - 1) );
+        sum += fir_h[ cnt ];
+    }
+
+    for (cnt = 0; cnt < DSP_FIR_TAPS; cnt++)
+    {
+        fir_h[ cnt ] /= sum;
+        fir_hf[ cnt ] = (float)fir_h[ cnt ];
+        fir_hq[ cnt ] = (int16_t)lrint( fir_h[ cnt ] * 32768.0 );
+    }
+
+    // notch with unity DC gain
+    c = cos( 2.0 * DSP_PI * DSP_MAINS / DSP_FS );
+    norm = (1.0 - 2.0 * DSP_NOTCH_R * c + DSP_NOTCH_R * DSP_NOTCH_R) / (2.0 - 2.0 * c);
+    notch_b[ 0 ] = norm;
+    notch_b[ 1 ] = -2.0 * c * norm;
+    notch_b[ 2 ] = norm;
+    notch_a[ 0 ] = 1.0;
+    notch_a[ 1 ] = -2.0 * DSP_NOTCH_R * c;
+    notch_a[ 2 ] = DSP_NOTCH_R * DSP_NOTCH_R;
+
+    for (cnt = 0; cnt < 3; cnt++)
+    {
+        bq_bf[ cnt ] = (float)bq_b[ cnt ];
+        bq_af[ cnt ] = (float)bq_a[ cnt ];
+        bq_bq[ cnt ] = (int16_t)lrint( bq_b[ cnt ] * 16384.0 );
+        bq_aq[ cnt ] = (int16_t)lrint( bq_a[ cnt ] * 16384.0 );
+        notch_bf[ cnt ] = (float)notch_b[ cnt ];
+        notch_af[ cnt ] = (float)notch_a[ cnt ];
+    }
+}
+
+/* reference */
+
+static void ref_iir( const double *b, const double *a, uint32_t n )
+{
+    double y1;
+    double y2;
+    uint32_t i;
+
+    y1 = 0;
+    y2 = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        ref[ i ] = b[ 0 ] * xi[ i ] + b[ 1 ] * xi[ (int32_t)i - 1 ] + b[ 2 ] * xi[ (int32_t)i - 2 ] -
+                   a[ 1 ] * y1 - a[ 2 ] * y2;
+        y2 = y1;
+        y1 = ref[ i ];
+    }
+}
+
+static void ref_biquad( uint32_t n )
+{
+    ref_iir( bq_b, bq_a, n );
+}
+
+static void ref_fir( uint32_t n )
+{
+    double acc;
+    uint32_t i;
+    uint8_t k;
+
+    for (i = 0; i < n; i++)
+    {
+        acc = 0;
+
+        for (k = 0; k < DSP_FIR_TAPS; k++)
+        {
+            acc += fir_h[ k ] * xi[ (int32_t)i - k ];
+        }
+
+        ref[ i ] = acc;
+    }
+}
+
+static void ref_mwi( uint32_t n )
+{
+    double acc;
+    uint32_t i;
+    uint8_t k;
+
+    for (i = 0; i < n; i++)
+    {
+        acc = 0;
+
+        for (k = 0; k < DSP_MWI_LEN; k++)
+        {
+            acc += xi[ (int32_t)i - k ];
+        }
+
+        ref[ i ] = acc / DSP_MWI_LEN;
+    }
+}
+
+static void ref_derivative( uint32_t n )
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        ref[ i ] = (2.0 * xi[ i ] + xi[ (int32_t)i - 1 ] - xi[ (int32_t)i - 3 ] - 2.0 * xi[ (int32_t)i - 4 ]) / 8.0;
+    }
+}
+
+static void ref_notch( uint32_t n )
+{
+    ref_iir( notch_b, notch_a, n );
+}
+
+/* float */
+
+static void float_iir( const float *b, const float *a, uint32_t n )
+{
+    float y1;
+    float y2;
+    float y;
+    uint32_t i;
+
+    y1 = 0;
+    y2 = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        y = b[ 0 ] * xf[ i ] + b[ 1 ] * xf[ (int32_t)i - 1 ] + b[ 2 ] * xf[ (int32_t)i - 2 ] - a[ 1 ] * y1 - a[ 2 ] * y2;
+        y2 = y1;
+        y1 = y;
+        yf[ i ] = y;
+    }
+}
+
+static void float_biquad( uint32_t n )
+{
+    float_iir( bq_bf, bq_af, n );
+}
+
+static void float_fir( uint32_t n )
+{
+    float acc;
+    uint32_t i;
+    uint8_t k;
+
+    for (i = 0; i < n; i++)
+    {
+        acc = 0;
+
+        for (k = 0; k < DSP_FIR_TAPS; k++)
+        {
+            acc += fir_hf[ k ] * xf[ (int32_t)i - k ];
+        }
+
+        yf[ i ] = acc;
+    }
+}
+
+static void float_mwi( uint32_t n )
+{
+    float sum;
+    uint32_t i;
+
+    sum = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        sum += xf[ i ] - xf[ (int32_t)i - DSP_MWI_LEN ];
+        yf[ i ] = sum * (1.0f / DSP_MWI_LEN);
+    }
+}
+
+static void float_derivative( uint32_t n )
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        yf[ i ] = (2.0f * xf[ i ] + xf[ (int32_t)i - 1 ] - xf[ (int32_t)i - 3 ] - 2.0f * xf[ (int32_t)i - 4 ]) * 0.125f;
+    }
+}
+
+static void float_notch( uint32_t n )
+{
+    float_iir( notch_bf, notch_af, n );
+}
+
+/* q15 */
+
+static void q15_biquad( uint32_t n )
+{
+    int32_t acc;
+    int32_t y;
+    int16_t y1;
+    int16_t y2;
+    int16_t err;
+    uint32_t i;
+
+    y1 = 0;
+    y2 = 0;
+    err = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        acc = (int32_t)bq_bq[ 0 ] * xi[ i ] + (int32_t)bq_bq[ 1 ] * xi[ (int32_t)i - 1 ] +
+              (int32_t)bq_bq[ 2 ] * xi[ (int32_t)i - 2 ] - (int32_t)bq_aq[ 1 ] * y1 - (int32_t)bq_aq[ 2 ] * y2 + err;
+        y = acc >> 14;
+        err = (int16_t)(acc - y * 16384);
+        y2 = y1;
+        y1 = dsp_sat( y );
+        yi[ i ] = y1;
+    }
+}
+
+static void q15_fir( uint32_t n )
+{
+    int32_t acc;
+    uint32_t i;
+    uint8_t k;
+
+    for (i = 0; i < n; i++)
+    {
+        acc = 16384;
+
+        for (k = 0; k < DSP_FIR_TAPS; k++)
+        {
+            acc += (int32_t)fir_hq[ k ] * xi[ (int32_t)i - k ];
+        }
+
+        yi[ i ] = dsp_sat( acc >> 15 );
+    }
+}
+
+static void q15_mwi( uint32_t n )
+{
+    int32_t sum;
+    uint32_t i;
+
+    sum = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        sum += (int32_t)xi[ i ] - xi[ (int32_t)i - DSP_MWI_LEN ];
+        yi[ i ] = (int16_t)((sum + DSP_MWI_LEN / 2) >> 6);
+    }
+}
+
+static void q15_derivative( uint32_t n )
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        yi[ i ] = (int16_t)((2 * (int32_t)xi[ i ] + xi[ (int32_t)i - 1 ] - xi[ (int32_t)i - 3 ] -
+                             2 * (int32_t)xi[ (int32_t)i - 4 ]) >> 3);
+    }
+}
+
+static void q15_notch( uint32_t n )
+{
+    T_ecg4_filter flt;
+    uint32_t i;
+    uint16_t len;
+
+    ecg4_filter_init( &flt, 0, _ECG4_FILTER_NOTCH_50HZ );
+    memcpy( yi, xi, n * sizeof( int16_t ) );
+
+    for (i = 0; i < n; i += len)
+    {
+        len = (n - i < 0x8000) ? (uint16_t)(n - i) : 0x8000;
+        ecg4_filter_block( &flt, &yi[ i ], len );
+    }
+}
+
+/* simd */
+
+#ifdef __SSE2__
+
+static void simd_fir( uint32_t n )
+{
+    __m128 acc;
+    uint32_t i;
+    uint8_t k;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        acc = _mm_setzero_ps();
+
+        for (k = 0; k < DSP_FIR_TAPS; k++)
+        {
+            acc = _mm_add_ps( acc, _mm_mul_ps( _mm_set1_ps( fir_hf[ k ] ), _mm_loadu_ps( &xf[ (int32_t)i - k ] ) ) );
+        }
+
+        _mm_storeu_ps( &yf[ i ], acc );
+    }
+
+    for (; i < n; i++)
+    {
+        yf[ i ] = 0;
+
+        for (k = 0; k < DSP_FIR_TAPS; k++)
+        {
+            yf[ i ] += fir_hf[ k ] * xf[ (int32_t)i - k ];
+        }
+    }
+}
+
+static void simd_mwi( uint32_t n )
+{
+    __m128i sum;
+    __m128i d;
+    __m128i lo;
+    __m128i hi;
+    __m128i y;
+    uint32_t i;
+    int32_t s;
+
+    sum = _mm_setzero_si128();
+    s = 0;
+
+    // eight sample differences per step, prefix summed within the register
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        d = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&xi[ i ] ),
+                           _mm_loadu_si128( (const __m128i*)&xi[ (int32_t)i - DSP_MWI_LEN ] ) );
+        lo = _mm_srai_epi32( _mm_unpacklo_epi16( d, d ), 16 );
+        hi = _mm_srai_epi32( _mm_unpackhi_epi16( d, d ), 16 );
+        lo = _mm_add_epi32( lo, _mm_slli_si128( lo, 4 ) );
+        lo = _mm_add_epi32( lo, _mm_slli_si128( lo, 8 ) );
+        hi = _mm_add_epi32( hi, _mm_slli_si128( hi, 4 ) );
+        hi = _mm_add_epi32( hi, _mm_slli_si128( hi, 8 ) );
+        lo = _mm_add_epi32( lo, sum );
+        hi = _mm_add_epi32( hi, _mm_shuffle_epi32( lo, 0xFF ) );
+        sum = _mm_shuffle_epi32( hi, 0xFF );
+        lo = _mm_srai_epi32( _mm_add_epi32( lo, _mm_set1_epi32( DSP_MWI_LEN / 2 ) ), 6 );
+        hi = _mm_srai_epi32( _mm_add_epi32( hi, _mm_set1_epi32( DSP_MWI_LEN / 2 ) ), 6 );
+        y = _mm_packs_epi32( lo, hi );
+        _mm_storeu_si128( (__m128i*)&yi[ i ], y );
+    }
+
+    s = _mm_cvtsi128_si32( sum );
+
+    for (; i < n; i++)
+    {
+        s += (int32_t)xi[ i ] - xi[ (int32_t)i - DSP_MWI_LEN ];
+        yi[ i ] = (int16_t)((s + DSP_MWI_LEN / 2) >> 6);
+    }
+}
+
+static void simd_derivative( uint32_t n )
+{
+    __m128i x0;
+    __m128i x1;
+    __m128i x3;
+    __m128i x4;
+    __m128i lo;
+    __m128i hi;
+    uint32_t i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        x0 = _mm_loadu_si128( (const __m128i*)&xi[ i ] );
+        x1 = _mm_loadu_si128( (const __m128i*)&xi[ (int32_t)i - 1 ] );
+        x3 = _mm_loadu_si128( (const __m128i*)&xi[ (int32_t)i - 3 ] );
+        x4 = _mm_loadu_si128( (const __m128i*)&xi[ (int32_t)i - 4 ] );
+
+        // 2 x0 + x1 - x3 - 2 x4 needs 18 bits, 2 x (x0 - x4) + (x1 - x3) in 32 bit lanes
+        lo = _mm_add_epi32( _mm_slli_epi32( _mm_sub_epi32( _mm_srai_epi32( _mm_unpacklo_epi16( x0, x0 ), 16 ),
+                                                           _mm_srai_epi32( _mm_unpacklo_epi16( x4, x4 ), 16 ) ), 1 ),
+                            _mm_sub_epi32( _mm_srai_epi32( _mm_unpacklo_epi16( x1, x1 ), 16 ),
+                                           _mm_srai_epi32( _mm_unpacklo_epi16( x3, x3 ), 16 ) ) );
+        hi = _mm_add_epi32( _mm_slli_epi32( _mm_sub_epi32( _mm_srai_epi32( _mm_unpackhi_epi16( x0, x0 ), 16 ),
+                                                           _mm_srai_epi32( _mm_unpackhi_epi16( x4, x4 ), 16 ) ), 1 ),
+                            _mm_sub_epi32( _mm_srai_epi32( _mm_unpackhi_epi16( x1, x1 ), 16 ),
+                                           _mm_srai_epi32( _mm_unpackhi_epi16( x3, x3 ), 16 ) ) );
+        _mm_storeu_si128( (__m128i*)&yi[ i ], _mm_packs_epi32( _mm_srai_epi32( lo, 3 ), _mm_srai_epi32( hi, 3 ) ) );
+    }
+
+    for (; i < n; i++)
+    {
+        yi[ i ] = (int16_t)((2 * (int32_t)xi[ i ] + xi[ (int32_t)i - 1 ] - xi[ (int32_t)i - 3 ] -
+                             2 * (int32_t)xi[ (int32_t)i - 4 ]) >> 3);
+    }
+}
+
+#endif
+
+static const T_dsp_case dsp_cases[] =
+{
+    { "biquad",     "float", &float_biquad,     &ref_biquad,     1 },
+    { "biquad",     "q15",   &q15_biquad,       &ref_biquad,     0 },
+    { "fir",        "float", &float_fir,        &ref_fir,        1 },
+    { "fir",        "q15",   &q15_fir,          &ref_fir,        0 },
+#ifdef __SSE2__
+    { "fir",        "simd",  &simd_fir,         &ref_fir,        1 },
+#endif
+    { "mwi",        "float", &float_mwi,        &ref_mwi,        1 },
+    { "mwi",        "q15",   &q15_mwi,          &ref_mwi,        0 },
+#ifdef __SSE2__
+    { "mwi",        "simd",  &simd_mwi,         &ref_mwi,        0 },
+#endif
+    { "derivative", "float", &float_derivative, &ref_derivative, 1 },
+    { "derivative", "q15",   &q15_derivative,   &ref_derivative, 0 },
+#ifdef __SSE2__
+    { "derivative", "simd",  &simd_derivative,  &ref_derivative, 0 },
+#endif
+    { "notch",      "float", &float_notch,      &ref_notch,      1 },
+    { "notch",      "q15",   &q15_notch,        &ref_notch,      0 },
+};
+
+static void dsp_error( const T_dsp_case *c, uint32_t n, double *max_err, double *rms_err )
+{
+    double e;
+    double sum;
+    uint32_t i;
+
+    *max_err = 0;
+    sum = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        e = fabs( ((c->out_float) ? (double)yf[ i ] : (double)yi[ i ]) - ref[ i ] );
+        sum += e * e;
+
+        if (e > *max_err)
+        {
+            *max_err = e;
+        }
+    }
+
+    *rms_err = sqrt( sum / n );
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    static T_ecg4_synth syn;
+    T_ecg4_synth_cfg synth_cfg;
+    const T_dsp_case *c;
+    double best;
+    double t0;
+    double t1;
+    double ghz;
+    double max_err;
+    double rms_err;
+    double cycles;
+    uint64_t c0;
+    uint64_t c1;
+    uint64_t best_cycles;
+    uint64_t seed;
+    uint32_t n;
+    uint32_t i;
+    int repeats;
+    int rep;
+    int opt;
+    uint8_t idx;
+
+    n = 1u << 20;
+    repeats = 5;
+    ghz = 0;
+    seed = 1;
+
+    while ((opt = getopt( argc, argv, "n:r:g:s:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': n = strtoul( optarg, NULL, 0 ); break;
+            case 'r': repeats = atoi( optarg ); break;
+            case 'g': ghz = atof( optarg ); break;
+            case 's': seed = strtoull( optarg, NULL, 0 ); break;
+            default: dsp_usage();
+        }
+    }
+
+    if ((n == 0) || (repeats < 1))
+    {
+        dsp_usage();
+    }
+
+    xi = calloc( n + DSP_PAD, sizeof( int16_t ) );
+    xf = calloc( n + DSP_PAD, sizeof( float ) );
+    yi = calloc( n, sizeof( int16_t ) );
+    yf = calloc( n, sizeof( float ) );
+    ref = calloc( n, sizeof( double ) );
+
+    if ((xi == NULL) || (xf == NULL) || (yi == NULL) || (yf == NULL) || (ref == NULL))
+    {
+        perror( "calloc" );
+        return 1;
+    }
+
+    xi += DSP_PAD;
+    xf += DSP_PAD;
+
+    ecg4_synth_default( &synth_cfg, seed );
+    synth_cfg.noise = 20;
+    synth_cfg.mains = 200;
+    ecg4_synth_init( &syn, &synth_cfg );
+
+    for (i = 0; i < n; i++)
+    {
+        xi[ i ] = ecg4_synth_sample( &syn );
+        xf[ i ] = xi[ i ];
+    }
+
+    dsp_design();
+
+#ifndef DSP_TSC
+    if (ghz == 0)
+    {
+        ghz = 1;
+    }
+#endif
+
+    printf( "%u samples, best of %d, cycles from %s\n", n, repeats, (ghz == 0) ? "the time stamp counter" : "-g" );
+    printf( "kernel     variant   Msamples/s  cycles/sample    max_err_lsb    rms_err_lsb\n" );
+
+    for (idx = 0; idx < sizeof( dsp_cases ) / sizeof( dsp_cases[ 0 ] ); idx++)
+    {
+        c = &dsp_cases[ idx ];
+
+        if ((idx == 0) || (c->ref != dsp_cases[ idx - 1 ].ref))
+        {
+            c->ref( n );
+        }
+
+        best = 0;
+        best_cycles = 0;
+
+        for (rep = 0; rep < repeats; rep++)
+        {
+            t0 = dsp_now();
+            c0 = dsp_cycles();
+            c->run( n );
+            c1 = dsp_cycles();
+            t1 = dsp_now();
+
+            if ((rep == 0) || (t1 - t0 < best))
+            {
+                best = t1 - t0;
+                best_cycles = c1 - c0;
+            }
+        }
+
+        cycles = (ghz == 0) ? (double)best_cycles / n : best * ghz * 1e9 / n;
+        dsp_error( c, n, &max_err, &rms_err );
+        printf( "%-10s %-8s %11.1f %14.2f %14.4f %14.4f\n",
+                c->kernel, c->variant, n / best / 1e6, cycles, max_err, rms_err );
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_dsp_bench.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,491 @@
+/*
+    ecg4_emu.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_emu.c
+@brief    ECG_4 Device Emulator
+
+Emulates one or many ECG_4 clicks on pseudo-terminals: ThinkGear frames with 512 raw data rows and one signal
+quality and heart rate row per second, paced byte by byte at the baud rate (10 bits per byte), or faster with
+-x. The data is synthetic (ecg4_synth, seeded with -s plus the device index, with a different heart rate on every
+device), or a recorded byte stream
+(-f, e.g. a capture for the Linux example) replayed in a loop with one raw data frame per 1 / 512 s.
+
+The pty paths are printed, -l makes symlinks <prefix>0, <prefix>1, ... to them. A device without a reader
+drops its bytes like a UART without a receiver. On exit (-t, SIGINT or SIGTERM) the bytes sent and dropped and
+the worst pacing lag are printed; with -g, bytes due within that window are written together, which keeps
+hundreds of devices within the pacing of one core.
+
+    gcc -O2 -o ecg4_emu ecg4_emu.c ecg4_synth.c ecg4_frame.c -lm
+
+    ecg4_emu [-n devices] [-b baud] [-x speed] [-g batch_us] [-t seconds] [-f capture] [-l link_prefix] [-s seed]
+
+Defaults: 1 device, 57600 baud, real time, byte accurate pacing, runs until stopped.
+*/
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "ecg4_frame.h"
+#include "ecg4_synth.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define EMU_FS                  512
+#define EMU_RAW_DATA_CODE       0x80
+#define EMU_CHUNK               256
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    int      master;
+    int      slave;
+    char     path[ 64 ];
+    uint8_t  buf[ 2 * ECG4_FRAME_MAX ];
+    uint16_t len;
+    uint16_t pos;
+    uint64_t byte_due;          /**< Due time of the next byte */
+    uint64_t frame_due;         /**< Due time of the next raw data frame */
+    uint32_t n;                 /**< Raw data frames sent */
+    T_ecg4_synth syn;
+    size_t   file_pos;
+    uint64_t bytes;
+    uint64_t dropped;
+
+}T_emu_dev;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static volatile sig_atomic_t stop;
+static uint64_t byte_ns;
+static uint64_t frame_ns;
+static uint64_t lag_max_ns;
+static uint8_t *file_data;
+static size_t file_len;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void emu_stop( int sig )
+{
+    (void)sig;
+    stop = 1;
+}
+
+static uint64_t emu_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// next frame of the capture, 0 - no frame in the whole file
+static uint16_t emu_file_frame( T_emu_dev *dev, uint8_t *raw )
+{
+    size_t scanned;
+    size_t pos;
+    uint16_t len;
+
+    for (scanned = 0; scanned < file_len; scanned++)
+    {
+        pos = dev->file_pos;
+
+        if (pos + 4 <= file_len && file_data[ pos ] == 0xAA && file_data[ pos + 1 ] == 0xAA &&
+            file_data[ pos + 2 ] < 170 && pos + file_data[ pos + 2 ] + 4 <= file_len)
+        {
+            len = file_data[ pos + 2 ] + 4;
+            memcpy( dev->buf, &file_data[ pos ], len );
+            *raw = (file_data[ pos + 3 ] == EMU_RAW_DATA_CODE);
+            dev->file_pos = (pos + len == file_len) ? 0 : pos + len;
+
+            return len;
+        }
+
+        dev->file_pos = (pos + 1 == file_len) ? 0 : pos + 1;
+    }
+
+    return 0;
+}
+
+static void emu_load( T_emu_dev *dev )
+{
+    uint8_t raw;
+
+    raw = 0;
+
+    if (file_data != NULL)
+    {
+        dev->len = emu_file_frame( dev, &raw );
+    }
+    else
+    {
+        dev->len = ecg4_synth_frames( &dev->syn, dev->buf );
+        raw = 1;
+    }
+
+    dev->pos = 0;
+
+    // raw data frames are due every 1 / 512 s, other frames follow the previous one
+    if (raw)
+    {
+        if (dev->frame_due > dev->byte_due - byte_ns)
+        {
+            dev->byte_due = dev->frame_due + byte_ns;
+        }
+
+        dev->frame_due += frame_ns;
+        dev->n++;
+    }
+}
+
+static void emu_synth( T_emu_dev *dev, uint64_t seed )
+{
+    T_ecg4_synth_cfg cfg;
+
+    ecg4_synth_default( &cfg, seed );
+    cfg.bpm = 60 + (double)(seed % 41);
+    ecg4_synth_init( &dev->syn, &cfg );
+}
+
+static int emu_open( T_emu_dev *dev, const char *link_prefix, int idx )
+{
+    struct termios tio;
+    char link_path[ 256 ];
+    const char *name;
+
+    dev->master = posix_openpt( O_RDWR | O_NOCTTY );
+
+    if ((dev->master < 0) || (grantpt( dev->master ) != 0) || (unlockpt( dev->master ) != 0))
+    {
+        return -1;
+    }
+
+    name = ptsname( dev->master );
+
+    if (name == NULL)
+    {
+        return -1;
+    }
+
+    snprintf( dev->path, sizeof( dev->path ), "%s", name );
+
+    // the slave stays open, so the pty keeps its settings and buffers while no reader is attached
+    dev->slave = open( dev->path, O_RDWR | O_NOCTTY );
+
+    if ((dev->slave < 0) || (tcgetattr( dev->slave, &tio ) != 0))
+    {
+        return -1;
+    }
+
+    cfmakeraw( &tio );
+    cfsetispeed( &tio, B57600 );
+    cfsetospeed( &tio, B57600 );
+    tcsetattr( dev->slave, TCSANOW, &tio );
+    fcntl( dev->master, F_SETFL, fcntl( dev->master, F_GETFL ) | O_NONBLOCK );
+
+    if (link_prefix != NULL)
+    {
+        snprintf( link_path, sizeof( link_path ), "%s%d", link_prefix, idx );
+        unlink( link_path );
+
+        if (symlink( dev->path, link_path ) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// writes the bytes due until the given time, returns the due time of the next byte
+static uint64_t emu_send( T_emu_dev *dev, uint64_t until, uint64_t now )
+{
+    uint8_t chunk[ EMU_CHUNK ];
+    uint16_t cnt;
+    ssize_t res;
+
+    cnt = 0;
+
+    if ((dev->byte_due <= now) && (now - dev->byte_due > lag_max_ns))
+    {
+        lag_max_ns = now - dev->byte_due;
+    }
+
+    while ((dev->byte_due <= until) && (cnt < EMU_CHUNK))
+    {
+        chunk[ cnt++ ] = dev->buf[ dev->pos++ ];
+        dev->byte_due += byte_ns;
+
+        if (dev->pos == dev->len)
+        {
+            emu_load( dev );
+        }
+    }
+
+    if (cnt != 0)
+    {
+        res = write( dev->master, chunk, cnt );
+
+        if (res < 0)
+        {
+            res = 0;
+        }
+
+        dev->bytes += res;
+        dev->dropped += cnt - res;
+    }
+
+    return dev->byte_due;
+}
+
+static int emu_read_file( const char *path )
+{
+    FILE *f;
+    long len;
+
+    f = fopen( path, "rb" );
+
+    if ((f == NULL) || (fseek( f, 0, SEEK_END ) != 0) || ((len = ftell( f )) <= 0))
+    {
+        return -1;
+    }
+
+    rewind( f );
+    file_data = malloc( len );
+    file_len = (size_t)len;
+
+    if ((file_data == NULL) || (fread( file_data, 1, file_len, f ) != file_len))
+    {
+        return -1;
+    }
+
+    fclose( f );
+
+    return 0;
+}
+
+static void emu_usage( void )
+{
+    fprintf( stderr, "usage: ecg4_emu [-n devices] [-b baud] [-x speed] [-g batch_us] [-t seconds] [-f capture] "
+             "[-l link_prefix] [-s seed]\n" );
+    exit( 2 );
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    T_emu_dev *devs;
+    struct timespec ts;
+    const char *file_path;
+    const char *link_prefix;
+    uint64_t start;
+    uint64_t end;
+    uint64_t now;
+    uint64_t next;
+    uint64_t due;
+    uint64_t batch_ns;
+    uint64_t bytes;
+    uint64_t dropped;
+    uint64_t seed;
+    double speed;
+    double seconds;
+    uint32_t baud;
+    int n_devs;
+    int opt;
+    int cnt;
+
+    n_devs = 1;
+    baud = 57600;
+    speed = 1;
+    batch_ns = 0;
+    seconds = 0;
+    file_path = NULL;
+    link_prefix = NULL;
+    seed = 1;
+
+    while ((opt = getopt( argc, argv, "n:b:x:g:t:f:l:s:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'n' :
+                n_devs = atoi( optarg );
+                break;
+            case 'b' :
+                baud = (uint32_t)atol( optarg );
+                break;
+            case 'x' :
+                speed = atof( optarg );
+                break;
+            case 'g' :
+                batch_ns = (uint64_t)(atof( optarg ) * 1000);
+                break;
+            case 't' :
+                seconds = atof( optarg );
+                break;
+            case 'f' :
+                file_path = optarg;
+                break;
+            case 'l' :
+                link_prefix = optarg;
+                break;
+            case 's' :
+                seed = strtoull( optarg, NULL, 0 );
+                break;
+            default :
+                emu_usage();
+        }
+    }
+
+    if ((n_devs <= 0) || (baud == 0) || (speed <= 0))
+    {
+        emu_usage();
+    }
+
+    if ((file_path != NULL) && (emu_read_file( file_path ) != 0))
+    {
+        perror( file_path );
+        return 1;
+    }
+
+    byte_ns = (uint64_t)(1e10 / baud / speed);
+    frame_ns = (uint64_t)(1e9 / EMU_FS / speed);
+    devs = calloc( n_devs, sizeof( T_emu_dev ) );
+
+    if (devs == NULL)
+    {
+        return 1;
+    }
+
+    signal( SIGINT, emu_stop );
+    signal( SIGTERM, emu_stop );
+    signal( SIGPIPE, SIG_IGN );
+    start = emu_now();
+
+    for (cnt = 0; cnt < n_devs; cnt++)
+    {
+        if (emu_open( &devs[ cnt ], link_prefix, cnt ) != 0)
+        {
+            perror( "ecg4_emu: pty" );
+            return 1;
+        }
+
+        emu_synth( &devs[ cnt ], seed + cnt );
+        devs[ cnt ].frame_due = start + (uint64_t)cnt * frame_ns / n_devs;
+        devs[ cnt ].byte_due = devs[ cnt ].frame_due + byte_ns;
+        emu_load( &devs[ cnt ] );
+
+        if (file_data != NULL && devs[ cnt ].len == 0)
+        {
+            fprintf( stderr, "ecg4_emu: no frames in %s\n", file_path );
+            return 1;
+        }
+
+        printf( "device %d: %s\n", cnt, devs[ cnt ].path );
+    }
+
+    fflush( stdout );
+    end = (seconds > 0) ? start + (uint64_t)(seconds * 1e9) : 0;
+
+    while (!stop)
+    {
+        now = emu_now();
+
+        if ((end != 0) && (now >= end))
+        {
+            break;
+        }
+
+        next = now + 1000000000ull;
+
+        for (cnt = 0; cnt < n_devs; cnt++)
+        {
+            due = emu_send( &devs[ cnt ], now + batch_ns, now );
+
+            if (due < next)
+            {
+                next = due;
+            }
+        }
+
+        ts.tv_sec = next / 1000000000ull;
+        ts.tv_nsec = next % 1000000000ull;
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL );
+    }
+
+    bytes = 0;
+    dropped = 0;
+
+    for (cnt = 0; cnt < n_devs; cnt++)
+    {
+        bytes += devs[ cnt ].bytes;
+        dropped += devs[ cnt ].dropped;
+    }
+
+    now = emu_now();
+    fprintf( stderr, "%d devices, %.1f s: %llu bytes sent (%.0f B/s per device), %llu dropped, worst lag %.3f ms\n",
+             n_devs, (now - start) / 1e9, (unsigned long long)bytes, bytes / ((now - start) / 1e9) / n_devs,
+             (unsigned long long)dropped, lag_max_ns / 1e6 );
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_emu.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
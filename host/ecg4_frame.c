@@ -0,0 +1,112 @@
+/*
+    ecg4_frame.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_frame.c
+@brief    ECG_4 Stream Frame Builder
+*/
+
+#include "ecg4_frame.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define FRAME_SYNC              0xAA
+#define FRAME_QUALITY_CODE      0x02
+#define FRAME_HEART_RATE_CODE   0x03
+#define FRAME_RAW_DATA_CODE     0x80
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+uint8_t ecg4_frame_build( uint8_t *frame, const uint8_t *payload, uint8_t len )
+{
+    uint8_t checksum;
+    uint8_t cnt;
+
+    frame[ 0 ] = FRAME_SYNC;
+    frame[ 1 ] = FRAME_SYNC;
+    frame[ 2 ] = len;
+    checksum = 0;
+
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        frame[ 3 + cnt ] = payload[ cnt ];
+        checksum += payload[ cnt ];
+    }
+
+    frame[ 3 + len ] = ~checksum;
+
+    return len + 4;
+}
+
+uint8_t ecg4_frame_raw( uint8_t *frame, int16_t sample )
+{
+    uint8_t payload[ 4 ];
+
+    payload[ 0 ] = FRAME_RAW_DATA_CODE;
+    payload[ 1 ] = 2;
+    payload[ 2 ] = (uint8_t)((uint16_t)sample >> 8);
+    payload[ 3 ] = (uint8_t)sample;
+
+    return ecg4_frame_build( frame, payload, 4 );
+}
+
+uint8_t ecg4_frame_status( uint8_t *frame, uint8_t quality, uint8_t heart_rate )
+{
+    uint8_t payload[ 4 ];
+
+    payload[ 0 ] = FRAME_QUALITY_CODE;
+    payload[ 1 ] = quality;
+    payload[ 2 ] = FRAME_HEART_RATE_CODE;
+    payload[ 3 ] = heart_rate;
+
+    return ecg4_frame_build( frame, payload, 4 );
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_frame.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,111 @@
+/*
+    ecg4_frame.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_frame.h
+@brief    ECG_4 Stream Frame Builder
+
+Builds the ThinkGear frames sent by the BMD101 (sync 0xAA 0xAA, payload length, payload rows, inverted sum
+checksum), for the host tools which feed the driver or a device emulator.
+*/
+
+#include <stdint.h>
+
+#ifndef _ECG4_FRAME_H_
+#define _ECG4_FRAME_H_
+
+/**
+ * @macro ECG4_FRAME_MAX
+ * @brief Largest frame, 3 header bytes, 169 payload bytes and the checksum
+ */
+#define ECG4_FRAME_MAX          173
+
+/**
+ * @macro ECG4_FRAME_RAW_LEN
+ * @brief Length of a raw data frame
+ */
+#define ECG4_FRAME_RAW_LEN      8
+
+/**
+ * @brief Frame Build function
+ *
+ * @param[out] frame    Frame, ECG4_FRAME_MAX bytes
+ * @param[in]  payload  Payload rows
+ * @param[in]  len      Payload length, 169 at most
+ *
+ * @returns Frame length
+ */
+uint8_t ecg4_frame_build( uint8_t *frame, const uint8_t *payload, uint8_t len );
+
+/**
+ * @brief Raw Data Frame function
+ *
+ * @param[out] frame   Frame, ECG4_FRAME_RAW_LEN bytes
+ * @param[in]  sample  Raw data sample
+ *
+ * @returns Frame length
+ */
+uint8_t ecg4_frame_raw( uint8_t *frame, int16_t sample );
+
+/**
+ * @brief Status Frame function
+ *
+ * @param[out] frame       Frame
+ * @param[in]  quality     Signal quality row (0 - sensor off, 200 - sensor on)
+ * @param[in]  heart_rate  Heart rate row in BPM
+ *
+ * @returns Frame length
+ *
+ * Function builds the once per second frame with the signal quality and heart rate rows.
+ */
+uint8_t ecg4_frame_status( uint8_t *frame, uint8_t quality, uint8_t heart_rate );
+
+#endif
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_frame.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,230 @@
+/*
+    ecg4_gen.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_gen.c
+@brief    ECG_4 Synthetic Stream Generator Tool
+
+Writes a seeded synthetic BMD101 byte stream (or, with -S, the samples as 16 bit little-endian integers) and
+its annotations, one per line: sample index, stream offset, type and value (see ecg4_synth.h).
+
+    gcc -O2 -o ecg4_gen ecg4_gen.c ecg4_synth.c ecg4_frame.c -lm
+
+    ecg4_gen [-s seed] [-t seconds] [-r bpm] [-v hrv] [-A amplitude] [-n noise] [-w wander] [-m mains]
+             [-L leadoffs_per_hour] [-l leadoff_s] [-D drop_rate] [-F flip_rate] [-C collide_rate]
+             [-S] [-a annotations] [-o output]
+
+Defaults: seed 1, 60 s, the ecg4_synth_default configuration, stream to stdout, no annotations.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "ecg4_synth.h"
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void gen_annotate( void *ctx, const T_ecg4_synth_event *ev )
+{
+    fprintf( (FILE*)ctx, "%llu %llu %c %ld\n", (unsigned long long)ev->sample, (unsigned long long)ev->offset,
+             ev->type, (long)ev->value );
+}
+
+static void gen_usage( void )
+{
+    fprintf( stderr, "usage: ecg4_gen [-s seed] [-t seconds] [-r bpm] [-v hrv] [-A amplitude] [-n noise] [-w wander]\n"
+             "                [-m mains] [-L leadoffs_per_hour] [-l leadoff_s] [-D drop_rate] [-F flip_rate]\n"
+             "                [-C collide_rate] [-S] [-a annotations] [-o output]\n" );
+    exit( 2 );
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    T_ecg4_synth_cfg cfg;
+    static T_ecg4_synth syn;
+    uint8_t buf[ ECG4_SYNTH_FRAMES_MAX ];
+    const char *out_path;
+    const char *annot_path;
+    FILE *out;
+    FILE *annot;
+    double seconds;
+    uint64_t n_samples;
+    uint64_t cnt;
+    uint16_t len;
+    int16_t sample;
+    int samples_only;
+    int opt;
+
+    ecg4_synth_default( &cfg, 1 );
+    seconds = 60;
+    samples_only = 0;
+    out_path = NULL;
+    annot_path = NULL;
+    annot = NULL;
+
+    while ((opt = getopt( argc, argv, "s:t:r:v:A:n:w:m:L:l:D:F:C:Sa:o:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 's' :
+                cfg.seed = strtoull( optarg, NULL, 0 );
+                break;
+            case 't' :
+                seconds = atof( optarg );
+                break;
+            case 'r' :
+                cfg.bpm = atof( optarg );
+                break;
+            case 'v' :
+                cfg.hrv = atof( optarg );
+                break;
+            case 'A' :
+                cfg.amplitude = atof( optarg );
+                break;
+            case 'n' :
+                cfg.noise = atof( optarg );
+                break;
+            case 'w' :
+                cfg.wander = atof( optarg );
+                break;
+            case 'm' :
+                cfg.mains = atof( optarg );
+                break;
+            case 'L' :
+                cfg.leadoff_rate = atof( optarg );
+                break;
+            case 'l' :
+                cfg.leadoff_s = atof( optarg );
+                break;
+            case 'D' :
+                cfg.drop_rate = atof( optarg );
+                break;
+            case 'F' :
+                cfg.flip_rate = atof( optarg );
+                break;
+            case 'C' :
+                cfg.collide_rate = atof( optarg );
+                break;
+            case 'S' :
+                samples_only = 1;
+                break;
+            case 'a' :
+                annot_path = optarg;
+                break;
+            case 'o' :
+                out_path = optarg;
+                break;
+            default :
+                gen_usage();
+        }
+    }
+
+    if ((seconds <= 0) || (cfg.bpm <= 0))
+    {
+        gen_usage();
+    }
+
+    out = (out_path != NULL) ? fopen( out_path, "wb" ) : stdout;
+
+    if (out == NULL)
+    {
+        perror( out_path );
+        return 1;
+    }
+
+    if (annot_path != NULL)
+    {
+        annot = fopen( annot_path, "w" );
+
+        if (annot == NULL)
+        {
+            perror( annot_path );
+            return 1;
+        }
+
+        cfg.annotate = gen_annotate;
+        cfg.ctx = annot;
+    }
+
+    ecg4_synth_init( &syn, &cfg );
+    n_samples = (uint64_t)(seconds * ECG4_SYNTH_FS);
+
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        if (samples_only)
+        {
+            sample = ecg4_synth_sample( &syn );
+            buf[ 0 ] = (uint8_t)sample;
+            buf[ 1 ] = (uint8_t)((uint16_t)sample >> 8);
+            len = 2;
+        }
+        else
+        {
+            len = ecg4_synth_frames( &syn, buf );
+        }
+
+        if (fwrite( buf, 1, len, out ) != len)
+        {
+            perror( "ecg4_gen" );
+            return 1;
+        }
+    }
+
+    if (annot != NULL)
+    {
+        fclose( annot );
+    }
+
+    return (fclose( out ) == 0) ? 0 : 1;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_gen.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
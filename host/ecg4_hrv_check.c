@@ -0,0 +1,419 @@
+/*
+    ecg4_hrv_check.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_hrv_check.c
+@brief    ECG_4 HRV Check
+
+Feeds a seeded RR interval sequence with rate changes, fast rhythms filling the ring, gaps (ecg4_hrv_gap) and
+rejected intervals (out of the 128 - 1024 samples range) to __ecg4_hrv with a 1 and a 5 minute window, and after
+every beat compares ecg4_hrv_get with mean RR, SDNN, RMSSD and pNN50 recomputed by brute force, in double, over the
+intervals the window must hold. Exits with 1 on the first mismatch beyond the resolution of the build.
+
+Build it once for the fixed-point sums and once with ECG4_HRV_FLOAT:
+
+    gcc -O2 -I../library -o ecg4_hrv_check ecg4_hrv_check.c ../library/__ecg4_hrv.c -lm
+    gcc -O2 -I../library -DECG4_HRV_FLOAT -o ecg4_hrv_check_f ecg4_hrv_check.c ../library/__ecg4_hrv.c -lm
+
+    ecg4_hrv_check [-n beats] [-s seed] [-g gap_pct] [-r reject_pct]
+
+Defaults: 200000 beats, seed 1, 2% gaps, 1% rejected intervals.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "__ecg4_hrv.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define CHECK_RR_MIN            128
+#define CHECK_RR_MAX            1024
+#define CHECK_SEGMENT           400
+
+#ifdef ECG4_HRV_FLOAT
+#define CHECK_UNIT              1.0         // results in ms and %
+#define CHECK_TOL_MS            1e-6
+#define CHECK_TOL_PCT           1e-9
+#define CHECK_BUILD             "double"
+#else
+#define CHECK_UNIT              10.0        // results in 0.1 ms and 0.1 %
+#define CHECK_TOL_MS            0.25        // 2/16 sample, truncation of the Q4 results and of the Q8 variance
+#define CHECK_TOL_PCT           0.0501      // rounding to 0.1 %
+#define CHECK_BUILD             "fixed-point"
+#endif
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    uint16_t rr;
+    uint8_t  successive;
+
+}T_check_beat;
+
+typedef struct
+{
+    uint16_t n;
+    uint32_t span_ms;
+    double   mean_rr;
+    double   sdnn;
+    double   rmssd;
+    double   pnn50;
+
+}T_check_ref;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static uint32_t check_rng;
+static const uint32_t check_len_ms[ ECG4_HRV_WINDOWS ] = { 60000, 300000 };
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint32_t check_rand( void )
+{
+    check_rng ^= check_rng << 13;
+    check_rng ^= check_rng >> 17;
+    check_rng ^= check_rng << 5;
+
+    return check_rng;
+}
+
+static double check_uniform( void )
+{
+    return (check_rand() >> 8) / 16777216.0;
+}
+
+// next RR interval: segments of random rate and variability, with respiratory modulation and noise
+static uint16_t check_next_rr( uint32_t beat )
+{
+    static double mean;
+    static double resp;
+    static double noise;
+    double rr;
+
+    if (beat % CHECK_SEGMENT == 0)
+    {
+        mean = CHECK_RR_MIN + 20 + check_uniform() * (CHECK_RR_MAX - CHECK_RR_MIN - 40);
+
+        // one segment in four is a fast rhythm, so the 5 minute window is limited by the ring
+        if (check_rand() % 4 == 0)
+        {
+            mean = CHECK_RR_MIN + 10 + check_uniform() * 40;
+        }
+
+        resp = check_uniform() * mean * 0.08;
+        noise = 1 + check_uniform() * mean * 0.05;
+    }
+
+    rr = mean + resp * sin( beat * 0.9 ) + (check_uniform() - 0.5) * 2 * noise;
+
+    if (rr < CHECK_RR_MIN)
+    {
+        rr = CHECK_RR_MIN;
+    }
+
+    if (rr > CHECK_RR_MAX)
+    {
+        rr = CHECK_RR_MAX;
+    }
+
+    return (uint16_t)rr;
+}
+
+// metrics of the longest run of the latest intervals within the window length and the ring
+static uint8_t check_reference( const T_check_beat *beats, uint32_t n_beats, uint32_t len_ms, T_check_ref *ref )
+{
+    uint32_t len;
+    uint32_t span;
+    uint32_t first;
+    uint32_t cnt;
+    uint32_t n_diff;
+    uint32_t nn50;
+    double sum;
+    double sum_sq;
+    double sum_sq_diff;
+    double diff;
+
+    len = len_ms * 64 / 125;
+    span = 0;
+    first = n_beats;
+
+    while ((first > 0) && (n_beats - first < ECG4_HRV_RING) && (span + beats[ first - 1 ].rr <= len))
+    {
+        first--;
+        span += beats[ first ].rr;
+    }
+
+    ref->n = (uint16_t)(n_beats - first);
+    ref->span_ms = span * 125 / 64;
+    ref->mean_rr = 0;
+    ref->sdnn = 0;
+    ref->rmssd = 0;
+    ref->pnn50 = 0;
+
+    if (ref->n < 2)
+    {
+        return 0;
+    }
+
+    sum = 0;
+    sum_sq = 0;
+    sum_sq_diff = 0;
+    n_diff = 0;
+    nn50 = 0;
+
+    for (cnt = first; cnt < n_beats; cnt++)
+    {
+        sum += beats[ cnt ].rr * 1000.0 / 512;
+        sum_sq += beats[ cnt ].rr * 1000.0 / 512 * beats[ cnt ].rr * 1000.0 / 512;
+
+        if ((cnt > first) && beats[ cnt ].successive)
+        {
+            diff = ((double)beats[ cnt ].rr - beats[ cnt - 1 ].rr) * 1000.0 / 512;
+            sum_sq_diff += diff * diff;
+            n_diff++;
+
+            if (fabs( diff ) > 50.0)
+            {
+                nn50++;
+            }
+        }
+    }
+
+    ref->mean_rr = sum / ref->n;
+    ref->sdnn = sqrt( fmax( sum_sq / ref->n - ref->mean_rr * ref->mean_rr, 0 ) );
+
+    if (n_diff != 0)
+    {
+        ref->rmssd = sqrt( sum_sq_diff / n_diff );
+        ref->pnn50 = nn50 * 100.0 / n_diff;
+    }
+
+    return 1;
+}
+
+static int check_compare( uint32_t beat, uint8_t idx, uint8_t valid, const T_ecg4_hrv_result *res,
+                          uint8_t ref_valid, const T_check_ref *ref, double *max_err )
+{
+    double err[ 4 ];
+    uint8_t cnt;
+    int bad;
+
+    bad = (valid != ref_valid) || (res->n != ref->n) || (res->span_ms != ref->span_ms);
+
+    if (!bad && valid)
+    {
+        err[ 0 ] = fabs( res->mean_rr / CHECK_UNIT - ref->mean_rr );
+        err[ 1 ] = fabs( res->sdnn / CHECK_UNIT - ref->sdnn );
+        err[ 2 ] = fabs( res->rmssd / CHECK_UNIT - ref->rmssd );
+        err[ 3 ] = fabs( res->pnn50 / CHECK_UNIT - ref->pnn50 );
+
+        for (cnt = 0; cnt < 4; cnt++)
+        {
+            if (err[ cnt ] > max_err[ cnt ])
+            {
+                max_err[ cnt ] = err[ cnt ];
+            }
+        }
+
+        bad = (err[ 0 ] > CHECK_TOL_MS) || (err[ 1 ] > CHECK_TOL_MS) || (err[ 2 ] > CHECK_TOL_MS) ||
+              (err[ 3 ] > CHECK_TOL_PCT);
+    }
+
+    if (bad)
+    {
+        printf( "mismatch at beat %u, window %u:\n", beat, idx );
+        printf( "  ecg4_hrv_get : valid %u, n %u, span %u ms, mean %.4f, sdnn %.4f, rmssd %.4f, pnn50 %.4f\n",
+                valid, res->n, res->span_ms, res->mean_rr / CHECK_UNIT, res->sdnn / CHECK_UNIT,
+                res->rmssd / CHECK_UNIT, res->pnn50 / CHECK_UNIT );
+        printf( "  reference    : valid %u, n %u, span %u ms, mean %.4f, sdnn %.4f, rmssd %.4f, pnn50 %.4f\n",
+                ref_valid, ref->n, ref->span_ms, ref->mean_rr, ref->sdnn, ref->rmssd, ref->pnn50 );
+    }
+
+    return bad;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    static T_ecg4_hrv hrv;
+    T_ecg4_hrv_result res;
+    T_check_ref ref;
+    T_check_beat *beats;
+    uint32_t n_beats;
+    uint32_t n_pushed;
+    uint32_t n_gaps;
+    uint32_t n_rejected;
+    uint32_t beat;
+    uint32_t checks;
+    uint16_t rr;
+    uint8_t gap;
+    uint8_t idx;
+    uint8_t valid;
+    double gap_pct;
+    double reject_pct;
+    double max_err[ 4 ] = { 0, 0, 0, 0 };
+    int opt;
+
+    n_beats = 200000;
+    check_rng = 1;
+    gap_pct = 2.0;
+    reject_pct = 1.0;
+
+    while ((opt = getopt( argc, argv, "n:s:g:r:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': n_beats = atoi( optarg ); break;
+            case 's': check_rng = atoi( optarg ); break;
+            case 'g': gap_pct = atof( optarg ); break;
+            case 'r': reject_pct = atof( optarg ); break;
+            default:
+                fprintf( stderr, "usage: %s [-n beats] [-s seed] [-g gap_pct] [-r reject_pct]\n", argv[ 0 ] );
+                return 2;
+        }
+    }
+
+    if (check_rng == 0)
+    {
+        check_rng = 1;
+    }
+
+    beats = malloc( (size_t)n_beats * sizeof( *beats ) );
+
+    if (beats == NULL)
+    {
+        perror( "malloc" );
+        return 1;
+    }
+
+    ecg4_hrv_init( &hrv );
+
+    for (idx = 0; idx < ECG4_HRV_WINDOWS; idx++)
+    {
+        ecg4_hrv_window( &hrv, check_len_ms[ idx ] );
+    }
+
+    n_pushed = 0;
+    n_gaps = 0;
+    n_rejected = 0;
+    checks = 0;
+    gap = 1;
+
+    for (beat = 0; beat < n_beats; beat++)
+    {
+        if (check_uniform() * 100 < gap_pct)
+        {
+            ecg4_hrv_gap( &hrv );
+            gap = 1;
+            n_gaps++;
+        }
+
+        if (check_uniform() * 100 < reject_pct)
+        {
+            // just out of range, or a missed beat / double detection
+            rr = (check_rand() & 1) ? CHECK_RR_MAX + 1 + check_rand() % 1024 : check_rand() % CHECK_RR_MIN;
+
+            if (ecg4_hrv_push( &hrv, rr ) != 0)
+            {
+                printf( "interval %u accepted at beat %u\n", rr, beat );
+                free( beats );
+                return 1;
+            }
+
+            gap = 1;
+            n_rejected++;
+            continue;
+        }
+
+        rr = check_next_rr( beat );
+
+        if (ecg4_hrv_push( &hrv, rr ) != 1)
+        {
+            printf( "interval %u rejected at beat %u\n", rr, beat );
+            free( beats );
+            return 1;
+        }
+
+        beats[ n_pushed ].rr = rr;
+        beats[ n_pushed ].successive = !gap;
+        n_pushed++;
+        gap = 0;
+
+        for (idx = 0; idx < ECG4_HRV_WINDOWS; idx++)
+        {
+            valid = ecg4_hrv_get( &hrv, idx, &res );
+
+            if (check_compare( beat, idx, valid, &res, check_reference( beats, n_pushed, check_len_ms[ idx ], &ref ),
+                               &ref, max_err ))
+            {
+                free( beats );
+                return 1;
+            }
+
+            checks++;
+        }
+    }
+
+    printf( "build     : %s, ring %u\n", CHECK_BUILD, ECG4_HRV_RING );
+    printf( "beats     : %u pushed, %u gaps, %u rejected, %u checks\n", n_pushed, n_gaps, n_rejected, checks );
+    printf( "max error : mean RR %.6f ms, SDNN %.6f ms, RMSSD %.6f ms, pNN50 %.6f %%\n",
+            max_err[ 0 ], max_err[ 1 ], max_err[ 2 ], max_err[ 3 ] );
+    free( beats );
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_hrv_check.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,675 @@
+/*
+    ecg4_latency.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_latency.c
+@brief    ECG_4 Latency Harness
+
+Measures the latency from the wire to the beat event, in real time, on the host build of the driver.
+
+A feeder thread writes the ecg4_synth stream into a pipe byte by byte, a raw data frame every 1/512 s like the
+sensor, its bytes paced at the baud rate (10 bits per byte, -x speeds both up), and time-stamps every byte as it
+is written. The application side runs as on the target: the
+Linux HAL runs ecg4_uart_isr for every received byte while the core idles in ecg4_wait_for_data, and every
+verified packet is processed like in the example. The raw data samples go through a ring, drained in blocks of
+-k samples, into an __ecg4_pipeline with a filter stage (__ecg4_filter) and a detector stage (__ecg4_qrs), whose
+beats are written to a sink (-o, default /dev/null).
+
+Every sample is time-stamped at every boundary:
+
+- parser   - ecg4_wait_for_data returned the packet,
+- ring     - the sample is in the ring,
+- filter   - the filter stage processed its block,
+- detector - the QRS detector processed the sample,
+- sink     - the beat event detected on the sample is written (beats only),
+
+and the latency of a boundary is measured from the last byte (checksum) of the packet on the wire. For the sink
+this is the packet of the sample on which the beat is detected, so these rows are the processing latency only.
+The r_peak row is the latency a user of the beat events sees: from the packet of the R peak sample
+(ecg4_qrs_beat) to the written beat event, which adds the detector delay (ECG4_QRS_DELAY samples, 158 ms at
+512 Hz) and the search-back wait of the beats found late. Percentiles (p50, p99, p99.9, max) are reported for
+every row over the samples after the -w warm-up, while -l threads load the other cores (CPU and memory
+bandwidth). The report is printed when the stream ends.
+
+    gcc -O2 -pthread -I../library -I../library/HAL -I. -o ecg4_latency ecg4_latency.c ecg4_synth.c ecg4_frame.c \
+        mikrosdk_linux.c ../library/__ecg4_driver.c ../library/__ecg4_parser.c ../library/__ecg4_pipeline.c \
+        ../library/__ecg4_filter.c ../library/__ecg4_qrs.c -lm
+
+    ecg4_latency [-t seconds] [-b baud] [-x speed] [-k block] [-w warmup_s] [-l load_threads] [-s seed] [-o sink]
+
+Defaults: 20 s of signal at 57600 baud in real time, blocks of 1 sample, 3 s warm-up, no load.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "__ecg4_driver.h"
+#include "__ecg4_pipeline.h"
+#include "__ecg4_filter.h"
+#include "__ecg4_qrs.h"
+#include "mikrosdk_linux.h"
+#include "ecg4_synth.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define LAT_FS                  512
+#define LAT_RING                1024
+#define LAT_BLOCK_MAX           256
+#define LAT_LOAD_SIZE           (8 * 1024 * 1024)
+
+#define LAT_PARSER              0
+#define LAT_RING_IN             1
+#define LAT_FILTER              2
+#define LAT_DETECTOR            3
+#define LAT_SINK                4
+#define LAT_BOUNDARIES          5
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    double      seconds;
+    uint32_t    baud;
+    double      speed;
+    uint16_t    block;
+    double      warmup_s;
+    int         load_threads;
+    uint64_t    seed;
+    const char  *sink_path;
+
+}T_lat_cfg;
+
+typedef struct
+{
+    uint32_t offset;            /**< Stream offset of the last byte of the packet */
+    uint64_t t[ LAT_BOUNDARIES ];
+
+}T_lat_sample;
+
+typedef struct
+{
+    int16_t  sample;
+    uint32_t idx;
+
+}T_lat_ring_item;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static const char *lat_boundary_name[ LAT_BOUNDARIES ] = { "parser", "ring", "filter", "detector", "sink" };
+
+static T_lat_cfg cfg;
+
+static uint8_t *stream;
+static uint64_t *wire_ns;
+static uint32_t stream_len;
+static uint32_t *frame_start;   /**< Stream offset of the frames of every sample period */
+static uint32_t n_frames;
+static int feed_fd;
+
+static T_lat_sample *samples;
+static uint32_t n_samples;
+static uint32_t max_samples;
+static uint32_t rx_bytes;
+
+static T_lat_ring_item ring[ LAT_RING ];
+static uint16_t ring_head;
+static uint16_t ring_tail;
+static int16_t block[ LAT_BLOCK_MAX ];
+static uint32_t block_idx[ LAT_BLOCK_MAX ];
+
+static uint8_t response[ 256 ];
+static uint8_t row_counter;
+static uint8_t row_size_cnt;
+
+static T_ecg4_pipeline pipe_ctx;
+static T_ecg4_filter filter;
+static T_ecg4_qrs qrs;
+static FILE *sink;
+static uint32_t beats;
+static uint32_t *beat_peak;     /**< Sample index of the R peak of every beat */
+static uint64_t *beat_sink;     /**< Time the beat event was written */
+static uint32_t ring_full;
+
+static volatile int load_stop;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void lat_usage( void )
+{
+    fprintf( stderr, "usage: ecg4_latency [-t seconds] [-b baud] [-x speed] [-k block] [-w warmup_s] "
+                     "[-l load_threads] [-s seed] [-o sink]\n" );
+    exit( 2 );
+}
+
+static uint64_t lat_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void lat_stream( void )
+{
+    static T_ecg4_synth syn;
+    T_ecg4_synth_cfg synth_cfg;
+    uint32_t n;
+
+    ecg4_synth_default( &synth_cfg, cfg.seed );
+    ecg4_synth_init( &syn, &synth_cfg );
+    n_frames = (uint32_t)(cfg.seconds * LAT_FS);
+    stream = malloc( (size_t)n_frames * ECG4_SYNTH_FRAMES_MAX );
+    wire_ns = calloc( (size_t)n_frames * ECG4_SYNTH_FRAMES_MAX, sizeof( uint64_t ) );
+    frame_start = malloc( ((size_t)n_frames + 1) * sizeof( uint32_t ) );
+    max_samples = n_frames;
+    samples = calloc( max_samples, sizeof( T_lat_sample ) );
+    beat_peak = calloc( max_samples, sizeof( uint32_t ) );
+    beat_sink = calloc( max_samples, sizeof( uint64_t ) );
+
+    if ((stream == NULL) || (wire_ns == NULL) || (frame_start == NULL) || (samples == NULL) || (beat_peak == NULL) ||
+        (beat_sink == NULL))
+    {
+        perror( "malloc" );
+        exit( 1 );
+    }
+
+    stream_len = 0;
+
+    for (n = 0; n < n_frames; n++)
+    {
+        frame_start[ n ] = stream_len;
+        stream_len += ecg4_synth_frames( &syn, &stream[ stream_len ] );
+    }
+
+    frame_start[ n_frames ] = stream_len;
+}
+
+static void *lat_feeder( void *arg )
+{
+    struct timespec ts;
+    uint64_t byte_ns;
+    uint64_t start;
+    uint64_t next;
+    uint64_t due;
+    uint32_t pos;
+    uint32_t n;
+
+    byte_ns = (uint64_t)(10e9 / cfg.baud / cfg.speed);
+    start = lat_now();
+    next = start;
+
+    for (pos = 0, n = 0; pos < stream_len; pos++)
+    {
+        // the frames of a sample period are due every 1 / 512 s, and follow each other back to back when the
+        // link is late, the bytes of a frame at the baud rate
+        if (pos == frame_start[ n ])
+        {
+            due = start + (uint64_t)(n * 1e9 / LAT_FS / cfg.speed);
+            n++;
+
+            if (due > next)
+            {
+                next = due;
+            }
+        }
+
+        next += byte_ns;
+        ts.tv_sec = next / 1000000000ull;
+        ts.tv_nsec = next % 1000000000ull;
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL );
+
+        // stamped before the write, the reader may run before the write returns
+        wire_ns[ pos ] = lat_now();
+
+        if (write( feed_fd, &stream[ pos ], 1 ) != 1)
+        {
+            break;
+        }
+    }
+
+    close( feed_fd );
+
+    return arg;
+}
+
+static void *lat_load( void *arg )
+{
+    uint8_t *buf;
+    uint32_t acc;
+    uint32_t cnt;
+
+    buf = malloc( 2 * LAT_LOAD_SIZE );
+    acc = (uint32_t)(uintptr_t)arg;
+
+    if (buf == NULL)
+    {
+        return NULL;
+    }
+
+    memset( buf, 0x5A, 2 * LAT_LOAD_SIZE );
+
+    while (!load_stop)
+    {
+        memcpy( &buf[ LAT_LOAD_SIZE ], buf, LAT_LOAD_SIZE );
+
+        for (cnt = 0; cnt < LAT_LOAD_SIZE; cnt += 64)
+        {
+            acc = acc * 1664525u + buf[ LAT_LOAD_SIZE + cnt ];
+        }
+
+        buf[ acc % LAT_LOAD_SIZE ] = (uint8_t)acc;
+    }
+
+    free( buf );
+
+    return NULL;
+}
+
+static void lat_stamp( uint32_t idx, uint8_t boundary )
+{
+    samples[ idx ].t[ boundary ] = lat_now();
+}
+
+static void filterStage( void *ctx, int16_t *samples_in, uint16_t n )
+{
+    uint16_t cnt;
+
+    (void)ctx;
+    ecg4_filter_block( &filter, samples_in, n );
+
+    for (cnt = 0; cnt < n; cnt++)
+    {
+        lat_stamp( block_idx[ cnt ], LAT_FILTER );
+    }
+}
+
+static void detectStage( void *ctx, int16_t *samples_in, uint16_t n )
+{
+    uint16_t cnt;
+    uint32_t back;
+
+    (void)ctx;
+
+    for (cnt = 0; cnt < n; cnt++)
+    {
+        if (ecg4_qrs_process( &qrs, samples_in[ cnt ] ))
+        {
+            lat_stamp( block_idx[ cnt ], LAT_DETECTOR );
+            fprintf( sink, "beat %u rr %u\n", ecg4_qrs_beat( &qrs ), ecg4_qrs_rr( &qrs ) );
+            fflush( sink );
+            lat_stamp( block_idx[ cnt ], LAT_SINK );
+
+            // the R peak is that many samples before the one just processed
+            back = qrs.n - 1 - ecg4_qrs_beat( &qrs );
+
+            if ((beats < max_samples) && (back <= block_idx[ cnt ]))
+            {
+                beat_peak[ beats ] = block_idx[ cnt ] - back;
+                beat_sink[ beats ] = samples[ block_idx[ cnt ] ].t[ LAT_SINK ];
+            }
+
+            beats++;
+        }
+        else
+        {
+            lat_stamp( block_idx[ cnt ], LAT_DETECTOR );
+        }
+    }
+}
+
+static void detectReset( void *ctx )
+{
+    (void)ctx;
+    ecg4_qrs_init( &qrs );
+}
+
+static void lat_drain( uint16_t min )
+{
+    uint16_t n;
+    uint16_t len;
+
+    n = (uint16_t)(ring_head - ring_tail) % LAT_RING;
+
+    if ((n == 0) || (n < min))
+    {
+        return;
+    }
+
+    if (n > LAT_BLOCK_MAX)
+    {
+        n = LAT_BLOCK_MAX;
+    }
+
+    for (len = 0; len < n; len++)
+    {
+        block[ len ] = ring[ ring_tail ].sample;
+        block_idx[ len ] = ring[ ring_tail ].idx;
+        ring_tail = (ring_tail + 1) % LAT_RING;
+    }
+
+    ecg4_pipe_process( &pipe_ctx, block, len );
+}
+
+static void lat_ring_push( int16_t sample, uint64_t parsed )
+{
+    uint32_t idx;
+
+    if ((uint16_t)((ring_head + 1) % LAT_RING) == ring_tail)
+    {
+        ring_full++;
+        return;
+    }
+
+    if (n_samples == max_samples)
+    {
+        return;
+    }
+
+    idx = n_samples++;
+    samples[ idx ].offset = rx_bytes - 1;
+    samples[ idx ].t[ LAT_PARSER ] = parsed;
+    ring[ ring_head ].sample = sample;
+    ring[ ring_head ].idx = idx;
+    ring_head = (ring_head + 1) % LAT_RING;
+    lat_stamp( idx, LAT_RING_IN );
+}
+
+static void makeResponse( uint8_t *opCode, uint8_t *rowSize, uint8_t *rxBuff, uint8_t *rowCnt )
+{
+    uint8_t idx_cnt;
+
+    if (*rowCnt == 0)
+    {
+        row_size_cnt = 0;
+    }
+
+    response[ row_size_cnt ] = *opCode;
+    response[ row_size_cnt + 1 ] = *rowSize;
+
+    for (idx_cnt = 0; idx_cnt < *rowSize; idx_cnt++)
+    {
+        response[ row_size_cnt + 2 + idx_cnt ] = rxBuff[ idx_cnt ];
+    }
+
+    row_size_cnt += (*rowSize + 2);
+    row_counter = *rowCnt;
+}
+
+static void processResponse( uint64_t parsed )
+{
+    uint8_t cnt;
+    uint8_t idx_cnt;
+    int16_t raw_data;
+
+    idx_cnt = 0;
+
+    for (cnt = 0; cnt <= row_counter; cnt++)
+    {
+        if (response[ idx_cnt ] == _ECG4_RAW_DATA_CODE_BYTE)
+        {
+            raw_data = response[ idx_cnt + 2 ];
+            raw_data <<= 8;
+            raw_data |= response[ idx_cnt + 3 ];
+            lat_ring_push( raw_data, parsed );
+        }
+        else if (response[ idx_cnt ] == _ECG4_SIGNAL_QUALITY_CODE_BYTE)
+        {
+            ecg4_pipe_quality( &pipe_ctx, response[ idx_cnt + 2 ] );
+        }
+
+        idx_cnt += (response[ idx_cnt + 1 ] + 2);
+    }
+
+    lat_drain( cfg.block );
+}
+
+static void RX_ISR( void )
+{
+    rx_bytes++;
+    ecg4_uart_isr();
+}
+
+static int lat_cmp( const void *a, const void *b )
+{
+    uint64_t va;
+    uint64_t vb;
+
+    va = *(const uint64_t*)a;
+    vb = *(const uint64_t*)b;
+
+    return (va > vb) - (va < vb);
+}
+
+static double lat_percentile( const uint64_t *v, uint32_t n, double p )
+{
+    uint32_t rank;
+
+    rank = (uint32_t)(p * n + 0.999999);
+
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    return v[ rank - 1 ] * 1e-3;
+}
+
+static void lat_row( const char *name, uint64_t *lat, uint32_t n, uint64_t sum )
+{
+    if (n == 0)
+    {
+        printf( "%-10s %9u          -          -          -          -          -\n", name, n );
+        return;
+    }
+
+    qsort( lat, n, sizeof( uint64_t ), lat_cmp );
+    printf( "%-10s %9u %10.1f %10.1f %10.1f %10.1f %10.1f\n", name, n, lat_percentile( lat, n, 0.5 ),
+            lat_percentile( lat, n, 0.99 ), lat_percentile( lat, n, 0.999 ), lat[ n - 1 ] * 1e-3, sum * 1e-3 / n );
+}
+
+static void lat_report( void )
+{
+    uint64_t *lat;
+    uint32_t first;
+    uint32_t cnt;
+    uint32_t n;
+    uint64_t sum;
+    uint8_t boundary;
+
+    load_stop = 1;
+    fflush( sink );
+
+    printf( "stream   : %u bytes, %u samples sent, %u parsed, %u beats, %u ring overruns, %d load threads\n",
+            stream_len, max_samples, n_samples, beats, ring_full, cfg.load_threads );
+    printf( "boundary     samples     p50_us     p99_us   p99.9_us     max_us    mean_us\n" );
+
+    lat = malloc( (size_t)(((n_samples > beats) ? n_samples : beats) + 1) * sizeof( uint64_t ) );
+    first = (uint32_t)(cfg.warmup_s * LAT_FS);
+
+    if (lat == NULL)
+    {
+        return;
+    }
+
+    for (boundary = 0; boundary < LAT_BOUNDARIES; boundary++)
+    {
+        n = 0;
+        sum = 0;
+
+        for (cnt = first; cnt < n_samples; cnt++)
+        {
+            if ((samples[ cnt ].t[ boundary ] == 0) || (wire_ns[ samples[ cnt ].offset ] == 0))
+            {
+                continue;
+            }
+
+            lat[ n ] = samples[ cnt ].t[ boundary ] - wire_ns[ samples[ cnt ].offset ];
+            sum += lat[ n ];
+            n++;
+        }
+
+        lat_row( lat_boundary_name[ boundary ], lat, n, sum );
+    }
+
+    n = 0;
+    sum = 0;
+
+    for (cnt = 0; (cnt < beats) && (cnt < max_samples); cnt++)
+    {
+        if ((beat_sink[ cnt ] == 0) || (beat_peak[ cnt ] < first) ||
+            (wire_ns[ samples[ beat_peak[ cnt ] ].offset ] == 0))
+        {
+            continue;
+        }
+
+        lat[ n ] = beat_sink[ cnt ] - wire_ns[ samples[ beat_peak[ cnt ] ].offset ];
+        sum += lat[ n ];
+        n++;
+    }
+
+    lat_row( "r_peak", lat, n, sum );
+
+    free( lat );
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    pthread_t feeder;
+    pthread_t load;
+    int fds[ 2 ];
+    int opt;
+    int cnt;
+
+    cfg.seconds = 20;
+    cfg.baud = 57600;
+    cfg.speed = 1;
+    cfg.block = 1;
+    cfg.warmup_s = 3;
+    cfg.load_threads = 0;
+    cfg.seed = 1;
+    cfg.sink_path = "/dev/null";
+
+    while ((opt = getopt( argc, argv, "t:b:x:k:w:l:s:o:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 't': cfg.seconds = atof( optarg ); break;
+            case 'b': cfg.baud = atoi( optarg ); break;
+            case 'x': cfg.speed = atof( optarg ); break;
+            case 'k': cfg.block = atoi( optarg ); break;
+            case 'w': cfg.warmup_s = atof( optarg ); break;
+            case 'l': cfg.load_threads = atoi( optarg ); break;
+            case 's': cfg.seed = strtoull( optarg, NULL, 0 ); break;
+            case 'o': cfg.sink_path = optarg; break;
+            default: lat_usage();
+        }
+    }
+
+    if ((cfg.seconds <= 0) || (cfg.baud == 0) || (cfg.speed <= 0) || (cfg.block == 0) ||
+        (cfg.block > LAT_BLOCK_MAX) || (cfg.load_threads < 0))
+    {
+        lat_usage();
+    }
+
+    sink = fopen( cfg.sink_path, "w" );
+
+    if ((sink == NULL) || (pipe( fds ) != 0))
+    {
+        perror( cfg.sink_path );
+        return 1;
+    }
+
+    lat_stream();
+
+    ecg4_filter_init( &filter, 7, _ECG4_FILTER_NOTCH_50HZ );
+    ecg4_qrs_init( &qrs );
+    ecg4_pipe_init( &pipe_ctx, LAT_FS );
+    ecg4_pipe_register( &pipe_ctx, &filterStage, 0, 0, _ECG4_PIPE_RUN_SETTLING );
+    ecg4_pipe_register( &pipe_ctx, &detectStage, &detectReset, 0, _ECG4_PIPE_RUN_SETTLING );
+
+    // the end of the stream ends the program in the Linux HAL, the report is printed then
+    atexit( &lat_report );
+
+    for (cnt = 0; cnt < cfg.load_threads; cnt++)
+    {
+        pthread_create( &load, NULL, &lat_load, (void*)(uintptr_t)(cnt + 1) );
+    }
+
+    _MIKROBUS1_UART.fd = fds[ 0 ];
+    feed_fd = fds[ 1 ];
+    mikrobus_uartInterrupt( _MIKROBUS1, &RX_ISR );
+    ecg4_uartDriverInit( (T_ECG4_P)&_MIKROBUS1_GPIO, (T_ECG4_P)&_MIKROBUS1_UART );
+    ecg4_response_handler_set( &makeResponse );
+
+    if (pthread_create( &feeder, NULL, &lat_feeder, NULL ) != 0)
+    {
+        perror( "pthread_create" );
+        return 1;
+    }
+
+    while (1)
+    {
+        ecg4_wait_for_data();
+        processResponse( lat_now() );
+    }
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_latency.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
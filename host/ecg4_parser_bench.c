@@ -0,0 +1,695 @@
+/*
+    ecg4_parser_bench.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_parser_bench.c
+@brief    ECG_4 Parser Benchmark
+
+Measures the cost of the BMD101 stream parser (__ecg4_parser) on large synthetic streams, through three entries:
+
+- isr   - ecg4_uart_isr of the driver, one call per byte read from the Linux HAL virtual UART, as on the target,
+- byte  - ecg4_parser_byte on a buffer,
+- block - ecg4_parser_block on a buffer, returning at every end of packet,
+
+and four streams:
+
+- clean    - ecg4_synth stream, a raw data frame per sample and a status frame per second,
+- collide  - the same stream with 0xAA / 0x55 forced into 5% of the raw data payloads, without corruption,
+- noisy    - the same stream with byte drops, bit flips, 0xAA / 0x55 payload bytes and lead-off periods,
+- allcodes - random mix of every frame the parser knows: raw data, signal quality, heart rate, several rows per
+             frame, extended code level bytes, long raw data rows, unknown codes and bad checksums.
+
+Every entry and stream pair is timed over the best of -r runs, and reported as JSON with the ns per byte, MB/s,
+verified packets per second, and the instructions, cycles and branch misses per byte from the perf counters of
+the run (null when perf_event_open is not permitted, see /proc/sys/kernel/perf_event_paranoid). The rows and
+packets seen by every entry are checked against the byte entry, and on the clean and collide streams every
+entry is also checked against the generator: one verified packet per frame, one row per raw data frame and two per status
+frame, and raw data values equal to the samples ecg4_gen -S writes for the same seed. A mismatch fails the run.
+
+    gcc -O2 -I../library -I../library/HAL -I. -o ecg4_parser_bench ecg4_parser_bench.c ecg4_synth.c ecg4_frame.c \
+        mikrosdk_linux.c ../library/__ecg4_parser.c ../library/__ecg4_driver.c -lm
+
+    ecg4_parser_bench [-m megabytes] [-r repeats] [-s seed] [-o output]
+
+Defaults: 16 MB per stream, best of 5 runs, seed 1, JSON to stdout.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "__ecg4_driver.h"
+#include "__ecg4_parser.h"
+#include "mikrosdk_linux.h"
+#include "ecg4_frame.h"
+#include "ecg4_synth.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define BENCH_ENTRIES           3
+#define BENCH_STREAMS           4
+#define BENCH_COUNTERS          3
+#define BENCH_RAW_DATA_CODE     0x80
+#define BENCH_STATUS_ROWS       2
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static const char *bench_entry_name[ BENCH_ENTRIES ] = { "isr", "byte", "block" };
+static const char *bench_stream_name[ BENCH_STREAMS ] = { "clean", "collide", "noisy", "allcodes" };
+static const char *bench_counter_name[ BENCH_COUNTERS ] = { "instructions", "cycles", "branch_misses" };
+static const uint64_t bench_counter_config[ BENCH_COUNTERS ] =
+{
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static int bench_counter_fd[ BENCH_COUNTERS ];
+
+static uint64_t bench_rows;
+static uint64_t bench_op_sum;
+static uint64_t bench_raw_rows;
+static uint64_t bench_raw_bad;
+static const int16_t *bench_truth_samples;
+static uint64_t bench_truth_n;
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    double   seconds;
+    uint64_t packets;
+    uint64_t errors;
+    uint64_t rows;
+    uint64_t op_sum;
+    int64_t  counter[ BENCH_COUNTERS ];
+
+}T_bench_run;
+
+typedef struct
+{
+    uint64_t packets;           /**< Frames generated */
+    uint64_t rows;
+    uint64_t n_samples;
+    int16_t  *samples;          /**< Samples of the raw data frames, as written by ecg4_gen -S */
+
+}T_bench_truth;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void bench_usage( void )
+{
+    fprintf( stderr, "usage: ecg4_parser_bench [-m megabytes] [-r repeats] [-s seed] [-o output]\n" );
+    exit( 2 );
+}
+
+static double bench_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t bench_rand( uint64_t *state )
+{
+    uint64_t z;
+
+    *state += 0x9E3779B97F4A7C15ull;
+    z = *state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+static void bench_handler( uint8_t *op_code, uint8_t *row_size, uint8_t *rx_buff, uint8_t *row_cnt )
+{
+    bench_rows++;
+    bench_op_sum += *op_code + *row_size + rx_buff[ 0 ] + *row_cnt;
+}
+
+static void bench_truth_handler( uint8_t *op_code, uint8_t *row_size, uint8_t *rx_buff, uint8_t *row_cnt )
+{
+    int16_t sample;
+
+    (void)row_cnt;
+    bench_rows++;
+
+    if ((*op_code != BENCH_RAW_DATA_CODE) || (*row_size != 2))
+    {
+        return;
+    }
+
+    sample = (int16_t)(((uint16_t)rx_buff[ 0 ] << 8) | rx_buff[ 1 ]);
+
+    if ((bench_raw_rows >= bench_truth_n) || (sample != bench_truth_samples[ bench_raw_rows ]))
+    {
+        bench_raw_bad++;
+    }
+
+    bench_raw_rows++;
+}
+
+static void bench_counters_open( void )
+{
+    struct perf_event_attr attr;
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < BENCH_COUNTERS; cnt++)
+    {
+        memset( &attr, 0, sizeof( attr ) );
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof( attr );
+        attr.config = bench_counter_config[ cnt ];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        bench_counter_fd[ cnt ] = (int)syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+    }
+}
+
+static void bench_counters_start( void )
+{
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < BENCH_COUNTERS; cnt++)
+    {
+        if (bench_counter_fd[ cnt ] >= 0)
+        {
+            ioctl( bench_counter_fd[ cnt ], PERF_EVENT_IOC_RESET, 0 );
+            ioctl( bench_counter_fd[ cnt ], PERF_EVENT_IOC_ENABLE, 0 );
+        }
+    }
+}
+
+static void bench_counters_stop( T_bench_run *run )
+{
+    uint64_t value;
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < BENCH_COUNTERS; cnt++)
+    {
+        run->counter[ cnt ] = -1;
+
+        if (bench_counter_fd[ cnt ] < 0)
+        {
+            continue;
+        }
+
+        ioctl( bench_counter_fd[ cnt ], PERF_EVENT_IOC_DISABLE, 0 );
+
+        if (read( bench_counter_fd[ cnt ], &value, sizeof( value ) ) == sizeof( value ))
+        {
+            run->counter[ cnt ] = (int64_t)value;
+        }
+    }
+}
+
+static size_t bench_stream_synth( uint8_t *buf, size_t size, uint64_t seed, uint8_t stream, T_bench_truth *truth )
+{
+    static T_ecg4_synth syn;
+    T_ecg4_synth_cfg cfg;
+    uint8_t frames[ ECG4_SYNTH_FRAMES_MAX ];
+    uint16_t len;
+    size_t pos;
+    uint64_t cnt;
+
+    ecg4_synth_default( &cfg, seed );
+
+    if (stream == 1)
+    {
+        cfg.collide_rate = 0.05;
+    }
+    else if (stream == 2)
+    {
+        cfg.noise = 40;
+        cfg.mains = 200;
+        cfg.leadoff_rate = 60;
+        cfg.drop_rate = 1e-3;
+        cfg.flip_rate = 1e-3;
+        cfg.collide_rate = 0.05;
+    }
+
+    ecg4_synth_init( &syn, &cfg );
+    pos = 0;
+    truth->packets = 0;
+    truth->rows = 0;
+
+    while (pos + ECG4_SYNTH_FRAMES_MAX <= size)
+    {
+        len = ecg4_synth_frames( &syn, frames );
+        memcpy( &buf[ pos ], frames, len );
+        pos += len;
+        truth->packets++;
+        truth->rows++;
+
+        if (len != ECG4_FRAME_RAW_LEN)
+        {
+            truth->packets++;
+            truth->rows += BENCH_STATUS_ROWS;
+        }
+    }
+
+    // the samples alone, from a fresh generator with the same configuration
+    truth->n_samples = syn.n;
+    ecg4_synth_init( &syn, &cfg );
+
+    for (cnt = 0; cnt < truth->n_samples; cnt++)
+    {
+        truth->samples[ cnt ] = ecg4_synth_sample( &syn );
+    }
+
+    return pos;
+}
+
+static size_t bench_stream_allcodes( uint8_t *buf, size_t size, uint64_t seed )
+{
+    uint8_t payload[ 32 ];
+    uint64_t rng;
+    uint64_t r;
+    uint8_t len;
+    uint8_t cnt;
+    size_t pos;
+
+    rng = seed;
+    pos = 0;
+
+    while (pos + ECG4_FRAME_MAX <= size)
+    {
+        r = bench_rand( &rng );
+        len = 0;
+
+        switch ((r >> 8) % 8)
+        {
+            case 0:
+            case 1:
+                pos += ecg4_frame_raw( &buf[ pos ], (int16_t)(r >> 16) );
+                continue;
+            case 2:
+                payload[ len++ ] = 0x02;
+                payload[ len++ ] = (r & 0x10000) ? 200 : 0;
+                break;
+            case 3:
+                payload[ len++ ] = 0x03;
+                payload[ len++ ] = (uint8_t)(40 + (r >> 16) % 160);
+                break;
+            case 4:
+                payload[ len++ ] = 0x02;
+                payload[ len++ ] = 200;
+                payload[ len++ ] = 0x03;
+                payload[ len++ ] = (uint8_t)(40 + (r >> 16) % 160);
+                payload[ len++ ] = 0x80;
+                payload[ len++ ] = 2;
+                payload[ len++ ] = (uint8_t)(r >> 24);
+                payload[ len++ ] = (uint8_t)(r >> 32);
+                break;
+            case 5:
+                payload[ len++ ] = 0x55;
+                payload[ len++ ] = 0x02;
+                payload[ len++ ] = 200;
+                break;
+            case 6:
+                payload[ len++ ] = 0x80;
+                payload[ len++ ] = 16;
+
+                for (cnt = 0; cnt < 16; cnt++)
+                {
+                    payload[ len++ ] = (uint8_t)(r >> (cnt * 3 + 16));
+                }
+                break;
+            default:
+                if (r & 0x10000)
+                {
+                    payload[ len++ ] = 0x04;
+                    payload[ len++ ] = (uint8_t)(r >> 24);
+                    break;
+                }
+
+                len = ecg4_frame_raw( &buf[ pos ], (int16_t)(r >> 24) );
+                buf[ pos + len - 1 ] ^= 0x01;
+                pos += len;
+                continue;
+        }
+
+        pos += ecg4_frame_build( &buf[ pos ], payload, len );
+    }
+
+    return pos;
+}
+
+static void bench_entry_isr( const uint8_t *buf, size_t size, T_bench_run *run )
+{
+    T_mikrobus_uart *uart;
+    size_t pos;
+    uint16_t len;
+
+    uart = &_MIKROBUS1_UART;
+
+    for (pos = 0; pos < size; pos += len)
+    {
+        len = (size - pos < sizeof( uart->rx_buf )) ? (uint16_t)(size - pos) : sizeof( uart->rx_buf );
+        memcpy( uart->rx_buf, &buf[ pos ], len );
+        uart->rx_len = len;
+        uart->rx_pos = 0;
+
+        while (uart->rx_pos != uart->rx_len)
+        {
+            ecg4_uart_isr();
+        }
+    }
+
+    run->packets = 0;
+    run->errors = 0;
+}
+
+static void bench_entry_byte( T_ecg4_parser *prs, const uint8_t *buf, size_t size, T_bench_run *run )
+{
+    size_t pos;
+    uint8_t res;
+
+    for (pos = 0; pos < size; pos++)
+    {
+        res = ecg4_parser_byte( prs, buf[ pos ] );
+
+        if (res & _ECG4_PARSER_PACKET)
+        {
+            run->packets++;
+        }
+        else if (res & _ECG4_PARSER_ERROR)
+        {
+            run->errors++;
+        }
+    }
+}
+
+static void bench_entry_block( T_ecg4_parser *prs, const uint8_t *buf, size_t size, T_bench_run *run )
+{
+    size_t pos;
+    uint16_t len;
+    uint16_t used;
+    uint8_t res;
+
+    for (pos = 0; pos < size; pos += used)
+    {
+        len = (size - pos < 0xFFFF) ? (uint16_t)(size - pos) : 0xFFFF;
+        res = ecg4_parser_block( prs, &buf[ pos ], len, &used );
+
+        if (res & _ECG4_PARSER_PACKET)
+        {
+            run->packets++;
+        }
+        else if (res & _ECG4_PARSER_ERROR)
+        {
+            run->errors++;
+        }
+    }
+}
+
+static void bench_run( uint8_t entry, const uint8_t *buf, size_t size, T_bench_run *run, T_ecg4_parser_hdl hdl )
+{
+    static T_ecg4_parser prs;
+    double t0;
+
+    ecg4_parser_init( &prs, hdl );
+    ecg4_uartDriverInit( (T_ECG4_P)&_MIKROBUS1_GPIO, (T_ECG4_P)&_MIKROBUS1_UART );
+    ecg4_response_handler_set( hdl );
+    bench_rows = 0;
+    bench_op_sum = 0;
+    run->packets = 0;
+    run->errors = 0;
+
+    bench_counters_start();
+    t0 = bench_now();
+
+    switch (entry)
+    {
+        case 0: bench_entry_isr( buf, size, run ); break;
+        case 1: bench_entry_byte( &prs, buf, size, run ); break;
+        default: bench_entry_block( &prs, buf, size, run ); break;
+    }
+
+    run->seconds = bench_now() - t0;
+    bench_counters_stop( run );
+    run->rows = bench_rows;
+    run->op_sum = bench_op_sum;
+}
+
+static void bench_json_counter( FILE *out, const char *name, int64_t value, size_t size )
+{
+    if (value < 0)
+    {
+        fprintf( out, ", \"%s_per_byte\": null", name );
+    }
+    else
+    {
+        fprintf( out, ", \"%s_per_byte\": %.3f", name, (double)value / size );
+    }
+}
+
+static int bench_verify( uint8_t entry, uint8_t stream, const uint8_t *buf, size_t size, const T_bench_truth *truth )
+{
+    T_bench_run run;
+
+    bench_truth_samples = truth->samples;
+    bench_truth_n = truth->n_samples;
+    bench_raw_rows = 0;
+    bench_raw_bad = 0;
+    bench_run( entry, buf, size, &run, &bench_truth_handler );
+
+    // the driver keeps its packet count to itself, its rows are checked
+    if (entry == 0)
+    {
+        run.packets = truth->packets;
+    }
+
+    if ((run.rows != truth->rows) || (run.packets != truth->packets) || (run.errors != 0) ||
+        (bench_raw_rows != truth->n_samples) || (bench_raw_bad != 0))
+    {
+        fprintf( stderr, "%s/%s: %llu rows, %llu packets, %llu errors, %llu samples (%llu wrong), "
+                         "generated: %llu rows, %llu packets, %llu samples\n",
+                 bench_entry_name[ entry ], bench_stream_name[ stream ], (unsigned long long)run.rows, (unsigned long long)run.packets,
+                 (unsigned long long)run.errors, (unsigned long long)bench_raw_rows,
+                 (unsigned long long)bench_raw_bad, (unsigned long long)truth->rows,
+                 (unsigned long long)truth->packets, (unsigned long long)truth->n_samples );
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static void bench_virtual_idle( void )
+{
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    T_bench_run run;
+    T_bench_run best;
+    T_bench_run ref;
+    T_bench_truth truth;
+    const char *out_path;
+    FILE *out;
+    uint8_t *buf;
+    uint64_t seed;
+    size_t size;
+    size_t len;
+    double megabytes;
+    int repeats;
+    int rep;
+    int failed;
+    int first;
+    int opt;
+    uint8_t stream;
+    uint8_t entry;
+    uint8_t cnt;
+
+    megabytes = 16;
+    repeats = 5;
+    seed = 1;
+    out_path = NULL;
+
+    while ((opt = getopt( argc, argv, "m:r:s:o:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'm': megabytes = atof( optarg ); break;
+            case 'r': repeats = atoi( optarg ); break;
+            case 's': seed = strtoull( optarg, NULL, 0 ); break;
+            case 'o': out_path = optarg; break;
+            default: bench_usage();
+        }
+    }
+
+    size = (size_t)(megabytes * 1024 * 1024);
+
+    if ((size < ECG4_FRAME_MAX) || (repeats < 1))
+    {
+        bench_usage();
+    }
+
+    buf = malloc( size );
+    truth.samples = malloc( (size / ECG4_FRAME_RAW_LEN + 1) * sizeof( int16_t ) );
+    out = (out_path != NULL) ? fopen( out_path, "w" ) : stdout;
+
+    if ((buf == NULL) || (truth.samples == NULL) || (out == NULL))
+    {
+        perror( (out == NULL) ? out_path : "malloc" );
+        return 1;
+    }
+
+    _MIKROBUS1_UART.rx_idle = &bench_virtual_idle;
+    bench_counters_open();
+    failed = 0;
+    first = 1;
+
+    fprintf( out, "{\n  \"bench\": \"ecg4_parser\",\n  \"megabytes\": %.2f,\n  \"repeats\": %d,\n"
+                  "  \"seed\": %llu,\n  \"counters\": {", megabytes, repeats, (unsigned long long)seed );
+
+    for (cnt = 0; cnt < BENCH_COUNTERS; cnt++)
+    {
+        fprintf( out, "%s\"%s\": %s", (cnt == 0) ? " " : ", ", bench_counter_name[ cnt ],
+                 (bench_counter_fd[ cnt ] >= 0) ? "true" : "false" );
+    }
+
+    fprintf( out, " },\n  \"results\": [" );
+
+    for (stream = 0; stream < BENCH_STREAMS; stream++)
+    {
+        if (stream == 3)
+        {
+            len = bench_stream_allcodes( buf, size, seed );
+        }
+        else
+        {
+            len = bench_stream_synth( buf, size, seed, stream, &truth );
+        }
+
+        // the streams without corruption, collide holds 0x55 values where an extended code byte may not be
+        for (entry = 0; (stream < 2) && (entry < BENCH_ENTRIES); entry++)
+        {
+            failed |= bench_verify( entry, stream, buf, len, &truth );
+        }
+
+        bench_run( 1, buf, len, &ref, &bench_handler );
+
+        for (entry = 0; entry < BENCH_ENTRIES; entry++)
+        {
+            for (rep = 0; rep < repeats; rep++)
+            {
+                bench_run( entry, buf, len, &run, &bench_handler );
+
+                if ((rep == 0) || (run.seconds < best.seconds))
+                {
+                    best = run;
+                }
+            }
+
+            if (entry == 0)
+            {
+                // the driver keeps its counts to itself, rows tell whether it parsed the same packets
+                best.packets = ref.packets;
+                best.errors = ref.errors;
+            }
+
+            if ((best.rows != ref.rows) || (best.op_sum != ref.op_sum) || (best.packets != ref.packets) ||
+                (best.errors != ref.errors))
+            {
+                fprintf( stderr, "%s/%s: %llu rows, %llu packets, %llu errors, byte entry: %llu, %llu, %llu\n",
+                         bench_entry_name[ entry ], bench_stream_name[ stream ],
+                         (unsigned long long)best.rows, (unsigned long long)best.packets,
+                         (unsigned long long)best.errors, (unsigned long long)ref.rows,
+                         (unsigned long long)ref.packets, (unsigned long long)ref.errors );
+                failed = 1;
+            }
+
+            fprintf( out, "%s\n    { \"entry\": \"%s\", \"stream\": \"%s\", \"bytes\": %zu, \"packets\": %llu, "
+                          "\"errors\": %llu, \"rows\": %llu,\n      \"ns_per_byte\": %.3f, \"mbytes_per_s\": %.2f, "
+                          "\"packets_per_s\": %.0f",
+                     first ? "" : ",", bench_entry_name[ entry ], bench_stream_name[ stream ], len,
+                     (unsigned long long)best.packets, (unsigned long long)best.errors,
+                     (unsigned long long)best.rows, best.seconds * 1e9 / len, len / best.seconds / 1e6,
+                     best.packets / best.seconds );
+
+            for (cnt = 0; cnt < BENCH_COUNTERS; cnt++)
+            {
+                bench_json_counter( out, bench_counter_name[ cnt ], best.counter[ cnt ], len );
+            }
+
+            fprintf( out, " }" );
+            first = 0;
+        }
+    }
+
+    fprintf( out, "\n  ],\n  \"ok\": %s\n}\n", failed ? "false" : "true" );
+
+    if (out != stdout)
+    {
+        fclose( out );
+    }
+
+    free( truth.samples );
+    free( buf );
+
+    return failed;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_parser_bench.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,447 @@
+/*
+    ecg4_rec_bench.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_rec_bench.c
+@brief    ECG_4 Recorder Benchmark
+
+Records synthetic ECG with __ecg4_recorder on a file backed NOR flash image and reports the write
+throughput, the write amplification and the recovery scan time, then reads the log back and verifies it.
+With -c two power cuts are injected while recording, one anywhere in a page and one inside the page header
+(magic programmed, sequence number erased), at points drawn from the -s seed. After each cut the recovery is
+verified, then the log is recorded until it wraps over the interrupted page and is verified again.
+
+    gcc -O2 -I../library -o ecg4_rec_bench ecg4_rec_bench.c ecg4_blockdev_file.c \
+        ../library/__ecg4_recorder.c ../library/__ecg4_rice.c ../library/__ecg4_crc.c -lm
+
+    ecg4_rec_bench [-f image] [-m device_kb] [-p page_size] [-e erase_pages] [-b block_len]
+                   [-H hours] [-F flush_s] [-c] [-s seed]
+
+Defaults: 8192 kB SPI NOR flash, 256 byte pages, 4 kB erase blocks, 64 sample blocks, 1 hour, no flush,
+seed 1.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "ecg4_blockdev_file.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define BENCH_FS                512
+#define BENCH_PI                3.14159265358979323846
+#define BENCH_QUALITY_CODE      0x02
+#define BENCH_HEART_RATE_CODE   0x03
+#define BENCH_QUALITY           200
+#define BENCH_HEART_RATE        75
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    const char *path;
+    uint32_t device_kb;
+    uint16_t page_size;
+    uint16_t erase_pages;
+    uint8_t  block_len;
+    double   hours;
+    uint32_t flush_s;
+    int      crash;
+    unsigned seed;
+
+}T_bench_cfg;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static int16_t bench_sample( uint32_t n )
+{
+    double t;
+    double beat;
+    uint32_t h;
+
+    t = (double)n / BENCH_FS;
+    beat = fmod( t, 0.8 ) - 0.4;
+    h = n * 2654435761u;
+    h ^= h >> 15;
+
+    return (int16_t)(3000.0 * exp( -beat * beat / (2 * 0.012 * 0.012) ) +
+                     800.0 * exp( -(beat - 0.25) * (beat - 0.25) / (2 * 0.05 * 0.05) ) +
+                     300.0 * sin( 2 * BENCH_PI * 0.3 * t ) + (double)(h % 11) - 5.0);
+}
+
+static double bench_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint8_t bench_record( T_ecg4_recorder *rec, const T_bench_cfg *cfg, uint32_t n_samples )
+{
+    uint32_t cnt;
+    uint32_t n;
+    uint8_t err;
+
+    err = _ECG4_REC_OK;
+
+    for (cnt = 0; (cnt < n_samples) && (err == _ECG4_REC_OK); cnt++)
+    {
+        n = rec->n;
+
+        if (n % BENCH_FS == 0)
+        {
+            err |= ecg4_rec_event( rec, BENCH_QUALITY_CODE, BENCH_QUALITY );
+            err |= ecg4_rec_event( rec, BENCH_HEART_RATE_CODE, BENCH_HEART_RATE );
+        }
+
+        err |= ecg4_rec_push( rec, bench_sample( n ) );
+
+        if ((cfg->flush_s != 0) && (rec->n % (cfg->flush_s * BENCH_FS) == 0))
+        {
+            err |= ecg4_rec_flush( rec );
+        }
+    }
+
+    return err;
+}
+
+static int bench_verify( T_ecg4_recorder *rec, uint32_t *first_n )
+{
+    static T_ecg4_rec_iter it;
+    static T_ecg4_rec_item item;
+    uint32_t next_n;
+    uint32_t blocks;
+    uint32_t events;
+    uint32_t gaps;
+    uint8_t cnt;
+    int errors;
+
+    ecg4_rec_iter_init( rec, &it );
+    next_n = 0;
+    blocks = 0;
+    events = 0;
+    gaps = 0;
+    errors = 0;
+    *first_n = 0;
+
+    while (ecg4_rec_iter_next( rec, &it, &item ))
+    {
+        if (item.type == _ECG4_REC_ITEM_EVENT)
+        {
+            events++;
+
+            if ((item.n % BENCH_FS != 0) ||
+                (((item.code != BENCH_QUALITY_CODE) || (item.value != BENCH_QUALITY)) &&
+                 ((item.code != BENCH_HEART_RATE_CODE) || (item.value != BENCH_HEART_RATE))))
+            {
+                errors++;
+            }
+
+            continue;
+        }
+
+        if (blocks == 0)
+        {
+            *first_n = item.n;
+        }
+        else if (item.n != next_n)
+        {
+            gaps++;
+        }
+
+        for (cnt = 0; cnt < item.n_samples; cnt++)
+        {
+            if (item.samples[ cnt ] != bench_sample( item.n + cnt ))
+            {
+                errors++;
+            }
+        }
+
+        next_n = item.n + item.n_samples;
+        blocks++;
+    }
+
+    printf( "read back     : %u blocks, %u events, samples %u - %u, %u gaps, %d errors\n",
+            blocks, events, *first_n, next_n, gaps, errors );
+
+    // the sample index continues over a power cut, a gap is a lost or misplaced page
+    return errors + (int)gaps;
+}
+
+static int bench_mount( T_ecg4_recorder *rec, T_ecg4_bdfile *bdf, T_ecg4_blockdev *dev, const T_bench_cfg *cfg )
+{
+    T_ecg4_rec_stats stats;
+    double t0;
+    double t1;
+    uint8_t err;
+
+    if (ecg4_bdfile_open( bdf, dev, cfg->path, cfg->page_size, cfg->erase_pages,
+                          cfg->device_kb * 1024 / cfg->page_size ) != 0)
+    {
+        perror( cfg->path );
+        return -1;
+    }
+
+    t0 = bench_now();
+    err = ecg4_rec_init( rec, dev, cfg->block_len );
+    t1 = bench_now();
+
+    if (err != _ECG4_REC_OK)
+    {
+        fprintf( stderr, "mount failed: %u\n", err );
+        return -1;
+    }
+
+    ecg4_rec_stats_get( rec, &stats );
+    printf( "recovery scan : %u pages, %u bad, %.3f ms, %llu bytes read, resumes at sample %u\n",
+            stats.scan_pages, stats.bad_pages, (t1 - t0) * 1e3, (unsigned long long)bdf->read_bytes, rec->n );
+
+    return 0;
+}
+
+static int bench_crash( T_ecg4_recorder *rec, T_ecg4_bdfile *bdf, T_ecg4_blockdev *dev, const T_bench_cfg *cfg,
+                        uint32_t cut_after, uint16_t cut_bytes )
+{
+    T_ecg4_rec_stats stats;
+    uint32_t start;
+    uint32_t pushed;
+    uint32_t first_n;
+    uint8_t err;
+    int errors;
+
+    // power cut while recording one more minute
+    bdf->cut_after = cut_after;
+    bdf->cut_bytes = cut_bytes;
+    start = rec->n;
+    bench_record( rec, cfg, 60 * BENCH_FS );
+    pushed = rec->n - start;
+    printf( "power cut     : at page %u of the session, %u of %u bytes programmed, %u samples pushed\n",
+            cut_after, cut_bytes, cfg->page_size, pushed );
+    ecg4_bdfile_close( bdf );
+
+    if (bench_mount( rec, bdf, dev, cfg ) != 0)
+    {
+        return -1;
+    }
+
+    errors = bench_verify( rec, &first_n );
+    printf( "lost          : %u samples (RAM page buffer and the interrupted page)\n", start + pushed - rec->n );
+
+    // the log wraps over the interrupted page, the next recovery scan must still find its end
+    start = rec->n;
+
+    do
+    {
+        err = bench_record( rec, cfg, BENCH_FS );
+        ecg4_rec_stats_get( rec, &stats );
+    }
+    while ((err == _ECG4_REC_OK) && (stats.pages <= dev->n_pages));
+
+    if ((err != _ECG4_REC_OK) || (ecg4_rec_flush( rec ) != _ECG4_REC_OK))
+    {
+        fprintf( stderr, "recording failed\n" );
+        return -1;
+    }
+
+    ecg4_rec_stats_get( rec, &stats );
+    pushed = rec->n - start;
+    printf( "wrap          : %u samples, %u pages after the cut\n", pushed, stats.pages );
+    ecg4_bdfile_close( bdf );
+
+    if (bench_mount( rec, bdf, dev, cfg ) != 0)
+    {
+        return -1;
+    }
+
+    errors += bench_verify( rec, &first_n );
+
+    if (rec->n != start + pushed)
+    {
+        printf( "recovered sample index %u, expected %u\n", rec->n, start + pushed );
+        errors++;
+    }
+
+    return errors;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    static T_ecg4_recorder rec;
+    T_ecg4_bdfile bdf;
+    T_ecg4_blockdev dev;
+    T_ecg4_rec_stats stats;
+    T_bench_cfg cfg;
+    uint32_t n_samples;
+    uint32_t first_n;
+    uint32_t cut_range;
+    uint16_t cut_bytes;
+    uint8_t cut;
+    double t0;
+    double t1;
+    double prog_bytes;
+    int opt;
+    int errors;
+    int res;
+
+    cfg.path = "ecg4_rec.img";
+    cfg.device_kb = 8192;
+    cfg.page_size = 256;
+    cfg.erase_pages = 16;
+    cfg.block_len = 64;
+    cfg.hours = 1.0;
+    cfg.flush_s = 0;
+    cfg.crash = 0;
+    cfg.seed = 1;
+
+    while ((opt = getopt( argc, argv, "f:m:p:e:b:H:F:cs:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'f': cfg.path = optarg; break;
+            case 'm': cfg.device_kb = atoi( optarg ); break;
+            case 'p': cfg.page_size = atoi( optarg ); break;
+            case 'e': cfg.erase_pages = atoi( optarg ); break;
+            case 'b': cfg.block_len = atoi( optarg ); break;
+            case 'H': cfg.hours = atof( optarg ); break;
+            case 'F': cfg.flush_s = atoi( optarg ); break;
+            case 'c': cfg.crash = 1; break;
+            case 's': cfg.seed = (unsigned)strtoul( optarg, NULL, 0 ); break;
+            default:
+                fprintf( stderr, "usage: %s [-f image] [-m device_kb] [-p page_size] [-e erase_pages] "
+                                 "[-b block_len] [-H hours] [-F flush_s] [-c] [-s seed]\n", argv[ 0 ] );
+                return 2;
+        }
+    }
+
+    unlink( cfg.path );
+    n_samples = (uint32_t)(cfg.hours * 3600 * BENCH_FS);
+
+    // recording
+    if (bench_mount( &rec, &bdf, &dev, &cfg ) != 0)
+    {
+        return 1;
+    }
+
+    t0 = bench_now();
+
+    if ((bench_record( &rec, &cfg, n_samples ) != _ECG4_REC_OK) || (ecg4_rec_flush( &rec ) != _ECG4_REC_OK))
+    {
+        fprintf( stderr, "recording failed\n" );
+        return 1;
+    }
+
+    t1 = bench_now();
+    ecg4_rec_stats_get( &rec, &stats );
+    prog_bytes = (double)stats.pages * cfg.page_size;
+
+    printf( "recorded      : %u samples (%.2f h), %u events, %u pages, %u erases, %u flushes\n",
+            stats.samples, stats.samples / (3600.0 * BENCH_FS), stats.events, stats.pages, stats.erases,
+            stats.flushes );
+    printf( "throughput    : %.0f samples/s (%.0fx real time), %.2f MB/s programmed\n",
+            stats.samples / (t1 - t0), stats.samples / (t1 - t0) / BENCH_FS, prog_bytes / (t1 - t0) / 1e6 );
+    printf( "compression   : %.2fx (raw samples / record bytes)\n", 2.0 * stats.samples / stats.record_bytes );
+    printf( "amplification : %.3f programmed / record bytes, %.3f programmed / raw sample bytes\n",
+            prog_bytes / stats.record_bytes, prog_bytes / (2.0 * stats.samples) );
+
+    ecg4_bdfile_close( &bdf );
+
+    // recovery
+    if (bench_mount( &rec, &bdf, &dev, &cfg ) != 0)
+    {
+        return 1;
+    }
+
+    errors = bench_verify( &rec, &first_n );
+
+    if (rec.n != n_samples)
+    {
+        printf( "recovered sample index %u, expected %u\n", rec.n, n_samples );
+        errors++;
+    }
+
+    if (!cfg.crash)
+    {
+        ecg4_bdfile_close( &bdf );
+        return errors != 0;
+    }
+
+    // a cut anywhere in a page, then one after the magic, the sequence number reads 0xFFFFFFFF, within the next
+    // minute of recording
+    srand( cfg.seed );
+    cut_range = (uint32_t)(stats.pages / (cfg.hours * 60) + 1);
+    printf( "seed          : %u\n", cfg.seed );
+
+    for (cut = 0; cut < 2; cut++)
+    {
+        cut_bytes = (cut == 0) ? rand() % cfg.page_size : 2;
+        res = bench_crash( &rec, &bdf, &dev, &cfg, 1 + rand() % cut_range, cut_bytes );
+
+        if (res < 0)
+        {
+            return 1;
+        }
+
+        errors += res;
+    }
+
+    ecg4_bdfile_close( &bdf );
+
+    return errors != 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_rec_bench.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
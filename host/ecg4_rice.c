@@ -0,0 +1,222 @@
+/*
+    ecg4_rice.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_rice.c
+@brief    ECG_4 Raw Data Compression host tool
+
+Encodes raw data samples (one decimal sample per line) into concatenated __ecg4_rice blocks, or decodes
+a block stream received from the device back to samples.
+
+    gcc -O2 -I../library -o ecg4_rice ecg4_rice.c ../library/__ecg4_rice.c
+
+    ecg4_rice -e [block_size] < samples.txt > blocks.bin
+    ecg4_rice -d < blocks.bin > samples.txt
+
+The compression ratio is reported on stderr.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "__ecg4_rice.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define RICE_BLOCK_DEF          64
+#define RICE_IN_LEN             4096
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static int rice_encode_stream( int block_size )
+{
+    int16_t samples[ 255 ];
+    uint8_t block[ ECG4_RICE_MAX_BYTES( 255 ) ];
+    long value;
+    long n_total;
+    long bytes;
+    uint16_t len;
+    int n;
+
+    n = 0;
+    n_total = 0;
+    bytes = 0;
+
+    for (;;)
+    {
+        if (scanf( "%ld", &value ) == 1)
+        {
+            samples[ n++ ] = (int16_t)value;
+            n_total++;
+
+            if (n < block_size)
+            {
+                continue;
+            }
+        }
+
+        if (n == 0)
+        {
+            break;
+        }
+
+        len = ecg4_rice_encode( samples, (uint8_t)n, block );
+        fwrite( block, 1, len, stdout );
+        bytes += len;
+
+        if (n < block_size)
+        {
+            break;
+        }
+
+        n = 0;
+    }
+
+    if (bytes != 0)
+    {
+        fprintf( stderr, "%ld samples, %ld bytes, ratio %.2f\n", n_total, bytes, 2.0 * n_total / bytes );
+    }
+
+    return 0;
+}
+
+static int rice_decode_stream( void )
+{
+    static uint8_t in[ RICE_IN_LEN ];
+    int16_t samples[ 255 ];
+    size_t in_len;
+    size_t rd;
+    size_t pos;
+    long n_total;
+    long bytes;
+    uint16_t used;
+    uint8_t n;
+    uint8_t cnt;
+
+    in_len = 0;
+    n_total = 0;
+    bytes = 0;
+
+    for (;;)
+    {
+        rd = fread( in + in_len, 1, RICE_IN_LEN - in_len, stdin );
+        in_len += rd;
+        pos = 0;
+
+        while ((n = ecg4_rice_decode( in + pos, (uint16_t)(in_len - pos), samples, &used )) != 0)
+        {
+            for (cnt = 0; cnt < n; cnt++)
+            {
+                printf( "%d\n", samples[ cnt ] );
+            }
+
+            pos += used;
+            n_total += n;
+            bytes += used;
+        }
+
+        memmove( in, in + pos, in_len - pos );
+        in_len -= pos;
+
+        if (rd == 0)
+        {
+            break;
+        }
+    }
+
+    if (in_len != 0)
+    {
+        fprintf( stderr, "%lu trailing bytes could not be decoded\n", (unsigned long)in_len );
+    }
+
+    if (bytes != 0)
+    {
+        fprintf( stderr, "%ld samples, %ld bytes, ratio %.2f\n", n_total, bytes, 2.0 * n_total / bytes );
+    }
+
+    return in_len != 0;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    int block_size;
+
+    if ((argc >= 2) && (strcmp( argv[ 1 ], "-e" ) == 0))
+    {
+        block_size = RICE_BLOCK_DEF;
+
+        if (argc >= 3)
+        {
+            block_size = atoi( argv[ 2 ] );
+        }
+
+        if ((block_size < 1) || (block_size > 255))
+        {
+            fprintf( stderr, "block size must be 1 - 255\n" );
+            return 2;
+        }
+
+        return rice_encode_stream( block_size );
+    }
+
+    if ((argc >= 2) && (strcmp( argv[ 1 ], "-d" ) == 0))
+    {
+        return rice_decode_stream();
+    }
+
+    fprintf( stderr, "usage: %s -e [block_size] < samples.txt > blocks.bin\n"
+                     "       %s -d < blocks.bin > samples.txt\n", argv[ 0 ], argv[ 0 ] );
+
+    return 2;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_rice.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
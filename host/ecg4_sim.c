@@ -0,0 +1,596 @@
+/*
+    ecg4_sim.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_sim.c
+@brief    ECG_4 Capacity Simulator
+
+Discrete-event simulator which tells, before flashing, whether the uart interrupt routine and applicationTask()
+keep up with the BMD101 stream. Click_ECG_4_LINUX.c runs unchanged (its main renamed to ecg4_app_main) on
+the mikroSDK stubs in virtual time:
+
+- the BMD101 stream (512 raw data frames and one status frame per second) arrives byte by byte at the baud
+  rate into an rx FIFO of the given depth, a byte arriving into a full FIFO is an overrun,
+- every byte runs the rx interrupt routine (ecg4_uart_isr), which costs the given time and preempts the
+  application, ecg4_tick runs every 1 ms,
+- the application is charged the given cost for every delivered packet, the delays and Sound_Play for their
+  duration and the log writes for their length at the log baud rate,
+- with -c, processResponse, plotData and logData are charged their own cost on every call, on top of the log
+  writes they make. The calls are seen through -finstrument-functions, so the application object is built with
+  it; without it the hook costs are reported as not applied,
+- the core idles in ecg4_wait_for_data until the next byte.
+
+The report gives the sent, delivered and lost packets, the overruns, the deepest FIFO, the longest stretch
+without idling and the headroom (idle share of the core). The log of the application goes to -o (default
+/dev/null). The stream starts when the application sets its rx interrupt.
+
+    gcc -O2 -c -finstrument-functions -Dmain=ecg4_app_main -I../example/c/LINUX -I../library -I../library/HAL -I. \
+        -o ecg4_sim_app.o ../example/c/LINUX/Click_ECG_4_LINUX.c
+    gcc -O2 -I../library -I../library/HAL -I. -o ecg4_sim ecg4_sim.c ecg4_synth.c ecg4_frame.c mikrosdk_linux.c \
+        ecg4_sim_app.o ../library/__ecg4_driver.c ../library/__ecg4_parser.c ../library/__ecg4_decim.c \
+        ../library/__ecg4_logq.c ../library/__ecg4_qrs.c ../library/__ecg4_hr.c ../library/__ecg4_leadoff.c \
+        ../library/__ecg4_pipeline.c ../library/__ecg4_filter.c ../library/__ecg4_capture.c ../library/__ecg4_warm.c \
+        ../library/__ecg4_crc.c -lm
+
+    ecg4_sim [-t seconds] [-b baud] [-d fifo_depth] [-i isr_us] [-a app_us] [-c function=us]... [-o log] [-q]
+
+Defaults: 60 s, 57600 baud, 1 byte FIFO, 5 us per interrupt, 0 us per packet, 0 us per hooked function call.
+-q prints one line per run.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "__ecg4_driver.h"
+#include "mikrosdk_linux.h"
+#include "ecg4_frame.h"
+#include "ecg4_synth.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define SIM_FS                  512
+#define SIM_NEVER               0xFFFFFFFFFFFFFFFFull
+#define SIM_TICK_NS             1000000ull
+#define SIM_HOOKS               3
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    double   seconds;
+    uint32_t baud;
+    uint16_t fifo_depth;
+    uint32_t isr_ns;
+    uint32_t app_ns;
+    const char *log_path;
+    int      quiet;
+
+}T_sim_cfg;
+
+typedef struct
+{
+    uint64_t sent;
+    uint64_t delivered;
+    uint64_t overruns;
+    uint16_t fifo_max;
+    uint64_t isr_ns;
+    uint64_t idle_ns;
+    uint64_t busy_max_ns;
+
+}T_sim_stats;
+
+typedef struct
+{
+    const char *name;
+    void       *fn;
+    uint32_t   cost_ns;
+    uint64_t   calls;
+
+}T_sim_hook;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static T_sim_cfg cfg;
+static T_sim_stats stats;
+static FILE *report;
+
+static uint64_t now;
+static uint64_t start;
+static uint64_t end;
+static uint64_t next_tick;
+static uint64_t next_byte;
+static uint64_t byte_ns;
+static uint64_t idle_exit;
+static uint8_t  in_isr;
+static uint64_t charged;
+
+static T_ecg4_synth syn;
+static uint8_t  tx_buf[ ECG4_SYNTH_FRAMES_MAX ];
+static uint16_t tx_len;
+static uint16_t tx_pos;
+static uint16_t tx_ends[ 2 ];
+static uint8_t  tx_frame_idx;
+static uint32_t tx_n;
+
+static T_sim_hook hooks[ SIM_HOOKS ];
+static uint8_t    hooks_seen;
+
+extern int ecg4_app_main();
+extern void processResponse();
+extern void plotData( int16_t plot_data );
+extern void logData( uint8_t code_val, uint8_t data_val );
+
+void __cyg_profile_func_enter( void *fn, void *site ) __attribute__(( no_instrument_function ));
+void __cyg_profile_func_exit( void *fn, void *site ) __attribute__(( no_instrument_function ));
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void sim_report_hooks( void )
+{
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < SIM_HOOKS; cnt++)
+    {
+        if (hooks[ cnt ].cost_ns == 0)
+        {
+            continue;
+        }
+
+        if (cfg.quiet)
+        {
+            fprintf( report, " %s_us %.1f", hooks[ cnt ].name, hooks[ cnt ].cost_ns / 1e3 );
+        }
+        else if (!hooks_seen)
+        {
+            fprintf( report, "hook             %s %.1f us not applied, the application is built without "
+                     "-finstrument-functions\n",
+                     hooks[ cnt ].name, hooks[ cnt ].cost_ns / 1e3 );
+        }
+        else
+        {
+            fprintf( report, "hook             %s %.1f us per call, %llu calls, %.1f %% of the core\n",
+                     hooks[ cnt ].name, hooks[ cnt ].cost_ns / 1e3, (unsigned long long)hooks[ cnt ].calls,
+                     (now > start) ? 100.0 * hooks[ cnt ].calls * hooks[ cnt ].cost_ns / (now - start) : 0 );
+        }
+    }
+}
+
+static void sim_report( void )
+{
+    T_ecg4_duty duty;
+    uint64_t total;
+    double headroom;
+
+    ecg4_duty_get( &duty );
+    stats.delivered = duty.packets;
+    total = now - start;
+    headroom = total ? 100.0 * stats.idle_ns / total : 0;
+
+    if (cfg.quiet)
+    {
+        fprintf( report, "baud %u fifo %u isr_us %.1f app_us %.1f sent %llu delivered %llu lost %llu overruns %llu "
+                 "fifo_max %u busy_max_us %.0f headroom %.1f%%",
+                 cfg.baud, cfg.fifo_depth, cfg.isr_ns / 1e3, cfg.app_ns / 1e3,
+                 (unsigned long long)stats.sent, (unsigned long long)stats.delivered,
+                 (unsigned long long)(stats.sent - stats.delivered), (unsigned long long)stats.overruns,
+                 stats.fifo_max, stats.busy_max_ns / 1e3, headroom );
+        sim_report_hooks();
+        fprintf( report, "\n" );
+
+        return;
+    }
+
+    fprintf( report, "simulated        %.3f s at %u baud, %u byte rx FIFO\n", total / 1e9, cfg.baud, cfg.fifo_depth );
+    fprintf( report, "costs            %.1f us per interrupt, %.1f us per packet\n", cfg.isr_ns / 1e3, cfg.app_ns / 1e3 );
+    sim_report_hooks();
+    fprintf( report, "packets          %llu sent, %llu delivered, %llu lost (%.2f %%)\n",
+             (unsigned long long)stats.sent, (unsigned long long)stats.delivered,
+             (unsigned long long)(stats.sent - stats.delivered),
+             stats.sent ? 100.0 * (stats.sent - stats.delivered) / stats.sent : 0 );
+    fprintf( report, "rx FIFO          %u bytes deepest, %llu overruns\n", stats.fifo_max,
+             (unsigned long long)stats.overruns );
+    fprintf( report, "core             %.1f %% interrupts, %.1f %% application, %.1f %% idle (headroom)\n",
+             total ? 100.0 * stats.isr_ns / total : 0,
+             total ? 100.0 * (total - stats.isr_ns - stats.idle_ns) / total : 0, headroom );
+    fprintf( report, "longest busy     %.0f us without idling (frame period %.0f us)\n",
+             stats.busy_max_ns / 1e3, 1e6 / SIM_FS );
+}
+
+static void sim_tx_load( void )
+{
+    uint64_t due;
+
+    // a raw data frame, followed by a status frame once per second
+    tx_len = ecg4_synth_frames( &syn, tx_buf );
+    tx_ends[ 0 ] = ECG4_FRAME_RAW_LEN;
+    tx_ends[ 1 ] = tx_len;
+
+    tx_pos = 0;
+    tx_frame_idx = 0;
+
+    // frames are due every 1 / 512 s, and follow each other back to back when the link is late
+    due = start + (uint64_t)tx_n * 1000000000ull / SIM_FS;
+    tx_n++;
+
+    if (due > next_byte - byte_ns)
+    {
+        next_byte = due + byte_ns;
+    }
+}
+
+static void sim_isr( void );
+
+static void sim_rx( uint8_t rx_dat )
+{
+    T_mikrobus_uart *uart;
+    uint16_t fill;
+
+    uart = &_MIKROBUS1_UART;
+    fill = uart->rx_len - uart->rx_pos;
+
+    if (fill >= cfg.fifo_depth)
+    {
+        stats.overruns++;
+    }
+    else
+    {
+        if (uart->rx_len == sizeof( uart->rx_buf ))
+        {
+            memmove( uart->rx_buf, &uart->rx_buf[ uart->rx_pos ], fill );
+            uart->rx_pos = 0;
+            uart->rx_len = fill;
+        }
+
+        uart->rx_buf[ uart->rx_len++ ] = rx_dat;
+
+        if (++fill > stats.fifo_max)
+        {
+            stats.fifo_max = fill;
+        }
+    }
+
+    if (!in_isr && (uart->rx_isr != 0))
+    {
+        sim_isr();
+    }
+}
+
+static void sim_event( void )
+{
+    if (next_tick <= next_byte)
+    {
+        now = next_tick;
+        next_tick += SIM_TICK_NS;
+        ecg4_tick();
+    }
+    else
+    {
+        now = next_byte;
+        next_byte += byte_ns;
+        sim_rx( tx_buf[ tx_pos++ ] );
+
+        if (tx_pos == tx_ends[ tx_frame_idx ])
+        {
+            stats.sent++;
+            tx_frame_idx++;
+        }
+
+        if (tx_pos == tx_len)
+        {
+            sim_tx_load();
+        }
+    }
+
+    if (now >= end)
+    {
+        sim_report();
+        fflush( stdout );
+        exit( 0 );
+    }
+}
+
+static void sim_run( uint64_t busy_ns )
+{
+    uint64_t due;
+
+    while (1)
+    {
+        due = (next_tick < next_byte) ? next_tick : next_byte;
+
+        if (due <= now)
+        {
+            sim_event();
+        }
+        else if (due - now >= busy_ns)
+        {
+            now += busy_ns;
+
+            return;
+        }
+        else
+        {
+            busy_ns -= due - now;
+            sim_event();
+        }
+    }
+}
+
+static void sim_isr( void )
+{
+    T_mikrobus_uart *uart;
+
+    uart = &_MIKROBUS1_UART;
+    in_isr = 1;
+
+    while (uart->rx_pos != uart->rx_len)
+    {
+        uart->rx_isr();
+        stats.isr_ns += cfg.isr_ns;
+        sim_run( cfg.isr_ns );
+    }
+
+    in_isr = 0;
+}
+
+static void sim_start( void )
+{
+    if ((next_byte != SIM_NEVER) || (_MIKROBUS1_UART.rx_isr == 0))
+    {
+        return;
+    }
+
+    start = now;
+    end = start + (uint64_t)(cfg.seconds * 1e9);
+    next_tick = now + SIM_TICK_NS;
+    next_byte = now;
+    idle_exit = now;
+    sim_tx_load();
+}
+
+static void sim_charge( void )
+{
+    T_ecg4_duty duty;
+
+    sim_start();
+    ecg4_duty_get( &duty );
+
+    while (charged < duty.packets)
+    {
+        charged++;
+        sim_run( cfg.app_ns );
+    }
+}
+
+static void sim_elapse( uint32_t time_us )
+{
+    sim_charge();
+    sim_run( (uint64_t)time_us * 1000 );
+}
+
+static void sim_idle( void )
+{
+    uint64_t due;
+    uint64_t busy;
+
+    sim_charge();
+
+    if (next_byte == SIM_NEVER)
+    {
+        fprintf( stderr, "ecg4_sim: the application waits for data without the rx interrupt set\n" );
+        exit( 1 );
+    }
+
+    busy = now - idle_exit;
+
+    if (busy > stats.busy_max_ns)
+    {
+        stats.busy_max_ns = busy;
+    }
+
+    // a tick wakes the core as well, but ecg4_wait_for_data goes back to idle until a byte
+    do
+    {
+        due = (next_tick < next_byte) ? next_tick : next_byte;
+
+        if (due > now)
+        {
+            stats.idle_ns += due - now;
+        }
+
+        sim_event();
+    }
+    while (due != next_byte - byte_ns);
+
+    idle_exit = now;
+}
+
+static void sim_usage( void )
+{
+    fprintf( stderr, "usage: ecg4_sim [-t seconds] [-b baud] [-d fifo_depth] [-i isr_us] [-a app_us] "
+                     "[-c function=us]... [-o log] [-q]\n"
+                     "       function: processResponse, plotData or logData\n" );
+    exit( 2 );
+}
+
+static void sim_hook_init( void )
+{
+    hooks[ 0 ].name = "processResponse";
+    hooks[ 0 ].fn = (void *)&processResponse;
+    hooks[ 1 ].name = "plotData";
+    hooks[ 1 ].fn = (void *)&plotData;
+    hooks[ 2 ].name = "logData";
+    hooks[ 2 ].fn = (void *)&logData;
+}
+
+static void sim_hook_cost( const char *arg )
+{
+    const char *sep;
+    uint8_t cnt;
+
+    sep = strchr( arg, '=' );
+
+    for (cnt = 0; (sep != NULL) && (cnt < SIM_HOOKS); cnt++)
+    {
+        if ((strlen( hooks[ cnt ].name ) == (size_t)(sep - arg)) && (strncmp( arg, hooks[ cnt ].name, sep - arg ) == 0))
+        {
+            hooks[ cnt ].cost_ns = (uint32_t)(atof( sep + 1 ) * 1000);
+
+            return;
+        }
+    }
+
+    sim_usage();
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+// charged when a hooked function is entered, before its body runs
+void __cyg_profile_func_enter( void *fn, void *site )
+{
+    uint8_t cnt;
+
+    (void)site;
+    hooks_seen = 1;
+
+    for (cnt = 0; cnt < SIM_HOOKS; cnt++)
+    {
+        if ((fn == hooks[ cnt ].fn) && (hooks[ cnt ].cost_ns != 0))
+        {
+            hooks[ cnt ].calls++;
+            sim_charge();
+            sim_run( hooks[ cnt ].cost_ns );
+
+            return;
+        }
+    }
+}
+
+void __cyg_profile_func_exit( void *fn, void *site )
+{
+    (void)fn;
+    (void)site;
+}
+
+int main( int argc, char **argv )
+{
+    T_ecg4_synth_cfg synth_cfg;
+    int opt;
+
+    cfg.seconds = 60;
+    cfg.baud = 57600;
+    cfg.fifo_depth = 1;
+    cfg.isr_ns = 5000;
+    cfg.app_ns = 0;
+    cfg.log_path = "/dev/null";
+    cfg.quiet = 0;
+    sim_hook_init();
+
+    while ((opt = getopt( argc, argv, "t:b:d:i:a:c:o:q" )) != -1)
+    {
+        switch (opt)
+        {
+            case 't' :
+                cfg.seconds = atof( optarg );
+                break;
+            case 'b' :
+                cfg.baud = (uint32_t)atol( optarg );
+                break;
+            case 'd' :
+                cfg.fifo_depth = (uint16_t)atoi( optarg );
+                break;
+            case 'i' :
+                cfg.isr_ns = (uint32_t)(atof( optarg ) * 1000);
+                break;
+            case 'a' :
+                cfg.app_ns = (uint32_t)(atof( optarg ) * 1000);
+                break;
+            case 'c' :
+                sim_hook_cost( optarg );
+                break;
+            case 'o' :
+                cfg.log_path = optarg;
+                break;
+            case 'q' :
+                cfg.quiet = 1;
+                break;
+            default :
+                sim_usage();
+        }
+    }
+
+    if ((cfg.baud == 0) || (cfg.fifo_depth == 0) || (cfg.fifo_depth > 255) || (cfg.seconds <= 0))
+    {
+        sim_usage();
+    }
+
+    report = fdopen( dup( STDOUT_FILENO ), "w" );
+
+    if ((report == NULL) || (freopen( cfg.log_path, "w", stdout ) == NULL))
+    {
+        perror( cfg.log_path );
+        return 1;
+    }
+
+    ecg4_synth_default( &synth_cfg, 1 );
+    ecg4_synth_init( &syn, &synth_cfg );
+    byte_ns = 10000000000ull / cfg.baud;
+    next_tick = SIM_NEVER;
+    next_byte = SIM_NEVER;
+
+    _MIKROBUS1_UART.rx_idle = &sim_idle;
+    mikrosdk_elapse_set( &sim_elapse );
+
+    return ecg4_app_main();
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_sim.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
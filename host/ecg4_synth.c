@@ -0,0 +1,359 @@
+/*
+    ecg4_synth.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_synth.c
+@brief    ECG_4 Synthetic Stream Generator
+*/
+
+#include <math.h>
+#include "ecg4_synth.h"
+#include "ecg4_frame.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define SYNTH_PI                3.14159265358979323846
+#define SYNTH_RAIL              32767
+#define SYNTH_QUALITY_ON        200
+#define SYNTH_QUALITY_OFF       0
+#define SYNTH_RR_MIN            0.25
+#define SYNTH_RR_MAX            2.0
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+// P, Q, R, S and T waves: offset to the R peak in s, amplitude relative to R, width in s
+static const double synth_waves[ 5 ][ 3 ] =
+{
+    { -0.20,  0.06, 0.025 },
+    { -0.03, -0.05, 0.010 },
+    {  0.00,  1.00, 0.012 },
+    {  0.03, -0.13, 0.010 },
+    {  0.25,  0.27, 0.050 }
+};
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint64_t synth_rand( T_ecg4_synth *syn )
+{
+    uint64_t z;
+
+    // splitmix64
+    syn->rng += 0x9E3779B97F4A7C15ull;
+    z = syn->rng;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+static double synth_uniform( T_ecg4_synth *syn )
+{
+    return (synth_rand( syn ) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double synth_gauss( T_ecg4_synth *syn )
+{
+    double u;
+
+    u = synth_uniform( syn );
+
+    return sqrt( -2.0 * log( u + 1e-300 ) ) * cos( 2 * SYNTH_PI * synth_uniform( syn ) );
+}
+
+static double synth_rr( T_ecg4_synth *syn )
+{
+    double rr;
+
+    rr = 60.0 / syn->cfg.bpm * (1.0 + syn->cfg.hrv * synth_gauss( syn ));
+
+    if (rr < SYNTH_RR_MIN)
+    {
+        rr = SYNTH_RR_MIN;
+    }
+    else if (rr > SYNTH_RR_MAX)
+    {
+        rr = SYNTH_RR_MAX;
+    }
+
+    return rr;
+}
+
+static void synth_annotate( T_ecg4_synth *syn, char type, uint64_t sample, int32_t value )
+{
+    T_ecg4_synth_event ev;
+
+    if (syn->cfg.annotate == 0)
+    {
+        return;
+    }
+
+    ev.type = type;
+    ev.sample = sample;
+    ev.offset = syn->offset;
+    ev.value = value;
+    syn->cfg.annotate( syn->cfg.ctx, &ev );
+}
+
+static double synth_ecg( const T_ecg4_synth *syn, double t )
+{
+    double val;
+    double dt;
+    uint8_t beat;
+    uint8_t wave;
+
+    val = 0;
+
+    for (beat = 0; beat < 3; beat++)
+    {
+        for (wave = 0; wave < 5; wave++)
+        {
+            dt = t - syn->beat[ beat ] - synth_waves[ wave ][ 0 ];
+            val += synth_waves[ wave ][ 1 ] *
+                   exp( -dt * dt / (2 * synth_waves[ wave ][ 2 ] * synth_waves[ wave ][ 2 ]) );
+        }
+    }
+
+    return val * syn->cfg.amplitude;
+}
+
+static void synth_leadoff_update( T_ecg4_synth *syn )
+{
+    double p_start;
+
+    if (syn->leadoff)
+    {
+        if (syn->n >= syn->leadoff_end)
+        {
+            syn->leadoff = 0;
+            synth_annotate( syn, ECG4_SYNTH_LEADON, syn->n, 0 );
+        }
+
+        return;
+    }
+
+    p_start = syn->cfg.leadoff_rate / (3600.0 * ECG4_SYNTH_FS);
+
+    if ((p_start > 0) && (synth_uniform( syn ) < p_start))
+    {
+        syn->leadoff = 1;
+        syn->leadoff_end = syn->n + 1 +
+                           (uint64_t)(-log( synth_uniform( syn ) + 1e-300 ) * syn->cfg.leadoff_s * ECG4_SYNTH_FS);
+        synth_annotate( syn, ECG4_SYNTH_LEADOFF, syn->n, 0 );
+    }
+}
+
+static uint8_t synth_has_sync( int16_t sample )
+{
+    uint8_t hi;
+    uint8_t lo;
+
+    hi = (uint8_t)((uint16_t)sample >> 8);
+    lo = (uint8_t)sample;
+
+    return (hi == 0xAA) || (hi == 0x55) || (lo == 0xAA) || (lo == 0x55);
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_synth_default( T_ecg4_synth_cfg *cfg, uint64_t seed )
+{
+    cfg->seed = seed;
+    cfg->bpm = 72;
+    cfg->hrv = 0.05;
+    cfg->amplitude = 3000;
+    cfg->noise = 5;
+    cfg->wander = 300;
+    cfg->mains = 0;
+    cfg->leadoff_rate = 0;
+    cfg->leadoff_s = 5;
+    cfg->drop_rate = 0;
+    cfg->flip_rate = 0;
+    cfg->collide_rate = 0;
+    cfg->annotate = 0;
+    cfg->ctx = 0;
+}
+
+void ecg4_synth_init( T_ecg4_synth *syn, const T_ecg4_synth_cfg *cfg )
+{
+    syn->cfg = *cfg;
+    syn->rng = cfg->seed;
+    syn->n = 0;
+    syn->offset = 0;
+    syn->beat[ 0 ] = -1e3;
+    syn->beat[ 1 ] = -1e3;
+    syn->beat[ 2 ] = synth_uniform( syn ) * 60.0 / cfg->bpm;
+    syn->beat_next = syn->beat[ 2 ] + synth_rr( syn );
+    syn->annotated = -1e3;
+    syn->wander_phase = synth_uniform( syn ) * 2 * SYNTH_PI;
+    syn->leadoff = 0;
+    syn->leadoff_end = 0;
+    syn->bpm = (uint8_t)(cfg->bpm + 0.5);
+}
+
+int16_t ecg4_synth_sample( T_ecg4_synth *syn )
+{
+    double t;
+    double val;
+    int32_t sample;
+    uint64_t r_sample;
+
+    t = (double)syn->n / ECG4_SYNTH_FS;
+
+    // the window of three beats moves on half way between the current and the next beat
+    while (t > (syn->beat[ 1 ] + syn->beat[ 2 ]) / 2)
+    {
+        syn->beat[ 0 ] = syn->beat[ 1 ];
+        syn->beat[ 1 ] = syn->beat[ 2 ];
+        syn->beat[ 2 ] = syn->beat_next;
+        syn->beat_next += synth_rr( syn );
+    }
+
+    synth_leadoff_update( syn );
+
+    if ((t >= syn->beat[ 1 ]) && (syn->beat[ 1 ] > syn->annotated))
+    {
+        syn->annotated = syn->beat[ 1 ];
+        r_sample = (uint64_t)(syn->beat[ 1 ] * ECG4_SYNTH_FS + 0.5);
+        syn->bpm = (uint8_t)(60.0 / (syn->beat[ 1 ] - syn->beat[ 0 ]) + 0.5);
+
+        if (!syn->leadoff)
+        {
+            synth_annotate( syn, ECG4_SYNTH_BEAT, r_sample, (syn->beat[ 0 ] < 0) ? 0 :
+                            (int32_t)((syn->beat[ 1 ] - syn->beat[ 0 ]) * ECG4_SYNTH_FS + 0.5) );
+        }
+    }
+
+    if (syn->leadoff)
+    {
+        val = SYNTH_RAIL - fabs( syn->cfg.noise * synth_gauss( syn ) );
+    }
+    else
+    {
+        val = synth_ecg( syn, t ) +
+              syn->cfg.wander * sin( 2 * SYNTH_PI * 0.25 * t + syn->wander_phase ) +
+              syn->cfg.mains * sin( 2 * SYNTH_PI * 50 * t ) +
+              syn->cfg.noise * synth_gauss( syn );
+    }
+
+    if (val > SYNTH_RAIL)
+    {
+        val = SYNTH_RAIL;
+    }
+    else if (val < -SYNTH_RAIL - 1)
+    {
+        val = -SYNTH_RAIL - 1;
+    }
+
+    sample = (int32_t)floor( val + 0.5 );
+
+    if ((syn->cfg.collide_rate > 0) && (synth_uniform( syn ) < syn->cfg.collide_rate))
+    {
+        sample = (sample & ~0xFF) | ((synth_rand( syn ) & 1) ? 0xAA : 0x55);
+    }
+
+    syn->n++;
+
+    return (int16_t)sample;
+}
+
+uint16_t ecg4_synth_frames( T_ecg4_synth *syn, uint8_t *buf )
+{
+    uint8_t frames[ ECG4_SYNTH_FRAMES_MAX ];
+    uint16_t len;
+    uint16_t out;
+    uint16_t cnt;
+    uint8_t mask;
+    int16_t sample;
+
+    sample = ecg4_synth_sample( syn );
+    len = ecg4_frame_raw( frames, sample );
+
+    if (synth_has_sync( sample ))
+    {
+        synth_annotate( syn, ECG4_SYNTH_COLLIDE, syn->n - 1, sample );
+    }
+
+    if (syn->n % ECG4_SYNTH_FS == 0)
+    {
+        len += ecg4_frame_status( &frames[ len ], syn->leadoff ? SYNTH_QUALITY_OFF : SYNTH_QUALITY_ON, syn->bpm );
+    }
+
+    out = 0;
+
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        if ((syn->cfg.drop_rate > 0) && (synth_uniform( syn ) < syn->cfg.drop_rate))
+        {
+            synth_annotate( syn, ECG4_SYNTH_DROP, syn->n - 1, frames[ cnt ] );
+            continue;
+        }
+
+        buf[ out ] = frames[ cnt ];
+
+        if ((syn->cfg.flip_rate > 0) && (synth_uniform( syn ) < syn->cfg.flip_rate))
+        {
+            mask = (uint8_t)(1 << (synth_rand( syn ) & 7));
+            buf[ out ] ^= mask;
+            synth_annotate( syn, ECG4_SYNTH_FLIP, syn->n - 1, mask );
+        }
+
+        out++;
+        syn->offset++;
+    }
+
+    return out;
+}
+
+uint8_t ecg4_synth_leadoff( const T_ecg4_synth *syn )
+{
+    return syn->leadoff;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_synth.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,184 @@
+/*
+    ecg4_synth.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_synth.h
+@brief    ECG_4 Synthetic Stream Generator
+
+Seeded generator of reproducible ECG_4 input with known ground truth, for benchmarks and detector tests:
+
+- ECG samples at 512 Hz, a sum of P, Q, R, S and T waves per beat, RR intervals with a given heart rate and
+  variability, white noise, baseline wander, 50 Hz mains and lead-off periods (samples at the rail, signal
+  quality 0),
+- the framed BMD101 byte stream which ecg4_uart_isr consumes (a raw data frame per sample and a signal quality
+  and heart rate frame per second), with byte drops, bit flips and forced 0xAA / 0x55 payload bytes.
+
+Every beat, lead-off period and corruption is reported to the annotation callback. The same seed and
+configuration give the same samples, stream and annotations.
+*/
+
+#include <stdint.h>
+
+#ifndef _ECG4_SYNTH_H_
+#define _ECG4_SYNTH_H_
+
+#define ECG4_SYNTH_FS           512
+
+/**
+ * @macro ECG4_SYNTH_FRAMES_MAX
+ * @brief Largest output of ecg4_synth_frames, a raw data and a status frame
+ */
+#define ECG4_SYNTH_FRAMES_MAX   16
+
+#define ECG4_SYNTH_BEAT         'N'     /**< R peak, value - RR interval in samples, 0 - first beat */
+#define ECG4_SYNTH_LEADOFF      '('     /**< Lead-off start */
+#define ECG4_SYNTH_LEADON       ')'     /**< Lead-off end */
+#define ECG4_SYNTH_DROP         'D'     /**< Byte dropped, value - the byte */
+#define ECG4_SYNTH_FLIP         'F'     /**< Bit flipped, value - the bit mask */
+#define ECG4_SYNTH_COLLIDE      'C'     /**< Raw data payload holding 0xAA or 0x55, value - the sample */
+
+/**
+ * @struct T_ecg4_synth_event
+ * @brief Annotation
+ */
+typedef struct
+{
+    char     type;
+    uint64_t sample;            /**< Sample index */
+    uint64_t offset;            /**< Offset in the byte stream, after the drops, for the stream annotations */
+    int32_t  value;
+
+}T_ecg4_synth_event;
+
+/**
+ * @struct T_ecg4_synth_cfg
+ * @brief Generator configuration, rates are per byte or per sample probabilities
+ */
+typedef struct
+{
+    uint64_t seed;
+    double   bpm;               /**< Mean heart rate */
+    double   hrv;               /**< RR standard deviation, as a fraction of the mean RR */
+    double   amplitude;         /**< R wave amplitude in LSB */
+    double   noise;             /**< White noise, LSB rms */
+    double   wander;            /**< Baseline wander amplitude in LSB */
+    double   mains;             /**< 50 Hz amplitude in LSB */
+    double   leadoff_rate;      /**< Lead-off periods per hour */
+    double   leadoff_s;         /**< Mean lead-off duration */
+    double   drop_rate;         /**< Byte drop probability */
+    double   flip_rate;         /**< Bit flip probability per byte */
+    double   collide_rate;      /**< Probability to force a 0xAA or 0x55 byte in a raw data payload */
+    void     ( *annotate )( void *ctx, const T_ecg4_synth_event *ev );
+    void     *ctx;
+
+}T_ecg4_synth_cfg;
+
+/**
+ * @struct T_ecg4_synth
+ * @brief Generator state
+ */
+typedef struct
+{
+    T_ecg4_synth_cfg cfg;
+    uint64_t rng;
+    uint64_t n;                 /**< Next sample index */
+    uint64_t offset;            /**< Bytes output by ecg4_synth_frames */
+    double   beat[ 3 ];         /**< Previous, current and next R peak time in s */
+    double   beat_next;         /**< R peak time following beat[ 2 ] */
+    double   annotated;         /**< Last annotated R peak time */
+    double   wander_phase;
+    uint8_t  leadoff;
+    uint64_t leadoff_end;
+    uint8_t  bpm;               /**< Heart rate row */
+
+}T_ecg4_synth;
+
+/**
+ * @brief Default Config function
+ *
+ * @param[out] cfg   Configuration: 72 BPM, 5 % variability, 3000 LSB R wave, 5 LSB noise, 300 LSB wander,
+ *                   no mains, lead-off or corruption
+ * @param[in]  seed  Seed
+ */
+void ecg4_synth_default( T_ecg4_synth_cfg *cfg, uint64_t seed );
+
+/**
+ * @brief Init function
+ */
+void ecg4_synth_init( T_ecg4_synth *syn, const T_ecg4_synth_cfg *cfg );
+
+/**
+ * @brief Sample function
+ *
+ * @returns Next sample, as it is sent by the device (including forced 0xAA / 0x55 bytes)
+ */
+int16_t ecg4_synth_sample( T_ecg4_synth *syn );
+
+/**
+ * @brief Frames function
+ *
+ * @param[out] buf  Bytes, ECG4_SYNTH_FRAMES_MAX at most
+ *
+ * @returns Number of bytes
+ *
+ * Function generates the next sample and returns its raw data frame, followed by the status frame once per
+ * second, with the corruptions applied.
+ */
+uint16_t ecg4_synth_frames( T_ecg4_synth *syn, uint8_t *buf );
+
+/**
+ * @brief Leads Off function
+ *
+ * @returns 1 - the last sample was generated during a lead-off period
+ */
+uint8_t ecg4_synth_leadoff( const T_ecg4_synth *syn );
+
+#endif
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_synth.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
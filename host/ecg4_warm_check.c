@@ -0,0 +1,442 @@
+/*
+    ecg4_warm_check.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4_warm_check.c
+@brief    ECG_4 Warm Start Check
+
+Locks the filter chain, the QRS detector and the heart rate on a synthetic ECG (ecg4_synth, random rhythm
+from 50 to 150 BPM, baseline wander and 50 Hz mains), saves them with ecg4_warm_save into a RAM EEPROM
+through the T_ecg4_nvm hooks, keeps the signal going for a random time, as if the board was powered off,
+and restores them with ecg4_warm_load into fresh contexts. For every restart the check asserts that:
+
+- the first detected beat is a true R peak (ecg4_synth annotation, within CHECK_TOL samples),
+- it comes within one RR interval of the first R peak after the restart, so at most that one is missed,
+- the heart rate is confident from the second detected beat on, the RR average being the restored one.
+
+A cold started detector runs on the same samples, its first beats are reported for comparison. At the end
+a corrupted blob and a failing read hook must fall back to a cold start. Exits with 1 on the first failure.
+
+    gcc -O2 -I../library -I. -o ecg4_warm_check ecg4_warm_check.c ecg4_synth.c ecg4_frame.c ../library/__ecg4_warm.c \
+        ../library/__ecg4_crc.c ../library/__ecg4_qrs.c ../library/__ecg4_filter.c ../library/__ecg4_hr.c -lm
+
+    ecg4_warm_check [-n restarts] [-s seed] [-t lock_seconds]
+
+Defaults: 500 restarts, seed 1, 30 s to lock before every save, which waits for a confident heart rate.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ecg4_synth.h"
+#include "__ecg4_warm.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define CHECK_EEPROM_SIZE       256
+#define CHECK_NVM_ADDR          0x40
+#define CHECK_TOL               77          // R peak matching window, 150 ms as in ANSI/AAMI EC57
+#define CHECK_RHYTHM_PCT        19          // rhythm change under which the heart rate must be confident
+#define CHECK_RUN               (4 * ECG4_SYNTH_FS)
+#define CHECK_LOCK_EXTRA        10          // seconds waited for a confident heart rate after the lock time
+#define CHECK_PEAKS_MAX         64
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    uint64_t peak[ CHECK_PEAKS_MAX ];   /**< True R peaks from the restart on */
+    uint16_t n_peaks;
+    uint64_t from;
+
+}T_check_truth;
+
+typedef struct
+{
+    T_ecg4_filter flt;
+    T_ecg4_qrs    qrs;
+    T_ecg4_hr     hr;
+    uint16_t      n_beats;
+    uint64_t      first;                /**< R peak of the first detected beat */
+    uint16_t      rr;                   /**< RR interval at the second detected beat */
+    uint8_t       confident;            /**< Heart rate confident at the second detected beat */
+
+}T_check_chain;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static uint32_t check_rng;
+static uint8_t check_eeprom[ CHECK_EEPROM_SIZE ];
+static uint8_t check_read_fail;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint32_t check_rand( void )
+{
+    check_rng ^= check_rng << 13;
+    check_rng ^= check_rng >> 17;
+    check_rng ^= check_rng << 5;
+
+    return check_rng;
+}
+
+static uint8_t check_nvm_read( uint16_t addr, uint8_t *buf, uint16_t len )
+{
+    if (check_read_fail || (addr + len > CHECK_EEPROM_SIZE))
+    {
+        return 1;
+    }
+
+    memcpy( buf, &check_eeprom[ addr ], len );
+
+    return 0;
+}
+
+static uint8_t check_nvm_write( uint16_t addr, const uint8_t *buf, uint16_t len )
+{
+    if (addr + len > CHECK_EEPROM_SIZE)
+    {
+        return 1;
+    }
+
+    memcpy( &check_eeprom[ addr ], buf, len );
+
+    return 0;
+}
+
+static void check_annotate( void *ctx, const T_ecg4_synth_event *ev )
+{
+    T_check_truth *truth;
+
+    truth = ctx;
+
+    if ((ev->type == ECG4_SYNTH_BEAT) && (ev->sample >= truth->from) && (truth->n_peaks < CHECK_PEAKS_MAX))
+    {
+        truth->peak[ truth->n_peaks++ ] = ev->sample;
+    }
+}
+
+static void check_chain_init( T_check_chain *ch )
+{
+    ecg4_filter_init( &ch->flt, 7, _ECG4_FILTER_NOTCH_50HZ );
+    ecg4_qrs_init( &ch->qrs );
+    ecg4_hr_init( &ch->hr );
+    ch->n_beats = 0;
+    ch->first = 0;
+    ch->rr = 0;
+    ch->confident = 0;
+}
+
+// runs one sample through the chain, base is the synth index of the first sample after the chain start
+static void check_chain_sample( T_check_chain *ch, int16_t sample, uint64_t base )
+{
+    uint8_t beat;
+    uint8_t confident;
+
+    ecg4_filter_block( &ch->flt, &sample, 1 );
+    beat = ecg4_qrs_process( &ch->qrs, sample );
+    confident = ecg4_hr_update( &ch->hr, &ch->qrs, beat );
+
+    if (beat)
+    {
+        if (ch->n_beats == 0)
+        {
+            ch->first = base + ecg4_qrs_beat( &ch->qrs );
+        }
+        else if (ch->n_beats == 1)
+        {
+            ch->rr = ecg4_qrs_rr( &ch->qrs );
+            ch->confident = confident;
+        }
+
+        ch->n_beats++;
+    }
+}
+
+// index of the true R peak nearest to the detected one, -1 - none within CHECK_TOL
+static int check_match( const T_check_truth *truth, uint64_t peak )
+{
+    uint64_t dist;
+    uint64_t best;
+    uint16_t cnt;
+    int idx;
+
+    idx = -1;
+    best = CHECK_TOL + 1;
+
+    for (cnt = 0; cnt < truth->n_peaks; cnt++)
+    {
+        dist = (peak > truth->peak[ cnt ]) ? peak - truth->peak[ cnt ] : truth->peak[ cnt ] - peak;
+
+        if (dist < best)
+        {
+            best = dist;
+            idx = cnt;
+        }
+    }
+
+    return idx;
+}
+
+static int check_fallback( T_ecg4_nvm *nvm )
+{
+    T_check_chain ch;
+    uint8_t err;
+
+    check_chain_init( &ch );
+    check_eeprom[ CHECK_NVM_ADDR + 5 ] ^= 0x10;
+    err = ecg4_warm_load( nvm, &ch.qrs, &ch.flt, &ch.hr );
+    check_eeprom[ CHECK_NVM_ADDR + 5 ] ^= 0x10;
+
+    if ((err != _ECG4_WARM_ERR_BLOB) || ch.qrs.warm)
+    {
+        printf( "corrupted blob: load returned %u, detector %s\n", err, ch.qrs.warm ? "warm" : "cold" );
+        return 1;
+    }
+
+    check_read_fail = 1;
+    err = ecg4_warm_load( nvm, &ch.qrs, &ch.flt, &ch.hr );
+    check_read_fail = 0;
+
+    if ((err != _ECG4_WARM_ERR_NVM) || ch.qrs.warm)
+    {
+        printf( "failing read: load returned %u, detector %s\n", err, ch.qrs.warm ? "warm" : "cold" );
+        return 1;
+    }
+
+    err = ecg4_warm_load( nvm, &ch.qrs, &ch.flt, &ch.hr );
+
+    if ((err != _ECG4_WARM_OK) || !ch.qrs.warm)
+    {
+        printf( "intact blob: load returned %u, detector %s\n", err, ch.qrs.warm ? "warm" : "cold" );
+        return 1;
+    }
+
+    return 0;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    static T_check_chain run;
+    static T_check_chain warm;
+    static T_check_chain cold;
+    T_check_truth truth;
+    T_ecg4_synth_cfg cfg;
+    T_ecg4_synth syn;
+    T_ecg4_nvm nvm;
+    uint32_t n_restarts;
+    uint32_t lock_s;
+    uint32_t restart;
+    uint32_t cnt;
+    uint32_t warm_nth[ 2 ] = { 0, 0 };
+    uint32_t cold_nth[ 3 ] = { 0, 0, 0 };
+    uint32_t changed;
+    uint32_t cold_det;
+    uint64_t base;
+    uint64_t warm_sum;
+    uint64_t cold_sum;
+    uint16_t rr_avg;
+    int16_t sample;
+    int warm_idx;
+    int cold_idx;
+    int opt;
+
+    n_restarts = 500;
+    check_rng = 1;
+    lock_s = 30;
+
+    while ((opt = getopt( argc, argv, "n:s:t:" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': n_restarts = atoi( optarg ); break;
+            case 's': check_rng = atoi( optarg ); break;
+            case 't': lock_s = atoi( optarg ); break;
+            default:
+                fprintf( stderr, "usage: %s [-n restarts] [-s seed] [-t lock_seconds]\n", argv[ 0 ] );
+                return 2;
+        }
+    }
+
+    if (check_rng == 0)
+    {
+        check_rng = 1;
+    }
+
+    nvm.read = &check_nvm_read;
+    nvm.write = &check_nvm_write;
+    nvm.addr = CHECK_NVM_ADDR;
+    warm_sum = 0;
+    cold_sum = 0;
+    changed = 0;
+    cold_det = 0;
+
+    for (restart = 0; restart < n_restarts; restart++)
+    {
+        ecg4_synth_default( &cfg, check_rand() );
+        cfg.bpm = 50 + check_rand() % 101;
+        cfg.mains = 200;
+        cfg.annotate = &check_annotate;
+        cfg.ctx = &truth;
+        truth.n_peaks = 0;
+        truth.from = (uint64_t)-1;
+        ecg4_synth_init( &syn, &cfg );
+
+        check_chain_init( &run );
+
+        // saved only while the heart rate is confident, as the examples do
+        for (cnt = 0; (cnt < lock_s * ECG4_SYNTH_FS) || !ecg4_hr_confident( &run.hr ); cnt++)
+        {
+            if (cnt == (lock_s + CHECK_LOCK_EXTRA) * ECG4_SYNTH_FS)
+            {
+                printf( "restart %u: not locked after %u s at %.0f BPM\n", restart, lock_s + CHECK_LOCK_EXTRA,
+                        cfg.bpm );
+                return 1;
+            }
+
+            check_chain_sample( &run, ecg4_synth_sample( &syn ), 0 );
+        }
+
+        if (ecg4_warm_save( &nvm, &run.qrs, &run.flt, &run.hr ) != _ECG4_WARM_OK)
+        {
+            printf( "restart %u: save failed\n", restart );
+            return 1;
+        }
+
+        // off for up to 2 s, so the restart falls anywhere in the cardiac cycle
+        for (cnt = check_rand() % (2 * ECG4_SYNTH_FS); cnt > 0; cnt--)
+        {
+            ecg4_synth_sample( &syn );
+        }
+
+        base = syn.n;
+        truth.from = base;
+        check_chain_init( &warm );
+        check_chain_init( &cold );
+
+        if (ecg4_warm_load( &nvm, &warm.qrs, &warm.flt, &warm.hr ) != _ECG4_WARM_OK)
+        {
+            printf( "restart %u: load failed\n", restart );
+            return 1;
+        }
+
+        for (cnt = 0; cnt < CHECK_RUN; cnt++)
+        {
+            sample = ecg4_synth_sample( &syn );
+            check_chain_sample( &warm, sample, base );
+            check_chain_sample( &cold, sample, base );
+        }
+
+        warm_idx = (warm.n_beats != 0) ? check_match( &truth, warm.first ) : -1;
+        cold_idx = (cold.n_beats != 0) ? check_match( &truth, cold.first ) : -1;
+
+        if ((warm_idx != 0) && (warm_idx != 1))
+        {
+            printf( "restart %u at %.0f BPM: first R peak %u samples after the restart, ", restart, cfg.bpm,
+                    (uint32_t)(truth.peak[ 0 ] - base) );
+
+            if (warm.n_beats == 0)
+            {
+                printf( "no beat detected in %u s\n", CHECK_RUN / ECG4_SYNTH_FS );
+            }
+            else if (warm_idx < 0)
+            {
+                printf( "first detected beat at %u is no R peak\n", (uint32_t)(warm.first - base) );
+            }
+            else
+            {
+                printf( "first detected beat is R peak %d\n", warm_idx );
+            }
+
+            return 1;
+        }
+
+        // the restored average is the reference of the first RR interval
+        rr_avg = run.hr.rr_avg_q4 >> 4;
+
+        if ((uint32_t)abs( warm.rr - rr_avg ) * 100 > (uint32_t)rr_avg * CHECK_RHYTHM_PCT)
+        {
+            changed++;
+        }
+        else if (!warm.confident)
+        {
+            printf( "restart %u at %.0f BPM: heart rate not confident at the second beat, RR %u, restored %u\n",
+                    restart, cfg.bpm, warm.rr, rr_avg );
+            return 1;
+        }
+
+        warm_nth[ warm_idx ]++;
+        warm_sum += warm.first - base;
+        cold_nth[ ((cold_idx >= 0) && (cold_idx < 2)) ? cold_idx : 2 ]++;
+
+        if (cold.n_beats != 0)
+        {
+            cold_sum += cold.first - base;
+            cold_det++;
+        }
+    }
+
+    printf( "restarts  : %u, %u with the first RR more than %u%% off the restored average\n", n_restarts, changed,
+            CHECK_RHYTHM_PCT );
+    printf( "warm      : first beat is R peak 0 in %u, R peak 1 in %u restarts, %.0f ms after the restart on average\n",
+            warm_nth[ 0 ], warm_nth[ 1 ], n_restarts ? warm_sum * 1000.0 / ECG4_SYNTH_FS / n_restarts : 0 );
+    printf( "cold      : first beat is R peak 0 in %u, R peak 1 in %u, later or none in %u restarts, %.0f ms on average\n",
+            cold_nth[ 0 ], cold_nth[ 1 ], cold_nth[ 2 ],
+            cold_det ? cold_sum * 1000.0 / ECG4_SYNTH_FS / cold_det : 0 );
+
+    return check_fallback( &nvm );
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4_warm_check.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
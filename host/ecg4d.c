@@ -0,0 +1,355 @@
+/*
+    ecg4d.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4d.c
+@brief    ECG_4 Acquisition Daemon
+
+Reads ECG_4 clicks on serial ports (USB-serial adapters) on a Linux gateway. Every port is opened non-blocking,
+a tty in raw mode at the baud rate, and an epoll loop reads the ports which have data, in whole buffers, into the
+shared stream parser (__ecg4_parser), the one ecg4_uart_isr uses on the MCU. The verified packets are published
+to the sinks (-k, see ecg4d_sink.c): raw data samples in blocks, signal quality and heart rate rows and checksum
+errors as events.
+
+With -j the devices are spread over shards: event loops on their own threads, pinned to the cores, each owning
+its devices and its own sink instances (a file sink writes a file per shard, with the shard number appended).
+The cores are taken from the affinity mask of the daemon, so a cpuset or taskset is honoured, and -j 0 starts a
+shard per allowed core. A shard which cannot be pinned is reported and runs unpinned. With -u (built with -DECG4D_URING) the shards wait with io_uring instead of
+epoll, see ecg4d_shard.c.
+
+The stages sink (-k stages:filter,qrs,csv=ecg.csv,...) moves the processing off the shards: filtering, QRS
+detection and the storage and output sinks run as a chain of threads, connected by lock-free queues, to which
+a shard only hands its blocks, see ecg4d_stage.c.
+
+Every -i seconds, and on exit, a line per device is written to stderr with the samples per second, the packets
+and checksum errors, the CPU time spent on the device, the processing time from the wake-up to the published
+samples (mean / max) and the lag of the sample clock behind the wall clock (now / max, over the lowest seen, so
+buffering in the adapter, the kernel or the daemon shows; crystal drift of the device adds about 1 ms per
+10 s per 100 ppm). A device is dropped on end of file or a read error, the daemon exits when none is left.
+
+Without hardware, ecg4_emu provides the devices on pseudo-terminals:
+
+    gcc -O2 -pthread -I../library -I. -o ecg4d ecg4d.c ecg4d_dev.c ecg4d_sink.c ecg4d_shard.c ecg4d_stage.c \
+        ../library/__ecg4_parser.c ../library/__ecg4_filter.c ../library/__ecg4_qrs.c
+
+    ./ecg4_emu -n 4 -l /tmp/ecg4_ &
+    ./ecg4d -k events /tmp/ecg4_0 /tmp/ecg4_1 /tmp/ecg4_2 /tmp/ecg4_3
+
+    ecg4d [-b baud] [-k sink[:arg]]... [-i stats_s] [-t seconds] [-j shards] [-u] device...
+
+Defaults: 57600 baud, null sink, statistics every 5 s, one event loop on the main thread, epoll, runs until
+stopped (SIGINT, SIGTERM).
+*/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ecg4d.h"
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static volatile int d_stop;
+static int d_cpu[ CPU_SETSIZE ];
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void d_usage( void )
+{
+    fprintf( stderr, "usage: ecg4d [-b baud] [-k sink[:arg]]... [-i stats_s] [-t seconds] [-j shards] [-u] "
+                     "device...\nsinks:\n" );
+    ecg4d_sink_usage();
+    exit( 2 );
+}
+
+// cores the daemon may run on, in order
+static long d_cpus( void )
+{
+    cpu_set_t set;
+    long n_cpus;
+    int cpu;
+
+    n_cpus = 0;
+
+    if (sched_getaffinity( 0, sizeof( set ), &set ) == 0)
+    {
+        for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET( cpu, &set ))
+            {
+                d_cpu[ n_cpus++ ] = cpu;
+            }
+        }
+    }
+    else
+    {
+        perror( "ecg4d: sched_getaffinity" );
+    }
+
+    if (n_cpus == 0)
+    {
+        d_cpu[ 0 ] = 0;
+        n_cpus = 1;
+    }
+
+    return n_cpus;
+}
+
+static void d_signal( int sig )
+{
+    (void)sig;
+    d_stop = 1;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int main( int argc, char **argv )
+{
+    T_ecg4d_shard *shards;
+    T_ecg4d_shard *shard;
+    const char *sink_spec[ ECG4D_SINKS_MAX ];
+    uint64_t t_start;
+    uint32_t baud;
+    uint16_t n_devs;
+    uint16_t n_shards;
+    uint16_t n_started;
+    uint16_t cnt;
+    uint8_t n_sinks;
+    uint8_t uring;
+    uint8_t idx;
+    double stats_s;
+    double seconds;
+    long n_cpus;
+    int opt;
+
+    baud = 57600;
+    n_sinks = 0;
+    stats_s = 5;
+    seconds = 0;
+    n_shards = 1;
+    uring = 0;
+
+    while ((opt = getopt( argc, argv, "b:k:i:t:j:u" )) != -1)
+    {
+        switch (opt)
+        {
+            case 'b':
+                baud = atoi( optarg );
+                break;
+            case 'k':
+                if (n_sinks == ECG4D_SINKS_MAX)
+                {
+                    d_usage();
+                }
+
+                sink_spec[ n_sinks++ ] = optarg;
+                break;
+            case 'i':
+                stats_s = atof( optarg );
+                break;
+            case 't':
+                seconds = atof( optarg );
+                break;
+            case 'j':
+                n_shards = (uint16_t)atoi( optarg );
+                break;
+            case 'u':
+#ifdef ECG4D_URING
+                uring = 1;
+                break;
+#else
+                fprintf( stderr, "ecg4d: built without io_uring (-DECG4D_URING)\n" );
+                return 2;
+#endif
+            default:
+                d_usage();
+        }
+    }
+
+    if ((optind == argc) || (argc - optind > 0xFFFF))
+    {
+        d_usage();
+    }
+
+    if (n_sinks == 0)
+    {
+        sink_spec[ n_sinks++ ] = "null";
+    }
+
+    if (ecg4d_dev_baud( baud ) != 0)
+    {
+        fprintf( stderr, "ecg4d: %u baud not supported, 9600, 19200, 38400, 57600, 115200, 230400, 460800 or "
+                         "921600\n", baud );
+        return 2;
+    }
+
+    n_devs = (uint16_t)(argc - optind);
+    n_cpus = d_cpus();
+
+    if (n_shards == 0)
+    {
+        n_shards = (uint16_t)n_cpus;
+    }
+
+    if (n_shards > n_devs)
+    {
+        n_shards = n_devs;
+    }
+
+    shards = calloc( n_shards, sizeof( T_ecg4d_shard ) );
+
+    if (shards == NULL)
+    {
+        perror( "ecg4d" );
+        return 1;
+    }
+
+    signal( SIGINT, d_signal );
+    signal( SIGTERM, d_signal );
+    t_start = ecg4d_now();
+
+    for (cnt = 0; cnt < n_shards; cnt++)
+    {
+        shard = &shards[ cnt ];
+        shard->id = cnt;
+        shard->cpu = (n_shards > 1) ? d_cpu[ cnt % n_cpus ] : -1;
+        shard->uring = uring;
+        shard->stats_ns = (uint64_t)(stats_s * 1e9);
+        shard->end_ns = (seconds > 0) ? t_start + (uint64_t)(seconds * 1e9) : UINT64_MAX;
+        shard->stop = &d_stop;
+
+        // every shard allocates its own devices, nothing written by one shard shares a cache line with another
+        shard->devs = calloc( (n_devs - cnt + n_shards - 1) / n_shards, sizeof( T_ecg4d_dev ) );
+
+        if (shard->devs == NULL)
+        {
+            perror( "ecg4d" );
+            return 1;
+        }
+
+        for (idx = 0; idx < n_sinks; idx++)
+        {
+            if (ecg4d_sink_open( &shard->sinks[ idx ], sink_spec[ idx ], (n_shards > 1) ? cnt : -1 ) != 0)
+            {
+                fprintf( stderr, "ecg4d: sink %s: unknown or cannot be opened\n", sink_spec[ idx ] );
+                d_usage();
+            }
+        }
+
+        shard->n_sinks = n_sinks;
+    }
+
+    for (cnt = 0; cnt < n_devs; cnt++)
+    {
+        shard = &shards[ cnt % n_shards ];
+
+        if (ecg4d_dev_open( &shard->devs[ shard->n_devs ], argv[ optind + cnt ], cnt, baud, shard->sinks,
+                            shard->n_sinks ) != 0)
+        {
+            perror( argv[ optind + cnt ] );
+            return 1;
+        }
+
+        shard->n_devs++;
+    }
+
+    if (n_shards == 1)
+    {
+        if (ecg4d_shard_run( &shards[ 0 ] ) != 0)
+        {
+            perror( "ecg4d" );
+        }
+    }
+    else
+    {
+        for (n_started = 0; n_started < n_shards; n_started++)
+        {
+            if (ecg4d_shard_start( &shards[ n_started ] ) != 0)
+            {
+                perror( "ecg4d" );
+                d_stop = 1;
+                break;
+            }
+        }
+
+        for (cnt = 0; cnt < n_started; cnt++)
+        {
+            ecg4d_shard_join( &shards[ cnt ] );
+        }
+    }
+
+    for (cnt = 0; cnt < n_shards; cnt++)
+    {
+        shard = &shards[ cnt ];
+
+        for (idx = 0; idx < shard->n_sinks; idx++)
+        {
+            shard->sinks[ idx ].ops->close( shard->sinks[ idx ].ctx );
+        }
+
+        for (n_devs = 0; n_devs < shard->n_devs; n_devs++)
+        {
+            ecg4d_dev_close( &shard->devs[ n_devs ] );
+        }
+
+        free( shard->devs );
+    }
+
+    free( shards );
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4d.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,335 @@
+/*
+    ecg4d.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4d.h
+@brief    ECG_4 Acquisition Daemon
+
+Devices, sinks and shards of ecg4d, the Linux acquisition daemon for ECG_4 clicks on serial ports.
+
+A device is a serial port (USB-serial adapter, or a pty of ecg4_emu) opened non-blocking in raw mode, with its
+own __ecg4_parser context. Its bytes are fed to the parser in whole read buffers, the rows of a packet are kept
+until the checksum verifies the packet, then its raw data samples are collected in blocks and its signal quality
+and heart rate rows are published as events to the sinks.
+
+A shard is an event loop on its own thread, pinned to a core, which owns a share of the devices with their parser
+contexts and buffers, and its own sink instances, so shards share no data and take no locks. It waits with
+epoll, or with io_uring (built with ECG4D_URING) which keeps a read queued on every device and reaps the
+completed reads of all devices with one system call.
+
+The stages sink hands the blocks and events of a shard to a chain of stages on their own threads (filter, QRS
+detection, sinks for storage and output), connected by lock-free queues, see ecg4d_stage.c.
+*/
+
+#include <pthread.h>
+#include <stdint.h>
+#include "__ecg4_parser.h"
+
+#ifndef _ECG4D_H_
+#define _ECG4D_H_
+
+#define ECG4D_FS                512
+#define ECG4D_BUF_SIZE          4096    /**< Read buffer of a device */
+#define ECG4D_BLOCK             64      /**< Samples published in one block at most */
+#define ECG4D_SINKS_MAX         4
+
+#define ECG4D_EV_QUALITY        0x02    /**< Signal quality row */
+#define ECG4D_EV_HEART_RATE     0x03    /**< Heart rate row */
+#define ECG4D_EV_BEAT           0x04    /**< Beat detected by the qrs stage, value is the heart rate, 0 - first */
+#define ECG4D_EV_ERROR          0xFF    /**< Packet with a checksum error */
+
+typedef struct T_ecg4d_dev_s T_ecg4d_dev;
+
+/**
+ * @struct T_ecg4d_sink_ops
+ * @brief Sink implementation
+ */
+typedef struct
+{
+    const char  *name;
+    const char  *help;
+    void        *( *open )( const char *arg, int shard );  /**< Returns the sink context, 0 - error */
+    void        ( *samples )( void *ctx, const T_ecg4d_dev *dev, uint64_t index, const int16_t *samples,
+                              uint16_t n_samples );
+    void        ( *event )( void *ctx, const T_ecg4d_dev *dev, uint64_t index, uint8_t code, uint8_t value );
+    void        ( *flush )( void *ctx );
+    void        ( *close )( void *ctx );
+    void        ( *stats )( void *ctx, uint64_t interval_ns );     /**< Writes the statistics, NULL - none */
+
+}T_ecg4d_sink_ops;
+
+/**
+ * @struct T_ecg4d_sink
+ * @brief Opened sink
+ */
+typedef struct
+{
+    const T_ecg4d_sink_ops *ops;
+    void                   *ctx;
+
+}T_ecg4d_sink;
+
+/**
+ * @struct T_ecg4d_stats
+ * @brief Device statistics
+ */
+typedef struct
+{
+    uint64_t bytes;
+    uint64_t wakeups;
+    uint64_t reads;
+    uint64_t packets;
+    uint64_t errors;            /**< Packets with a checksum error */
+    uint64_t samples;
+    uint64_t events;
+    uint64_t cpu_ns;            /**< Thread CPU time spent reading, parsing and publishing */
+    uint64_t proc_ns;           /**< Wall time from the wake-up to the published samples, summed over wake-ups */
+    uint64_t proc_ns_max;
+    int64_t  lag_ns;            /**< Last lag of the sample clock behind the wall clock */
+    int64_t  lag_ns_min;
+    int64_t  lag_ns_max;
+
+}T_ecg4d_stats;
+
+/**
+ * @struct T_ecg4d_dev
+ * @brief Device
+ */
+struct T_ecg4d_dev_s
+{
+    int             fd;
+    uint16_t        id;
+    const char      *path;
+    T_ecg4_parser   parser;
+    uint8_t         rows[ 512 ];        /**< Rows of the packet being parsed, code, size, data */
+    uint16_t        rows_len;
+    int16_t         block[ ECG4D_BLOCK ];
+    uint16_t        block_len;
+    uint64_t        index;              /**< Index of the next sample */
+    uint64_t        t_first;            /**< Wall time of the first sample */
+    T_ecg4d_sink    *sinks;
+    uint8_t         n_sinks;
+    T_ecg4d_stats   stats;
+    uint8_t         buf[ ECG4D_BUF_SIZE ];
+};
+
+/**
+ * @struct T_ecg4d_shard
+ * @brief Event loop thread with the devices it owns
+ */
+typedef struct
+{
+    uint16_t        id;
+    int             cpu;                /**< CPU the thread is pinned to, -1 - not pinned */
+    uint8_t         uring;              /**< Wait with io_uring instead of epoll */
+    T_ecg4d_dev     *devs;
+    uint16_t        n_devs;
+    T_ecg4d_sink    sinks[ ECG4D_SINKS_MAX ];
+    uint8_t         n_sinks;
+    uint64_t        stats_ns;           /**< Statistics interval, 0 - statistics on exit only */
+    uint64_t        end_ns;             /**< ecg4d_now time to stop at, UINT64_MAX - never */
+    volatile int    *stop;              /**< Set by the signal handler */
+    pthread_t       thread;
+
+}T_ecg4d_shard;
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Time function
+ *
+ * @returns CLOCK_MONOTONIC time in ns
+ */
+uint64_t ecg4d_now( void );
+
+/**
+ * @brief Device Baud function
+ *
+ * @param[in] baud  Baud rate
+ *
+ * @returns 0 - the ports can be set to the baud rate, -1 - not supported
+ */
+int ecg4d_dev_baud( uint32_t baud );
+
+/**
+ * @brief Device Open function
+ *
+ * @param[out] dev      Device
+ * @param[in]  path     Serial port, a tty is set to raw mode at the baud rate
+ * @param[in]  id       Device number used by the sinks
+ * @param[in]  baud     Baud rate
+ * @param[in]  sinks    Sinks the device publishes to
+ * @param[in]  n_sinks  Number of sinks
+ *
+ * @returns 0 - success, -1 - error (errno is set, EINVAL - baud rate not supported)
+ */
+int ecg4d_dev_open( T_ecg4d_dev *dev, const char *path, uint16_t id, uint32_t baud, T_ecg4d_sink *sinks,
+                    uint8_t n_sinks );
+
+/**
+ * @brief Device Read function
+ *
+ * @param[in] dev     Device
+ * @param[in] t_wake  Wall time of the wake-up (ecg4d_now)
+ *
+ * @returns 0 - no more data for now, -1 - end of file or error, the device should be closed
+ *
+ * Function reads the device until it would block, feeds the parser and publishes the verified packets.
+ */
+int ecg4d_dev_read( T_ecg4d_dev *dev, uint64_t t_wake );
+
+/**
+ * @brief Device Input function
+ *
+ * @param[in] dev     Device
+ * @param[in] len     Bytes read into dev->buf
+ * @param[in] t_wake  Wall time of the wake-up (ecg4d_now)
+ *
+ * Function feeds the parser with a read completed elsewhere (io_uring) and publishes the verified packets.
+ */
+void ecg4d_dev_input( T_ecg4d_dev *dev, uint16_t len, uint64_t t_wake );
+
+/**
+ * @brief Device Close function
+ */
+void ecg4d_dev_close( T_ecg4d_dev *dev );
+
+/**
+ * @brief Sink Open function
+ *
+ * @param[out] sink   Sink
+ * @param[in]  spec   name[:argument]
+ * @param[in]  shard  Shard the instance is for, appended to file names, -1 - single shard
+ *
+ * @returns 0 - success, -1 - unknown sink or error
+ */
+int ecg4d_sink_open( T_ecg4d_sink *sink, const char *spec, int shard );
+
+/**
+ * @brief Sink Usage function
+ *
+ * Function prints the available sinks.
+ */
+void ecg4d_sink_usage( void );
+
+/**
+ * @brief Stages Open function
+ *
+ * @param[in] arg    Stages, stage[@cpu][=argument],... see ecg4d_stage.c
+ * @param[in] shard  Shard the chain is for, -1 - single shard
+ *
+ * @returns Stages sink context, 0 - error
+ *
+ * Function opens the stages and starts a thread per stage. The other ecg4d_stage_ functions are the sink
+ * operations of the stages sink.
+ */
+void *ecg4d_stage_open( const char *arg, int shard );
+
+void ecg4d_stage_samples( void *ctx, const T_ecg4d_dev *dev, uint64_t index, const int16_t *samples,
+                          uint16_t n_samples );
+
+void ecg4d_stage_event( void *ctx, const T_ecg4d_dev *dev, uint64_t index, uint8_t code, uint8_t value );
+
+/**
+ * @brief Stages Flush function
+ *
+ * Function queues the blocks of the devices whose oldest sample waited long enough, and publishes the blocks
+ * queued since the last call to the first stage.
+ */
+void ecg4d_stage_flush( void *ctx );
+
+void ecg4d_stage_stats( void *ctx, uint64_t interval_ns );
+
+/**
+ * @brief Stages Close function
+ *
+ * Function lets every stage process the queued blocks, stops the threads and closes the stages.
+ */
+void ecg4d_stage_close( void *ctx );
+
+/**
+ * @brief Shard Run function
+ *
+ * @param[in] shard  Shard, with its devices and sinks open
+ *
+ * @returns 0 - stopped, or no device left, -1 - error
+ *
+ * Function runs the event loop of the shard on the calling thread, and writes the statistics of its devices.
+ */
+int ecg4d_shard_run( T_ecg4d_shard *shard );
+
+/**
+ * @brief Shard Start function
+ *
+ * @param[in] shard  Shard, with its devices and sinks open
+ *
+ * @returns 0 - success, -1 - error
+ *
+ * Function runs ecg4d_shard_run on a new thread, pinned to shard->cpu. A pinning failure is reported on stderr
+ * and the shard runs unpinned.
+ */
+int ecg4d_shard_start( T_ecg4d_shard *shard );
+
+/**
+ * @brief Shard Join function
+ *
+ * Function waits for the thread of ecg4d_shard_start.
+ */
+void ecg4d_shard_join( T_ecg4d_shard *shard );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4d.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,409 @@
+/*
+    ecg4d_dev.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4d_dev.c
+@brief    ECG_4 Acquisition Daemon Devices
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "ecg4d.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define DEV_RAW_DATA_CODE       0x80
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+// the parser handler has no context argument, the device being fed is set around the parser calls, per thread
+static __thread T_ecg4d_dev *dev_cur;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static speed_t dev_speed( uint32_t baud )
+{
+    switch (baud)
+    {
+        case 9600 :
+            return B9600;
+        case 19200 :
+            return B19200;
+        case 38400 :
+            return B38400;
+        case 57600 :
+            return B57600;
+        case 115200 :
+            return B115200;
+        case 230400 :
+            return B230400;
+#ifdef B460800
+        case 460800 :
+            return B460800;
+#endif
+#ifdef B921600
+        case 921600 :
+            return B921600;
+#endif
+        default :
+            return B0;
+    }
+}
+
+static uint64_t dev_cpu( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void dev_publish( T_ecg4d_dev *dev )
+{
+    uint8_t cnt;
+
+    if (dev->block_len == 0)
+    {
+        return;
+    }
+
+    for (cnt = 0; cnt < dev->n_sinks; cnt++)
+    {
+        dev->sinks[ cnt ].ops->samples( dev->sinks[ cnt ].ctx, dev, dev->index - dev->block_len, dev->block,
+                                        dev->block_len );
+    }
+
+    dev->block_len = 0;
+}
+
+static void dev_event( T_ecg4d_dev *dev, uint8_t code, uint8_t value )
+{
+    uint8_t cnt;
+
+    dev_publish( dev );
+    dev->stats.events++;
+
+    for (cnt = 0; cnt < dev->n_sinks; cnt++)
+    {
+        dev->sinks[ cnt ].ops->event( dev->sinks[ cnt ].ctx, dev, dev->index, code, value );
+    }
+}
+
+static void dev_packet( T_ecg4d_dev *dev )
+{
+    uint16_t idx;
+    int16_t sample;
+
+    for (idx = 0; idx < dev->rows_len; idx += dev->rows[ idx + 1 ] + 2)
+    {
+        if ((dev->rows[ idx ] == DEV_RAW_DATA_CODE) && (dev->rows[ idx + 1 ] == 2))
+        {
+            sample = (int16_t)((dev->rows[ idx + 2 ] << 8) | dev->rows[ idx + 3 ]);
+
+            if (dev->index == 0)
+            {
+                dev->t_first = ecg4d_now();
+            }
+
+            dev->block[ dev->block_len++ ] = sample;
+            dev->index++;
+            dev->stats.samples++;
+
+            if (dev->block_len == ECG4D_BLOCK)
+            {
+                dev_publish( dev );
+            }
+        }
+        else if ((dev->rows[ idx ] == ECG4D_EV_QUALITY) || (dev->rows[ idx ] == ECG4D_EV_HEART_RATE))
+        {
+            dev_event( dev, dev->rows[ idx ], dev->rows[ idx + 2 ] );
+        }
+    }
+
+    dev->rows_len = 0;
+}
+
+static void dev_row( uint8_t *op_code, uint8_t *row_size, uint8_t *rx_buff, uint8_t *row_cnt )
+{
+    T_ecg4d_dev *dev;
+    uint8_t cnt;
+
+    dev = dev_cur;
+
+    if (*row_cnt == 0)
+    {
+        dev->rows_len = 0;
+    }
+
+    if ((size_t)dev->rows_len + *row_size + 2 > sizeof( dev->rows ))
+    {
+        return;
+    }
+
+    dev->rows[ dev->rows_len ] = *op_code;
+    dev->rows[ dev->rows_len + 1 ] = *row_size;
+
+    for (cnt = 0; cnt < *row_size; cnt++)
+    {
+        dev->rows[ dev->rows_len + 2 + cnt ] = rx_buff[ cnt ];
+    }
+
+    dev->rows_len += *row_size + 2;
+}
+
+static void dev_feed( T_ecg4d_dev *dev, const uint8_t *buf, uint16_t len )
+{
+    uint16_t used;
+    uint8_t res;
+
+    dev_cur = dev;
+
+    while (len != 0)
+    {
+        res = ecg4_parser_block( &dev->parser, buf, len, &used );
+        buf += used;
+        len -= used;
+
+        if (res & _ECG4_PARSER_PACKET)
+        {
+            dev->stats.packets++;
+            dev_packet( dev );
+        }
+        else if (res & _ECG4_PARSER_ERROR)
+        {
+            dev->stats.errors++;
+            dev->rows_len = 0;
+            dev_event( dev, ECG4D_EV_ERROR, 0 );
+        }
+    }
+
+    dev_cur = 0;
+}
+
+static void dev_lag( T_ecg4d_dev *dev, uint64_t now )
+{
+    int64_t lag;
+
+    if (dev->index == 0)
+    {
+        return;
+    }
+
+    // wall time since the first sample minus the sample clock: grows with buffering, delays and lost samples
+    lag = (int64_t)(now - dev->t_first) - (int64_t)((dev->index - 1) * 1000000000ull / ECG4D_FS);
+    dev->stats.lag_ns = lag;
+
+    if (lag < dev->stats.lag_ns_min)
+    {
+        dev->stats.lag_ns_min = lag;
+    }
+
+    if (lag > dev->stats.lag_ns_max)
+    {
+        dev->stats.lag_ns_max = lag;
+    }
+}
+
+static void dev_done( T_ecg4d_dev *dev, uint64_t t_wake, uint64_t cpu )
+{
+    uint64_t now;
+    uint64_t proc;
+
+    dev_publish( dev );
+    now = ecg4d_now();
+    dev_lag( dev, now );
+    proc = now - t_wake;
+    dev->stats.wakeups++;
+    dev->stats.proc_ns += proc;
+
+    if (proc > dev->stats.proc_ns_max)
+    {
+        dev->stats.proc_ns_max = proc;
+    }
+
+    dev->stats.cpu_ns += dev_cpu() - cpu;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+uint64_t ecg4d_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+int ecg4d_dev_baud( uint32_t baud )
+{
+    return (dev_speed( baud ) != B0) ? 0 : -1;
+}
+
+int ecg4d_dev_open( T_ecg4d_dev *dev, const char *path, uint16_t id, uint32_t baud, T_ecg4d_sink *sinks,
+                    uint8_t n_sinks )
+{
+    struct termios tio;
+
+    if (dev_speed( baud ) == B0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    dev->fd = open( path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC );
+
+    if (dev->fd < 0)
+    {
+        return -1;
+    }
+
+    if (isatty( dev->fd ) && (tcgetattr( dev->fd, &tio ) == 0))
+    {
+        cfmakeraw( &tio );
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[ VMIN ] = 1;
+        tio.c_cc[ VTIME ] = 0;
+        cfsetispeed( &tio, dev_speed( baud ) );
+        cfsetospeed( &tio, dev_speed( baud ) );
+
+        if (tcsetattr( dev->fd, TCSANOW, &tio ) != 0)
+        {
+            close( dev->fd );
+            return -1;
+        }
+
+        tcflush( dev->fd, TCIFLUSH );
+    }
+
+    dev->id = id;
+    dev->path = path;
+    ecg4_parser_init( &dev->parser, &dev_row );
+    dev->rows_len = 0;
+    dev->block_len = 0;
+    dev->index = 0;
+    dev->t_first = 0;
+    dev->sinks = sinks;
+    dev->n_sinks = n_sinks;
+    memset( &dev->stats, 0, sizeof( dev->stats ) );
+    dev->stats.lag_ns_min = INT64_MAX;
+    dev->stats.lag_ns_max = INT64_MIN;
+
+    return 0;
+}
+
+int ecg4d_dev_read( T_ecg4d_dev *dev, uint64_t t_wake )
+{
+    uint64_t cpu;
+    ssize_t res;
+    int ret;
+
+    cpu = dev_cpu();
+    ret = 0;
+
+    while (1)
+    {
+        res = read( dev->fd, dev->buf, sizeof( dev->buf ) );
+
+        if (res > 0)
+        {
+            dev->stats.reads++;
+            dev->stats.bytes += res;
+            dev_feed( dev, dev->buf, (uint16_t)res );
+            continue;
+        }
+
+        if ((res < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+
+        if ((res == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+        {
+            // end of file, or EIO from a pty whose master is gone
+            ret = -1;
+        }
+
+        break;
+    }
+
+    dev_done( dev, t_wake, cpu );
+
+    return ret;
+}
+
+void ecg4d_dev_input( T_ecg4d_dev *dev, uint16_t len, uint64_t t_wake )
+{
+    uint64_t cpu;
+
+    cpu = dev_cpu();
+    dev->stats.reads++;
+    dev->stats.bytes += len;
+    dev_feed( dev, dev->buf, len );
+    dev_done( dev, t_wake, cpu );
+}
+
+void ecg4d_dev_close( T_ecg4d_dev *dev )
+{
+    if (dev->fd >= 0)
+    {
+        close( dev->fd );
+        dev->fd = -1;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4d_dev.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
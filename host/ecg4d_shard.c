@@ -0,0 +1,565 @@
+/*
+    ecg4d_shard.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4d_shard.c
+@brief    ECG_4 Acquisition Daemon Shards
+
+Event loops of ecg4d. Every shard waits for its own devices only, so a slow or noisy device delays the devices
+of its shard, never the others, and shards scale with the cores as long as the devices are spread over them.
+
+The io_uring loop is built with ECG4D_URING, on the raw system calls (Linux 5.11 or later, no liburing). A read
+is kept queued on every device, the completed reads of all devices are reaped with one io_uring_enter call,
+which also queues the next reads, instead of one epoll_wait and one read per device and wake-up.
+*/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "ecg4d.h"
+
+#ifdef ECG4D_URING
+#include <linux/io_uring.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define SHARD_EVENTS            64
+#define SHARD_POLL_MS           200     /**< Longest wait, the stop flag is checked in between */
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+#ifdef ECG4D_URING
+
+typedef struct
+{
+    int                 fd;
+    unsigned            *sq_tail;
+    unsigned            *sq_mask;
+    unsigned            *sq_array;
+    unsigned            *cq_head;
+    unsigned            *cq_tail;
+    unsigned            *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void                *sq_ptr;
+    size_t              sq_len;
+    void                *cq_ptr;
+    size_t              cq_len;
+    size_t              sqes_len;
+    unsigned            to_submit;
+
+}T_shard_uring;
+
+#endif
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void shard_stats( T_ecg4d_shard *shard, T_ecg4d_stats *prev, uint64_t interval_ns )
+{
+    T_ecg4d_dev *dev;
+    T_ecg4d_stats *st;
+    T_ecg4d_stats *pr;
+    uint64_t wakeups;
+    uint16_t cnt;
+    double lag_ms;
+    double lag_max_ms;
+
+    for (cnt = 0; cnt < shard->n_devs; cnt++)
+    {
+        dev = &shard->devs[ cnt ];
+        st = &dev->stats;
+        pr = &prev[ cnt ];
+        wakeups = st->wakeups - pr->wakeups;
+        lag_ms = 0;
+        lag_max_ms = 0;
+
+        if (st->lag_ns_max != INT64_MIN)
+        {
+            lag_ms = (st->lag_ns - st->lag_ns_min) * 1e-6;
+            lag_max_ms = (st->lag_ns_max - st->lag_ns_min) * 1e-6;
+        }
+
+        fprintf( stderr, "ecg4d: %u %s%s: shard %u, %.1f samples/s, %llu packets, %llu errors, cpu %.3f%%, "
+                         "proc %.1f / %.1f us, lag %.1f / %.1f ms\n",
+                 dev->id, dev->path, (dev->fd < 0) ? " (closed)" : "", shard->id,
+                 (st->samples - pr->samples) * 1e9 / interval_ns, (unsigned long long)st->packets,
+                 (unsigned long long)st->errors, (st->cpu_ns - pr->cpu_ns) * 100.0 / interval_ns,
+                 (wakeups != 0) ? (st->proc_ns - pr->proc_ns) * 1e-3 / wakeups : 0.0, st->proc_ns_max * 1e-3,
+                 lag_ms, lag_max_ms );
+        *pr = *st;
+    }
+
+    for (cnt = 0; cnt < shard->n_sinks; cnt++)
+    {
+        if (shard->sinks[ cnt ].ops->stats != NULL)
+        {
+            shard->sinks[ cnt ].ops->stats( shard->sinks[ cnt ].ctx, interval_ns );
+        }
+    }
+}
+
+static void shard_flush( T_ecg4d_shard *shard )
+{
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < shard->n_sinks; cnt++)
+    {
+        shard->sinks[ cnt ].ops->flush( shard->sinks[ cnt ].ctx );
+    }
+}
+
+static int shard_timeout( T_ecg4d_shard *shard, uint64_t t_stats, uint64_t now )
+{
+    uint64_t t_next;
+
+    t_next = now + SHARD_POLL_MS * 1000000ull;
+
+    if ((shard->stats_ns != 0) && (t_stats + shard->stats_ns < t_next))
+    {
+        t_next = t_stats + shard->stats_ns;
+    }
+
+    if (shard->end_ns < t_next)
+    {
+        t_next = shard->end_ns;
+    }
+
+    return (t_next > now) ? (int)((t_next - now) / 1000000 + 1) : 0;
+}
+
+static void shard_close( T_ecg4d_shard *shard, T_ecg4d_dev *dev, uint16_t *n_open )
+{
+    fprintf( stderr, "ecg4d: %u %s: closed, shard %u\n", dev->id, dev->path, shard->id );
+    ecg4d_dev_close( dev );
+    (*n_open)--;
+}
+
+static int shard_epoll( T_ecg4d_shard *shard, T_ecg4d_stats *prev )
+{
+    struct epoll_event evs[ SHARD_EVENTS ];
+    struct epoll_event ev;
+    T_ecg4d_dev *dev;
+    uint64_t t_stats;
+    uint64_t t_wake;
+    uint16_t n_open;
+    uint16_t cnt;
+    int epfd;
+    int n;
+    int i;
+
+    epfd = epoll_create1( EPOLL_CLOEXEC );
+
+    if (epfd < 0)
+    {
+        return -1;
+    }
+
+    n_open = 0;
+
+    for (cnt = 0; cnt < shard->n_devs; cnt++)
+    {
+        ev.events = EPOLLIN;
+        ev.data.ptr = &shard->devs[ cnt ];
+
+        if (epoll_ctl( epfd, EPOLL_CTL_ADD, shard->devs[ cnt ].fd, &ev ) != 0)
+        {
+            close( epfd );
+            return -1;
+        }
+
+        n_open++;
+    }
+
+    t_stats = ecg4d_now();
+
+    while (!*shard->stop && (n_open != 0))
+    {
+        t_wake = ecg4d_now();
+
+        if (t_wake >= shard->end_ns)
+        {
+            break;
+        }
+
+        n = epoll_wait( epfd, evs, SHARD_EVENTS, shard_timeout( shard, t_stats, t_wake ) );
+
+        if ((n < 0) && (errno != EINTR))
+        {
+            close( epfd );
+            return -1;
+        }
+
+        t_wake = ecg4d_now();
+
+        for (i = 0; i < n; i++)
+        {
+            dev = evs[ i ].data.ptr;
+
+            if (ecg4d_dev_read( dev, t_wake ) != 0)
+            {
+                epoll_ctl( epfd, EPOLL_CTL_DEL, dev->fd, NULL );
+                shard_close( shard, dev, &n_open );
+            }
+        }
+
+        shard_flush( shard );
+
+        if ((shard->stats_ns != 0) && (t_wake - t_stats >= shard->stats_ns))
+        {
+            shard_stats( shard, prev, t_wake - t_stats );
+            t_stats = t_wake;
+        }
+    }
+
+    close( epfd );
+    t_wake = ecg4d_now();
+    shard_stats( shard, prev, (t_wake > t_stats) ? t_wake - t_stats : 1 );
+
+    return 0;
+}
+
+#ifdef ECG4D_URING
+
+static int uring_setup( T_shard_uring *ring, unsigned entries )
+{
+    struct io_uring_params p;
+
+    memset( &p, 0, sizeof( p ) );
+    ring->fd = (int)syscall( __NR_io_uring_setup, entries, &p );
+
+    if (ring->fd < 0)
+    {
+        return -1;
+    }
+
+    ring->sq_len = p.sq_off.array + p.sq_entries * sizeof( unsigned );
+    ring->cq_len = p.cq_off.cqes + p.cq_entries * sizeof( struct io_uring_cqe );
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring->cq_len > ring->sq_len)
+        {
+            ring->sq_len = ring->cq_len;
+        }
+
+        ring->cq_len = ring->sq_len;
+    }
+
+    ring->sq_ptr = mmap( NULL, ring->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_SQ_RING );
+    ring->cq_ptr = ring->sq_ptr;
+
+    if ((ring->sq_ptr != MAP_FAILED) && !(p.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        ring->cq_ptr = mmap( NULL, ring->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                             IORING_OFF_CQ_RING );
+    }
+
+    ring->sqes_len = p.sq_entries * sizeof( struct io_uring_sqe );
+    ring->sqes = mmap( NULL, ring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                       IORING_OFF_SQES );
+
+    if ((ring->sq_ptr == MAP_FAILED) || (ring->cq_ptr == MAP_FAILED) || (ring->sqes == MAP_FAILED))
+    {
+        close( ring->fd );
+        return -1;
+    }
+
+    ring->sq_tail = (unsigned*)((char*)ring->sq_ptr + p.sq_off.tail);
+    ring->sq_mask = (unsigned*)((char*)ring->sq_ptr + p.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)((char*)ring->sq_ptr + p.sq_off.array);
+    ring->cq_head = (unsigned*)((char*)ring->cq_ptr + p.cq_off.head);
+    ring->cq_tail = (unsigned*)((char*)ring->cq_ptr + p.cq_off.tail);
+    ring->cq_mask = (unsigned*)((char*)ring->cq_ptr + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)((char*)ring->cq_ptr + p.cq_off.cqes);
+    ring->to_submit = 0;
+
+    return 0;
+}
+
+static void uring_close( T_shard_uring *ring )
+{
+    munmap( ring->sqes, ring->sqes_len );
+
+    if (ring->cq_ptr != ring->sq_ptr)
+    {
+        munmap( ring->cq_ptr, ring->cq_len );
+    }
+
+    munmap( ring->sq_ptr, ring->sq_len );
+    close( ring->fd );
+}
+
+static void uring_read( T_shard_uring *ring, T_ecg4d_dev *dev )
+{
+    struct io_uring_sqe *sqe;
+    unsigned tail;
+    unsigned idx;
+
+    tail = *ring->sq_tail;
+    idx = tail & *ring->sq_mask;
+    sqe = &ring->sqes[ idx ];
+    memset( sqe, 0, sizeof( *sqe ) );
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = dev->fd;
+    sqe->addr = (uintptr_t)dev->buf;
+    sqe->len = sizeof( dev->buf );
+    sqe->off = (uint64_t)-1;
+    sqe->user_data = (uintptr_t)dev;
+    ring->sq_array[ idx ] = idx;
+    __atomic_store_n( ring->sq_tail, tail + 1, __ATOMIC_RELEASE );
+    ring->to_submit++;
+}
+
+static int uring_wait( T_shard_uring *ring, int timeout_ms )
+{
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    int res;
+
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000ll;
+    memset( &arg, 0, sizeof( arg ) );
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = (uintptr_t)&ts;
+
+    res = (int)syscall( __NR_io_uring_enter, ring->fd, ring->to_submit, 1,
+                        IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof( arg ) );
+
+    if (res >= 0)
+    {
+        ring->to_submit -= res;
+    }
+    else if ((errno == ETIME) || (errno == EINTR))
+    {
+        res = 0;
+    }
+
+    return res;
+}
+
+static int shard_uring( T_ecg4d_shard *shard, T_ecg4d_stats *prev )
+{
+    T_shard_uring ring;
+    struct io_uring_cqe *cqe;
+    T_ecg4d_dev *dev;
+    uint64_t t_stats;
+    uint64_t t_wake;
+    unsigned head;
+    uint16_t n_open;
+    uint16_t cnt;
+    int flags;
+
+    if (uring_setup( &ring, shard->n_devs ) != 0)
+    {
+        return -1;
+    }
+
+    n_open = 0;
+
+    for (cnt = 0; cnt < shard->n_devs; cnt++)
+    {
+        dev = &shard->devs[ cnt ];
+
+        // blocking reads, io_uring waits for the data itself instead of completing with EAGAIN
+        flags = fcntl( dev->fd, F_GETFL );
+        fcntl( dev->fd, F_SETFL, flags & ~O_NONBLOCK );
+        uring_read( &ring, dev );
+        n_open++;
+    }
+
+    t_stats = ecg4d_now();
+
+    while (!*shard->stop && (n_open != 0))
+    {
+        t_wake = ecg4d_now();
+
+        if (t_wake >= shard->end_ns)
+        {
+            break;
+        }
+
+        if (uring_wait( &ring, shard_timeout( shard, t_stats, t_wake ) ) < 0)
+        {
+            uring_close( &ring );
+            return -1;
+        }
+
+        t_wake = ecg4d_now();
+        head = *ring.cq_head;
+
+        while (head != __atomic_load_n( ring.cq_tail, __ATOMIC_ACQUIRE ))
+        {
+            cqe = &ring.cqes[ head & *ring.cq_mask ];
+            dev = (T_ecg4d_dev*)(uintptr_t)cqe->user_data;
+            head++;
+
+            if ((cqe->res > 0) || (cqe->res == -EAGAIN) || (cqe->res == -EINTR))
+            {
+                if (cqe->res > 0)
+                {
+                    ecg4d_dev_input( dev, (uint16_t)cqe->res, t_wake );
+                }
+
+                uring_read( &ring, dev );
+            }
+            else
+            {
+                shard_close( shard, dev, &n_open );
+            }
+        }
+
+        __atomic_store_n( ring.cq_head, head, __ATOMIC_RELEASE );
+        shard_flush( shard );
+
+        if ((shard->stats_ns != 0) && (t_wake - t_stats >= shard->stats_ns))
+        {
+            shard_stats( shard, prev, t_wake - t_stats );
+            t_stats = t_wake;
+        }
+    }
+
+    // the reads still queued are cancelled when the ring is closed
+    uring_close( &ring );
+    t_wake = ecg4d_now();
+    shard_stats( shard, prev, (t_wake > t_stats) ? t_wake - t_stats : 1 );
+
+    return 0;
+}
+
+#endif
+
+static void *shard_thread( void *arg )
+{
+    T_ecg4d_shard *shard;
+
+    shard = arg;
+
+    if (ecg4d_shard_run( shard ) != 0)
+    {
+        fprintf( stderr, "ecg4d: shard %u: %s\n", shard->id, strerror( errno ) );
+    }
+
+    return NULL;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int ecg4d_shard_run( T_ecg4d_shard *shard )
+{
+    T_ecg4d_stats *prev;
+    int res;
+
+    prev = calloc( shard->n_devs + 1, sizeof( T_ecg4d_stats ) );
+
+    if (prev == NULL)
+    {
+        return -1;
+    }
+
+#ifdef ECG4D_URING
+    if (shard->uring)
+    {
+        res = shard_uring( shard, prev );
+        free( prev );
+
+        return res;
+    }
+#endif
+
+    res = shard_epoll( shard, prev );
+    free( prev );
+
+    return res;
+}
+
+int ecg4d_shard_start( T_ecg4d_shard *shard )
+{
+    cpu_set_t set;
+    int err;
+
+    if (pthread_create( &shard->thread, NULL, &shard_thread, shard ) != 0)
+    {
+        return -1;
+    }
+
+    if (shard->cpu >= 0)
+    {
+        CPU_ZERO( &set );
+        CPU_SET( shard->cpu, &set );
+        err = pthread_setaffinity_np( shard->thread, sizeof( set ), &set );
+
+        if (err != 0)
+        {
+            fprintf( stderr, "ecg4d: shard %u: cannot pin to cpu %d, running unpinned: %s\n",
+                     shard->id, shard->cpu, strerror( err ) );
+        }
+    }
+
+    return 0;
+}
+
+void ecg4d_shard_join( T_ecg4d_shard *shard )
+{
+    pthread_join( shard->thread, NULL );
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4d_shard.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
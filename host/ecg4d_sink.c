@@ -0,0 +1,235 @@
+/*
+    ecg4d_sink.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4d_sink.c
+@brief    ECG_4 Acquisition Daemon Sinks
+
+Sinks of ecg4d, selected with -k name[:argument]. A new sink is a T_ecg4d_sink_ops entry in sink_table.
+The stages sink is in ecg4d_stage.c.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ecg4d.h"
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static FILE *sink_file( const char *arg, int shard )
+{
+    char path[ 4096 ];
+
+    if ((arg == NULL) || (strcmp( arg, "-" ) == 0))
+    {
+        return stdout;
+    }
+
+    if (shard < 0)
+    {
+        return fopen( arg, "w" );
+    }
+
+    // a file per shard, stdout is shared through the stdio lock
+    snprintf( path, sizeof( path ), "%s.%d", arg, shard );
+
+    return fopen( path, "w" );
+}
+
+static void sink_file_flush( void *ctx )
+{
+    fflush( (FILE*)ctx );
+}
+
+static void sink_file_close( void *ctx )
+{
+    if ((FILE*)ctx != stdout)
+    {
+        fclose( (FILE*)ctx );
+    }
+    else
+    {
+        fflush( stdout );
+    }
+}
+
+/* null */
+
+static void *null_open( const char *arg, int shard )
+{
+    (void)arg;
+    (void)shard;
+
+    return (void*)1;
+}
+
+static void null_samples( void *ctx, const T_ecg4d_dev *dev, uint64_t index, const int16_t *samples,
+                          uint16_t n_samples )
+{
+    (void)ctx; (void)dev; (void)index; (void)samples; (void)n_samples;
+}
+
+static void null_event( void *ctx, const T_ecg4d_dev *dev, uint64_t index, uint8_t code, uint8_t value )
+{
+    (void)ctx; (void)dev; (void)index; (void)code; (void)value;
+}
+
+static void null_flush( void *ctx )
+{
+    (void)ctx;
+}
+
+/* csv */
+
+static void *csv_open( const char *arg, int shard )
+{
+    return sink_file( arg, shard );
+}
+
+static void csv_samples( void *ctx, const T_ecg4d_dev *dev, uint64_t index, const int16_t *samples,
+                         uint16_t n_samples )
+{
+    uint16_t cnt;
+
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        fprintf( (FILE*)ctx, "%u,%llu,%d\n", dev->id, (unsigned long long)(index + cnt), samples[ cnt ] );
+    }
+}
+
+/* events */
+
+static void *events_open( const char *arg, int shard )
+{
+    return sink_file( arg, shard );
+}
+
+static void events_event( void *ctx, const T_ecg4d_dev *dev, uint64_t index, uint8_t code, uint8_t value )
+{
+    const char *name;
+
+    if (code == ECG4D_EV_QUALITY)
+    {
+        name = "quality";
+    }
+    else if (code == ECG4D_EV_HEART_RATE)
+    {
+        name = "heart_rate";
+    }
+    else if (code == ECG4D_EV_BEAT)
+    {
+        name = "beat";
+    }
+    else
+    {
+        name = "checksum_error";
+    }
+
+    fprintf( (FILE*)ctx, "%u %s %llu %s %u\n", dev->id, dev->path, (unsigned long long)index, name, value );
+}
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static const T_ecg4d_sink_ops sink_table[] =
+{
+    { "null",   "discards everything (parser and transport load only)",
+      &null_open, &null_samples, &null_event, &null_flush, &null_flush, NULL },
+    { "csv",    "csv[:file] - one device,index,value line per raw data sample (default stdout)",
+      &csv_open, &csv_samples, &null_event, &sink_file_flush, &sink_file_close, NULL },
+    { "events", "events[:file] - signal quality, heart rate, beat and checksum error events (default stdout)",
+      &events_open, &null_samples, &events_event, &sink_file_flush, &sink_file_close, NULL },
+    { "stages", "stages[:stage,...] - chain of stage threads, filter, qrs and sinks (default filter,qrs,events)",
+      &ecg4d_stage_open, &ecg4d_stage_samples, &ecg4d_stage_event, &ecg4d_stage_flush, &ecg4d_stage_close,
+      &ecg4d_stage_stats },
+};
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+int ecg4d_sink_open( T_ecg4d_sink *sink, const char *spec, int shard )
+{
+    const char *arg;
+    size_t len;
+    uint8_t cnt;
+
+    arg = strchr( spec, ':' );
+    len = (arg != NULL) ? (size_t)(arg - spec) : strlen( spec );
+
+    if (arg != NULL)
+    {
+        arg++;
+    }
+
+    for (cnt = 0; cnt < sizeof( sink_table ) / sizeof( sink_table[ 0 ] ); cnt++)
+    {
+        if ((strlen( sink_table[ cnt ].name ) == len) && (strncmp( sink_table[ cnt ].name, spec, len ) == 0))
+        {
+            sink->ops = &sink_table[ cnt ];
+            sink->ctx = sink->ops->open( arg, shard );
+
+            return (sink->ctx != NULL) ? 0 : -1;
+        }
+    }
+
+    return -1;
+}
+
+void ecg4d_sink_usage( void )
+{
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < sizeof( sink_table ) / sizeof( sink_table[ 0 ] ); cnt++)
+    {
+        fprintf( stderr, "    %-8s %s\n", sink_table[ cnt ].name, sink_table[ cnt ].help );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4d_sink.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
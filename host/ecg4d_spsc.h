@@ -0,0 +1,256 @@
+/*
+    ecg4d_spsc.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4d_spsc.h
+@brief    ECG_4 Acquisition Daemon Block Queue
+
+Bounded lock-free single producer, single consumer queue of fixed size slots, used by the ecg4d stages to hand
+sample blocks from one thread to the next.
+
+The producer writes a block straight into the slot returned by ecg4d_spsc_claim, queues it with ecg4d_spsc_push
+and makes the queued slots visible with ecg4d_spsc_publish, once per batch. The consumer sees the published
+slots with ecg4d_spsc_peek, reads them in place with ecg4d_spsc_slot and frees them with ecg4d_spsc_release,
+again once per batch. So a batch of blocks costs one release store and one acquire load on each side, whatever
+its length.
+
+The consumer index, the producer index and the read-only fields are on their own cache lines, and each side
+keeps a copy of the other side's index, which it reloads only when the queue looks full or empty, so in the
+steady state the two threads do not bounce a cache line per block. Slots are padded to whole cache lines.
+*/
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _ECG4D_SPSC_H_
+#define _ECG4D_SPSC_H_
+
+#define ECG4D_CACHE_LINE        64
+
+/**
+ * @struct T_ecg4d_spsc
+ * @brief Queue
+ */
+typedef struct
+{
+    _Alignas( ECG4D_CACHE_LINE ) atomic_uint head;      /**< Next slot to read, written by the consumer */
+    uint32_t        head_local;         /**< Read, not yet released */
+    uint32_t        tail_cache;         /**< Consumer's copy of tail */
+
+    _Alignas( ECG4D_CACHE_LINE ) atomic_uint tail;      /**< Next slot to write, written by the producer */
+    uint32_t        tail_local;         /**< Written, not yet published */
+    uint32_t        head_cache;         /**< Producer's copy of head */
+
+    _Alignas( ECG4D_CACHE_LINE ) uint8_t *slots;
+    uint32_t        slot_size;
+    uint32_t        mask;
+    atomic_int      closed;             /**< No more slots will be published */
+
+}T_ecg4d_spsc;
+
+/**
+ * @brief Queue Init function
+ *
+ * @param[out] q          Queue
+ * @param[in]  slot_size  Size of a slot in bytes, rounded up to whole cache lines
+ * @param[in]  n_slots    Number of slots, a power of 2
+ *
+ * @returns 0 - success, -1 - error
+ */
+static inline int ecg4d_spsc_init( T_ecg4d_spsc *q, size_t slot_size, uint32_t n_slots )
+{
+    if ((n_slots == 0) || ((n_slots & (n_slots - 1)) != 0))
+    {
+        return -1;
+    }
+
+    memset( q, 0, sizeof( *q ) );
+    q->slot_size = (uint32_t)((slot_size + ECG4D_CACHE_LINE - 1) & ~(size_t)(ECG4D_CACHE_LINE - 1));
+    q->mask = n_slots - 1;
+    q->slots = aligned_alloc( ECG4D_CACHE_LINE, (size_t)q->slot_size * n_slots );
+
+    return (q->slots != NULL) ? 0 : -1;
+}
+
+/**
+ * @brief Queue Free function
+ */
+static inline void ecg4d_spsc_free( T_ecg4d_spsc *q )
+{
+    free( q->slots );
+    q->slots = NULL;
+}
+
+/**
+ * @brief Queue Publish function
+ *
+ * Function makes the pushed slots visible to the consumer (producer side).
+ */
+static inline void ecg4d_spsc_publish( T_ecg4d_spsc *q )
+{
+    if (atomic_load_explicit( &q->tail, memory_order_relaxed ) != q->tail_local)
+    {
+        atomic_store_explicit( &q->tail, q->tail_local, memory_order_release );
+    }
+}
+
+/**
+ * @brief Queue Claim function
+ *
+ * @returns Free slot to write, NULL - queue full
+ *
+ * Function returns the next free slot (producer side). When the queue looks full, the pushed slots are
+ * published first, so a full queue is never waiting for the producer itself.
+ */
+static inline void *ecg4d_spsc_claim( T_ecg4d_spsc *q )
+{
+    if (q->tail_local - q->head_cache > q->mask)
+    {
+        ecg4d_spsc_publish( q );
+        q->head_cache = atomic_load_explicit( &q->head, memory_order_acquire );
+
+        if (q->tail_local - q->head_cache > q->mask)
+        {
+            return NULL;
+        }
+    }
+
+    return q->slots + (size_t)(q->tail_local & q->mask) * q->slot_size;
+}
+
+/**
+ * @brief Queue Push function
+ *
+ * Function queues the slot returned by ecg4d_spsc_claim (producer side), it is seen by the consumer after
+ * the next ecg4d_spsc_publish.
+ */
+static inline void ecg4d_spsc_push( T_ecg4d_spsc *q )
+{
+    q->tail_local++;
+}
+
+/**
+ * @brief Queue Close function
+ *
+ * Function publishes the pushed slots and tells the consumer that no more will follow (producer side).
+ */
+static inline void ecg4d_spsc_close( T_ecg4d_spsc *q )
+{
+    ecg4d_spsc_publish( q );
+    atomic_store_explicit( &q->closed, 1, memory_order_release );
+}
+
+/**
+ * @brief Queue Peek function
+ *
+ * @returns Number of published slots not yet released, the queue occupancy
+ *
+ * Function returns the number of slots the consumer can read (consumer side).
+ */
+static inline uint32_t ecg4d_spsc_peek( T_ecg4d_spsc *q )
+{
+    if (q->tail_cache == q->head_local)
+    {
+        q->tail_cache = atomic_load_explicit( &q->tail, memory_order_acquire );
+    }
+
+    return q->tail_cache - q->head_local;
+}
+
+/**
+ * @brief Queue Slot function
+ *
+ * @param[in] q    Queue
+ * @param[in] idx  Slot from the oldest one, less than ecg4d_spsc_peek
+ *
+ * @returns Slot to read
+ */
+static inline void *ecg4d_spsc_slot( T_ecg4d_spsc *q, uint32_t idx )
+{
+    return q->slots + (size_t)((q->head_local + idx) & q->mask) * q->slot_size;
+}
+
+/**
+ * @brief Queue Release function
+ *
+ * @param[in] q  Queue
+ * @param[in] n  Number of slots read
+ *
+ * Function frees the oldest slots for the producer (consumer side).
+ */
+static inline void ecg4d_spsc_release( T_ecg4d_spsc *q, uint32_t n )
+{
+    q->head_local += n;
+    atomic_store_explicit( &q->head, q->head_local, memory_order_release );
+}
+
+/**
+ * @brief Queue Done function
+ *
+ * @returns 1 - closed and every published slot released, 0 - more slots may follow
+ */
+static inline int ecg4d_spsc_done( T_ecg4d_spsc *q )
+{
+    if (!atomic_load_explicit( &q->closed, memory_order_acquire ))
+    {
+        return 0;
+    }
+
+    // tail is final once closed is seen
+    q->tail_cache = atomic_load_explicit( &q->tail, memory_order_acquire );
+
+    return q->tail_cache == q->head_local;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4d_spsc.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
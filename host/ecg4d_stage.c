@@ -0,0 +1,1006 @@
+/*
+    ecg4d_stage.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   ecg4d_stage.c
+@brief    ECG_4 Acquisition Daemon Stages
+
+The stages sink of ecg4d: the sample blocks and events a shard publishes are handed to a chain of stages, each
+on its own thread, connected by bounded single producer, single consumer queues (ecg4d_spsc.h):
+
+    -k stages:filter,qrs,csv=ecg.csv,events=beats.txt
+
+The shard only copies the block into the first queue, so a slow stage never stalls the parsing. When the
+first queue is full the block is dropped and counted; between stages a full queue makes the stage wait, so a
+slow stage backs up its upstream stages first, and the drops start when the backlog reaches the shard. Blocks
+are handed over whole and in batches: the shard publishes the blocks of a wake-up at once, a stage takes all
+the blocks queued for it, then publishes them to the next stage at once.
+
+A wake-up usually brings a few samples of a device only, so the samples of each device are gathered into a
+block of ECG4D_BLOCK samples before they enter the chain. A partial block enters when the next samples are not
+contiguous or an event of the same device comes, so the events stay in order with the samples, and at the
+first flush after its oldest sample waited STAGE_AGE_NS. The shard flushes after every wake-up and waits
+SHARD_POLL_MS at most, so the last samples of a device that stops sending get through all the same.
+
+A stage is name[@cpu][=argument], @cpu pins its thread to a core:
+
+    filter[=50|60|off]   high-pass and mains notch (__ecg4_filter) of the samples, in place, 50 Hz by default
+    qrs                  QRS detection (__ecg4_qrs) on the samples, the beats are forwarded as beat events
+    <sink>[=argument]    any ecg4d sink (csv, events, null), for storage or output, it passes the blocks on
+
+The filter and QRS detector contexts are kept per device and restarted when a block is missing, after a drop.
+Without an argument the chain is filter,qrs,events.
+
+With the statistics of the shard a line per stage is written: blocks and samples per second, the time the stage
+was busy, the occupancy of its input queue (mean / max over the batches it took), the latency from the arrival
+of the oldest sample of a block to the block processed by the stage (mean / max) and the times its output queue
+was full, all over the interval. The line at the end has the totals and the maxima since the start.
+*/
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ecg4d.h"
+#include "ecg4d_spsc.h"
+#include "__ecg4_filter.h"
+#include "__ecg4_qrs.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define STAGE_MAX               8
+#define STAGE_DEPTH             1024        /**< Blocks per queue */
+#define STAGE_BEATS             (ECG4D_BLOCK / 100 + 2)
+#define STAGE_SPIN              64          /**< Yields on an empty or full queue before sleeping */
+#define STAGE_SLEEP_NS          200000
+#define STAGE_AGE_NS            200000000   /**< Longest wait of a sample for its block to fill, a block is 125 ms */
+#define STAGE_DEFAULT           "filter,qrs,events"
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+/**
+ * @struct T_stage_block
+ * @brief Queue slot, a sample block or an event
+ */
+typedef struct
+{
+    const T_ecg4d_dev   *dev;
+    uint64_t            index;                      /**< Index of the first sample, or of the event */
+    uint64_t            t_in;                       /**< ecg4d_now at the arrival of the first sample */
+    uint16_t            n_samples;                  /**< 0 - event */
+    uint8_t             code;
+    uint8_t             value;
+    uint8_t             n_beats;
+    uint8_t             beat_bpm[ STAGE_BEATS ];    /**< 0 - first beat of the device */
+    uint64_t            beat_index[ STAGE_BEATS ];  /**< Sample index of the R peak */
+    int16_t             samples[ ECG4D_BLOCK ];
+
+}T_stage_block;
+
+/**
+ * @struct T_stage_metrics
+ * @brief Stage metrics, written by the stage thread only
+ */
+typedef struct
+{
+    uint64_t blocks;
+    uint64_t samples;
+    uint64_t batches;
+    uint64_t busy_ns;
+    uint64_t occ_sum;               /**< Input queue occupancy summed over the batches */
+    uint64_t occ_max;
+    uint64_t lat_ns;                /**< Latency from the entry summed over the blocks */
+    uint64_t lat_ns_max;
+    uint64_t full;                  /**< Output queue found full */
+
+}T_stage_metrics;
+
+typedef struct T_stage_s T_stage;
+
+/**
+ * @struct T_stage_ops
+ * @brief Stage implementation
+ */
+typedef struct
+{
+    const char  *name;
+    size_t      state_size;         /**< Context per device, 0 - none */
+    int         ( *open )( T_stage *st, const char *arg, int shard );
+    void        ( *block )( T_stage *st, T_stage_block *blk );
+    void        ( *idle )( T_stage *st );
+    void        ( *close )( T_stage *st );
+
+}T_stage_ops;
+
+/**
+ * @struct T_stage
+ * @brief Stage, with its input queue
+ */
+struct T_stage_s
+{
+    T_ecg4d_spsc        in;
+    T_ecg4d_spsc        *out;       /**< Input of the next stage, NULL - last stage */
+    const T_stage_ops   *ops;
+    char                name[ 32 ];
+    int                 cpu;        /**< -1 - not pinned */
+    uint8_t             notch;
+    T_ecg4d_sink        sink;
+    uint8_t             *state;     /**< Per device contexts, by device id */
+    uint32_t            n_state;
+    pthread_t           thread;
+    uint8_t             running;
+    T_stage_metrics     m;
+    T_stage_metrics     shared;     /**< Copy of m for the statistics, atomic per field, the maxima are
+                                         since the last statistics, the shard resets them */
+    T_stage_metrics     prev;       /**< Last statistics, shard thread only */
+};
+
+/**
+ * @struct T_stage_pend
+ * @brief Block of a device being filled by the shard
+ */
+typedef struct
+{
+    const T_ecg4d_dev   *dev;
+    uint64_t            index;
+    uint64_t            t_in;
+    uint16_t            n_samples;      /**< 0 - no block */
+    int16_t             samples[ ECG4D_BLOCK ];
+
+}T_stage_pend;
+
+/**
+ * @struct T_stage_chain
+ * @brief Stages sink context of a shard
+ */
+typedef struct
+{
+    T_stage             *stages;
+    uint8_t             n_stages;
+    T_stage_pend        *pend;          /**< Blocks being filled, by device id */
+    uint32_t            n_pend;
+    int                 shard;
+    uint64_t            dropped;
+    uint64_t            prev_dropped;
+
+}T_stage_chain;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void *stage_state( T_stage *st, const T_ecg4d_dev *dev )
+{
+    uint8_t *state;
+    uint32_t n;
+
+    if (dev->id >= st->n_state)
+    {
+        n = (dev->id + 64u) & ~63u;
+        state = realloc( st->state, n * st->ops->state_size );
+
+        if (state == NULL)
+        {
+            return NULL;
+        }
+
+        memset( state + st->n_state * st->ops->state_size, 0, (n - st->n_state) * st->ops->state_size );
+        st->state = state;
+        st->n_state = n;
+    }
+
+    return st->state + dev->id * st->ops->state_size;
+}
+
+static void stage_wait( uint32_t *spins )
+{
+    struct timespec ts;
+
+    if (++*spins < STAGE_SPIN)
+    {
+        sched_yield();
+        return;
+    }
+
+    ts.tv_sec = 0;
+    ts.tv_nsec = STAGE_SLEEP_NS;
+    nanosleep( &ts, NULL );
+}
+
+/* filter */
+
+typedef struct
+{
+    T_ecg4_filter   flt;
+    uint64_t        next;
+    uint8_t         used;
+
+}T_stage_filter;
+
+static int filter_open( T_stage *st, const char *arg, int shard )
+{
+    (void)shard;
+
+    if ((arg == NULL) || (strcmp( arg, "50" ) == 0))
+    {
+        st->notch = _ECG4_FILTER_NOTCH_50HZ;
+    }
+    else if (strcmp( arg, "60" ) == 0)
+    {
+        st->notch = _ECG4_FILTER_NOTCH_60HZ;
+    }
+    else if (strcmp( arg, "off" ) == 0)
+    {
+        st->notch = _ECG4_FILTER_NOTCH_OFF;
+    }
+    else
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void filter_block( T_stage *st, T_stage_block *blk )
+{
+    T_stage_filter *ctx;
+
+    if ((blk->n_samples == 0) || ((ctx = stage_state( st, blk->dev )) == NULL))
+    {
+        return;
+    }
+
+    if (!ctx->used || (blk->index != ctx->next))
+    {
+        ecg4_filter_init( &ctx->flt, 7, st->notch );
+        ctx->used = 1;
+    }
+
+    ecg4_filter_block( &ctx->flt, blk->samples, blk->n_samples );
+    ctx->next = blk->index + blk->n_samples;
+}
+
+/* qrs */
+
+typedef struct
+{
+    T_ecg4_qrs      qrs;
+    uint64_t        base;           /**< Device index of the first sample of the detector */
+    uint64_t        next;
+    uint64_t        last_beat;
+    uint8_t         used;
+
+}T_stage_qrs;
+
+static int qrs_open( T_stage *st, const char *arg, int shard )
+{
+    (void)st;
+    (void)shard;
+
+    return (arg == NULL) ? 0 : -1;
+}
+
+static void qrs_block( T_stage *st, T_stage_block *blk )
+{
+    T_stage_qrs *ctx;
+    uint32_t beats[ STAGE_BEATS ];
+    uint64_t rr;
+    uint16_t n;
+    uint16_t cnt;
+
+    if ((blk->n_samples == 0) || ((ctx = stage_state( st, blk->dev )) == NULL))
+    {
+        return;
+    }
+
+    if (!ctx->used || (blk->index != ctx->next))
+    {
+        ecg4_qrs_init( &ctx->qrs );
+        ctx->base = blk->index;
+        ctx->last_beat = UINT64_MAX;
+        ctx->used = 1;
+    }
+
+    n = ecg4_qrs_process_block( &ctx->qrs, blk->samples, blk->n_samples, beats, STAGE_BEATS );
+
+    for (cnt = 0; (cnt < n) && (blk->n_beats < STAGE_BEATS); cnt++)
+    {
+        blk->beat_index[ blk->n_beats ] = ctx->base + beats[ cnt ];
+        rr = (ctx->last_beat != UINT64_MAX) ? blk->beat_index[ blk->n_beats ] - ctx->last_beat : 0;
+        blk->beat_bpm[ blk->n_beats ] = (rr == 0) ? 0 : (rr < 60 * ECG4D_FS / 255) ? 255 :
+                                                          (uint8_t)(60 * ECG4D_FS / rr);
+        ctx->last_beat = blk->beat_index[ blk->n_beats ];
+        blk->n_beats++;
+    }
+
+    ctx->next = blk->index + blk->n_samples;
+}
+
+/* sinks */
+
+static int sink_open( T_stage *st, const char *arg, int shard )
+{
+    char spec[ 4096 ];
+
+    if (arg != NULL)
+    {
+        snprintf( spec, sizeof( spec ), "%s:%s", st->name, arg );
+    }
+    else
+    {
+        snprintf( spec, sizeof( spec ), "%s", st->name );
+    }
+
+    return ecg4d_sink_open( &st->sink, spec, shard );
+}
+
+static void sink_block( T_stage *st, T_stage_block *blk )
+{
+    uint8_t cnt;
+
+    if (blk->n_samples != 0)
+    {
+        st->sink.ops->samples( st->sink.ctx, blk->dev, blk->index, blk->samples, blk->n_samples );
+    }
+    else
+    {
+        st->sink.ops->event( st->sink.ctx, blk->dev, blk->index, blk->code, blk->value );
+    }
+
+    for (cnt = 0; cnt < blk->n_beats; cnt++)
+    {
+        st->sink.ops->event( st->sink.ctx, blk->dev, blk->beat_index[ cnt ], ECG4D_EV_BEAT,
+                             blk->beat_bpm[ cnt ] );
+    }
+}
+
+static void sink_idle( T_stage *st )
+{
+    st->sink.ops->flush( st->sink.ctx );
+}
+
+static void sink_close( T_stage *st )
+{
+    st->sink.ops->close( st->sink.ctx );
+}
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static const T_stage_ops stage_table[] =
+{
+    { "filter", sizeof( T_stage_filter ), &filter_open, &filter_block, NULL, NULL },
+    { "qrs",    sizeof( T_stage_qrs ),    &qrs_open,    &qrs_block,    NULL, NULL },
+};
+
+static const T_stage_ops stage_sink = { "sink", 0, &sink_open, &sink_block, &sink_idle, &sink_close };
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void stage_max( uint64_t *max, uint64_t val )
+{
+    uint64_t cur;
+
+    cur = __atomic_load_n( max, __ATOMIC_RELAXED );
+
+    while ((val > cur) && !__atomic_compare_exchange_n( max, &cur, val, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ))
+    {
+    }
+}
+
+static void stage_metrics( T_stage *st )
+{
+    // the statistics are read by the shard thread, every field is stored whole
+    __atomic_store_n( &st->shared.blocks, st->m.blocks, __ATOMIC_RELAXED );
+    __atomic_store_n( &st->shared.samples, st->m.samples, __ATOMIC_RELAXED );
+    __atomic_store_n( &st->shared.batches, st->m.batches, __ATOMIC_RELAXED );
+    __atomic_store_n( &st->shared.busy_ns, st->m.busy_ns, __ATOMIC_RELAXED );
+    __atomic_store_n( &st->shared.occ_sum, st->m.occ_sum, __ATOMIC_RELAXED );
+    __atomic_store_n( &st->shared.lat_ns, st->m.lat_ns, __ATOMIC_RELAXED );
+    __atomic_store_n( &st->shared.full, st->m.full, __ATOMIC_RELAXED );
+}
+
+static void stage_snapshot( T_stage *st, T_stage_metrics *m )
+{
+    m->blocks = __atomic_load_n( &st->shared.blocks, __ATOMIC_RELAXED );
+    m->samples = __atomic_load_n( &st->shared.samples, __ATOMIC_RELAXED );
+    m->batches = __atomic_load_n( &st->shared.batches, __ATOMIC_RELAXED );
+    m->busy_ns = __atomic_load_n( &st->shared.busy_ns, __ATOMIC_RELAXED );
+    m->occ_sum = __atomic_load_n( &st->shared.occ_sum, __ATOMIC_RELAXED );
+    m->lat_ns = __atomic_load_n( &st->shared.lat_ns, __ATOMIC_RELAXED );
+    m->full = __atomic_load_n( &st->shared.full, __ATOMIC_RELAXED );
+
+    // the maxima of the interval, the next one starts from 0
+    m->occ_max = __atomic_exchange_n( &st->shared.occ_max, 0, __ATOMIC_RELAXED );
+    m->lat_ns_max = __atomic_exchange_n( &st->shared.lat_ns_max, 0, __ATOMIC_RELAXED );
+}
+
+static void stage_print( T_stage_chain *chain, uint8_t idx, const T_stage_metrics *m, const T_stage_metrics *pr,
+                         uint64_t interval_ns )
+{
+    uint64_t blocks;
+    uint64_t batches;
+
+    blocks = m->blocks - pr->blocks;
+    batches = m->batches - pr->batches;
+
+    fprintf( stderr, "ecg4d: shard %u stage %u %s: %.1f blocks/s, %.1f samples/s, busy %.2f%%, queue %.1f / %llu "
+                     "of %u, lat %.1f / %.1f us, full %llu\n",
+             (chain->shard < 0) ? 0 : chain->shard, idx, chain->stages[ idx ].name,
+             blocks * 1e9 / interval_ns, (m->samples - pr->samples) * 1e9 / interval_ns,
+             (m->busy_ns - pr->busy_ns) * 100.0 / interval_ns,
+             (batches != 0) ? (double)(m->occ_sum - pr->occ_sum) / batches : 0.0,
+             (unsigned long long)m->occ_max, STAGE_DEPTH,
+             (blocks != 0) ? (m->lat_ns - pr->lat_ns) * 1e-3 / blocks : 0.0, m->lat_ns_max * 1e-3,
+             (unsigned long long)(m->full - pr->full) );
+}
+
+static void stage_run( T_stage *st, uint32_t n )
+{
+    T_stage_block *blk;
+    T_stage_block *dst;
+    uint64_t t_start;
+    uint64_t now;
+    uint64_t lat_max;
+    uint32_t spins;
+    uint32_t cnt;
+
+    t_start = ecg4d_now();
+    lat_max = 0;
+    st->m.batches++;
+    st->m.occ_sum += n;
+
+    if (n > st->m.occ_max)
+    {
+        st->m.occ_max = n;
+    }
+
+    for (cnt = 0; cnt < n; cnt++)
+    {
+        blk = ecg4d_spsc_slot( &st->in, cnt );
+        st->ops->block( st, blk );
+        now = ecg4d_now();
+        st->m.blocks++;
+        st->m.samples += blk->n_samples;
+        st->m.lat_ns += now - blk->t_in;
+
+        if (now - blk->t_in > lat_max)
+        {
+            lat_max = now - blk->t_in;
+        }
+
+        if (st->out != NULL)
+        {
+            spins = 0;
+
+            while ((dst = ecg4d_spsc_claim( st->out )) == NULL)
+            {
+                if (spins == 0)
+                {
+                    st->m.full++;
+                }
+
+                stage_wait( &spins );
+            }
+
+            memcpy( dst, blk, offsetof( T_stage_block, samples ) + blk->n_samples * sizeof( int16_t ) );
+            ecg4d_spsc_push( st->out );
+        }
+    }
+
+    ecg4d_spsc_release( &st->in, n );
+
+    if (st->out != NULL)
+    {
+        ecg4d_spsc_publish( st->out );
+    }
+
+    if (lat_max > st->m.lat_ns_max)
+    {
+        st->m.lat_ns_max = lat_max;
+    }
+
+    st->m.busy_ns += ecg4d_now() - t_start;
+    stage_metrics( st );
+    stage_max( &st->shared.occ_max, n );
+    stage_max( &st->shared.lat_ns_max, lat_max );
+}
+
+static void *stage_thread( void *arg )
+{
+    T_stage *st;
+    uint32_t spins;
+    uint32_t n;
+
+    st = arg;
+    spins = 0;
+
+    for (;;)
+    {
+        n = ecg4d_spsc_peek( &st->in );
+
+        if (n != 0)
+        {
+            stage_run( st, n );
+            spins = 0;
+            continue;
+        }
+
+        if (ecg4d_spsc_done( &st->in ))
+        {
+            break;
+        }
+
+        if ((spins == 0) && (st->ops->idle != NULL))
+        {
+            st->ops->idle( st );
+        }
+
+        stage_wait( &spins );
+    }
+
+    if (st->ops->idle != NULL)
+    {
+        st->ops->idle( st );
+    }
+
+    if (st->out != NULL)
+    {
+        ecg4d_spsc_close( st->out );
+    }
+
+    return NULL;
+}
+
+static int stage_open( T_stage *st, const char *spec, size_t len, int shard )
+{
+    char buf[ 4096 ];
+    char *arg;
+    char *cpu;
+    uint8_t cnt;
+
+    if (len >= sizeof( buf ))
+    {
+        return -1;
+    }
+
+    memcpy( buf, spec, len );
+    buf[ len ] = 0;
+    arg = strchr( buf, '=' );
+
+    if (arg != NULL)
+    {
+        *arg++ = 0;
+    }
+
+    cpu = strchr( buf, '@' );
+    st->cpu = -1;
+
+    if (cpu != NULL)
+    {
+        *cpu++ = 0;
+        st->cpu = atoi( cpu );
+    }
+
+    if ((strlen( buf ) == 0) || (strlen( buf ) >= sizeof( st->name )) || (strcmp( buf, "stages" ) == 0))
+    {
+        return -1;
+    }
+
+    strcpy( st->name, buf );
+    st->ops = &stage_sink;
+
+    for (cnt = 0; cnt < sizeof( stage_table ) / sizeof( stage_table[ 0 ] ); cnt++)
+    {
+        if (strcmp( stage_table[ cnt ].name, buf ) == 0)
+        {
+            st->ops = &stage_table[ cnt ];
+        }
+    }
+
+    if (ecg4d_spsc_init( &st->in, sizeof( T_stage_block ), STAGE_DEPTH ) != 0)
+    {
+        return -1;
+    }
+
+    if (st->ops->open( st, arg, shard ) != 0)
+    {
+        ecg4d_spsc_free( &st->in );
+        return -1;
+    }
+
+    return 0;
+}
+
+static int stage_start( T_stage *st, int shard, uint8_t idx )
+{
+    char name[ 32 ];
+    cpu_set_t set;
+    int err;
+
+    if (pthread_create( &st->thread, NULL, &stage_thread, st ) != 0)
+    {
+        return -1;
+    }
+
+    st->running = 1;
+    snprintf( name, sizeof( name ), "ecg4d-%d.%u", (shard < 0) ? 0 : shard, idx );
+    name[ 15 ] = 0;     // thread names are 15 characters at most
+    pthread_setname_np( st->thread, name );
+
+    if (st->cpu >= 0)
+    {
+        CPU_ZERO( &set );
+        CPU_SET( st->cpu, &set );
+        err = pthread_setaffinity_np( st->thread, sizeof( set ), &set );
+
+        if (err != 0)
+        {
+            fprintf( stderr, "ecg4d: stage %s: cannot pin to cpu %d, running unpinned: %s\n",
+                     st->ops->name, st->cpu, strerror( err ) );
+        }
+    }
+
+    return 0;
+}
+
+static T_stage_block *chain_claim( T_stage_chain *chain, const T_ecg4d_dev *dev, uint64_t index, uint64_t t_in )
+{
+    T_stage_block *blk;
+
+    // the shard never waits for the stages
+    blk = ecg4d_spsc_claim( &chain->stages[ 0 ].in );
+
+    if (blk == NULL)
+    {
+        chain->dropped++;
+        return NULL;
+    }
+
+    blk->dev = dev;
+    blk->index = index;
+    blk->t_in = t_in;
+    blk->n_beats = 0;
+
+    return blk;
+}
+
+static T_stage_pend *chain_pend( T_stage_chain *chain, const T_ecg4d_dev *dev )
+{
+    T_stage_pend *pend;
+    uint32_t n;
+
+    if (dev->id >= chain->n_pend)
+    {
+        n = (dev->id + 64u) & ~63u;
+        pend = realloc( chain->pend, n * sizeof( T_stage_pend ) );
+
+        if (pend == NULL)
+        {
+            return NULL;
+        }
+
+        memset( pend + chain->n_pend, 0, (n - chain->n_pend) * sizeof( T_stage_pend ) );
+        chain->pend = pend;
+        chain->n_pend = n;
+    }
+
+    return &chain->pend[ dev->id ];
+}
+
+static void chain_push( T_stage_chain *chain, T_stage_pend *pend )
+{
+    T_stage_block *blk;
+
+    blk = chain_claim( chain, pend->dev, pend->index, pend->t_in );
+
+    if (blk != NULL)
+    {
+        blk->n_samples = pend->n_samples;
+        memcpy( blk->samples, pend->samples, pend->n_samples * sizeof( int16_t ) );
+        ecg4d_spsc_push( &chain->stages[ 0 ].in );
+    }
+
+    pend->n_samples = 0;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void *ecg4d_stage_open( const char *arg, int shard )
+{
+    T_stage_chain *chain;
+    const char *spec;
+    const char *end;
+    uint8_t n;
+
+    chain = calloc( 1, sizeof( T_stage_chain ) );
+
+    if (chain == NULL)
+    {
+        return NULL;
+    }
+
+    // the queues are cache line aligned
+    chain->stages = aligned_alloc( ECG4D_CACHE_LINE, STAGE_MAX * sizeof( T_stage ) );
+
+    if (chain->stages == NULL)
+    {
+        free( chain );
+        return NULL;
+    }
+
+    memset( chain->stages, 0, STAGE_MAX * sizeof( T_stage ) );
+    chain->shard = shard;
+    spec = (arg != NULL) ? arg : STAGE_DEFAULT;
+
+    for (n = 0; *spec != 0; n++)
+    {
+        end = strchr( spec, ',' );
+
+        if (end == NULL)
+        {
+            end = spec + strlen( spec );
+        }
+
+        if ((n == STAGE_MAX) || (stage_open( &chain->stages[ n ], spec, (size_t)(end - spec), shard ) != 0))
+        {
+            fprintf( stderr, "ecg4d: stage %.*s: unknown or cannot be opened\n", (int)(end - spec), spec );
+            chain->n_stages = n;
+            ecg4d_stage_close( chain );
+            return NULL;
+        }
+
+        if (n != 0)
+        {
+            chain->stages[ n - 1 ].out = &chain->stages[ n ].in;
+        }
+
+        spec = (*end != 0) ? end + 1 : end;
+    }
+
+    chain->n_stages = n;
+
+    if (n == 0)
+    {
+        ecg4d_stage_close( chain );
+        return NULL;
+    }
+
+    for (n = 0; n < chain->n_stages; n++)
+    {
+        if (stage_start( &chain->stages[ n ], shard, n ) != 0)
+        {
+            ecg4d_stage_close( chain );
+            return NULL;
+        }
+    }
+
+    return chain;
+}
+
+void ecg4d_stage_samples( void *ctx, const T_ecg4d_dev *dev, uint64_t index, const int16_t *samples,
+                          uint16_t n_samples )
+{
+    T_stage_chain *chain;
+    T_stage_pend *pend;
+    uint64_t now;
+    uint16_t n;
+
+    chain = ctx;
+    pend = chain_pend( chain, dev );
+
+    if (pend == NULL)
+    {
+        chain->dropped++;
+        return;
+    }
+
+    if ((pend->n_samples != 0) && (index != pend->index + pend->n_samples))
+    {
+        chain_push( chain, pend );
+    }
+
+    now = ecg4d_now();
+
+    while (n_samples != 0)
+    {
+        if (pend->n_samples == 0)
+        {
+            pend->dev = dev;
+            pend->index = index;
+            pend->t_in = now;
+        }
+
+        n = ECG4D_BLOCK - pend->n_samples;
+        n = (n_samples < n) ? n_samples : n;
+        memcpy( pend->samples + pend->n_samples, samples, n * sizeof( int16_t ) );
+        pend->n_samples += n;
+        index += n;
+        samples += n;
+        n_samples -= n;
+
+        if (pend->n_samples == ECG4D_BLOCK)
+        {
+            chain_push( chain, pend );
+        }
+    }
+}
+
+void ecg4d_stage_event( void *ctx, const T_ecg4d_dev *dev, uint64_t index, uint8_t code, uint8_t value )
+{
+    T_stage_chain *chain;
+    T_stage_block *blk;
+    T_stage_pend *pend;
+
+    chain = ctx;
+    pend = chain_pend( chain, dev );
+
+    // the samples before the event go first
+    if ((pend != NULL) && (pend->n_samples != 0))
+    {
+        chain_push( chain, pend );
+    }
+
+    blk = chain_claim( chain, dev, index, ecg4d_now() );
+
+    if (blk != NULL)
+    {
+        blk->n_samples = 0;
+        blk->code = code;
+        blk->value = value;
+        ecg4d_spsc_push( &chain->stages[ 0 ].in );
+    }
+}
+
+void ecg4d_stage_flush( void *ctx )
+{
+    T_stage_chain *chain;
+    uint64_t now;
+    uint32_t cnt;
+
+    chain = ctx;
+    now = ecg4d_now();
+
+    for (cnt = 0; cnt < chain->n_pend; cnt++)
+    {
+        if ((chain->pend[ cnt ].n_samples != 0) && (now - chain->pend[ cnt ].t_in >= STAGE_AGE_NS))
+        {
+            chain_push( chain, &chain->pend[ cnt ] );
+        }
+    }
+
+    ecg4d_spsc_publish( &chain->stages[ 0 ].in );
+}
+
+void ecg4d_stage_stats( void *ctx, uint64_t interval_ns )
+{
+    T_stage_chain *chain;
+    T_stage_metrics m;
+    uint8_t cnt;
+
+    chain = ctx;
+
+    for (cnt = 0; cnt < chain->n_stages; cnt++)
+    {
+        stage_snapshot( &chain->stages[ cnt ], &m );
+        stage_print( chain, cnt, &m, &chain->stages[ cnt ].prev, interval_ns );
+        chain->stages[ cnt ].prev = m;
+    }
+
+    if (chain->dropped != chain->prev_dropped)
+    {
+        fprintf( stderr, "ecg4d: shard %u stages: %llu blocks dropped, first queue full\n",
+                 (chain->shard < 0) ? 0 : chain->shard, (unsigned long long)(chain->dropped - chain->prev_dropped) );
+        chain->prev_dropped = chain->dropped;
+    }
+}
+
+void ecg4d_stage_close( void *ctx )
+{
+    T_stage_chain *chain;
+    T_stage *st;
+    uint64_t blocks;
+    uint32_t idx;
+    uint8_t cnt;
+
+    chain = ctx;
+
+    // every stage drains its queue and closes the next one
+    if (chain->n_stages != 0)
+    {
+        for (idx = 0; idx < chain->n_pend; idx++)
+        {
+            if (chain->pend[ idx ].n_samples != 0)
+            {
+                chain_push( chain, &chain->pend[ idx ] );
+            }
+        }
+
+        ecg4d_spsc_close( &chain->stages[ 0 ].in );
+    }
+
+    for (cnt = 0; cnt < chain->n_stages; cnt++)
+    {
+        st = &chain->stages[ cnt ];
+
+        if (st->running)
+        {
+            pthread_join( st->thread, NULL );
+            blocks = st->m.blocks;
+            fprintf( stderr, "ecg4d: shard %u stage %u %s: done, %llu blocks, %llu samples, lat %.1f / %.1f us, "
+                             "full %llu\n",
+                     (chain->shard < 0) ? 0 : chain->shard, cnt, st->name, (unsigned long long)blocks,
+                     (unsigned long long)st->m.samples, (blocks != 0) ? st->m.lat_ns * 1e-3 / blocks : 0.0,
+                     st->m.lat_ns_max * 1e-3, (unsigned long long)st->m.full );
+        }
+
+        if (st->ops->close != NULL)
+        {
+            st->ops->close( st );
+        }
+
+        ecg4d_spsc_free( &st->in );
+        free( st->state );
+    }
+
+    if (chain->dropped != 0)
+    {
+        fprintf( stderr, "ecg4d: shard %u stages: %llu blocks dropped\n", (chain->shard < 0) ? 0 : chain->shard,
+                 (unsigned long long)chain->dropped );
+    }
+
+    free( chain->pend );
+    free( chain->stages );
+    free( chain );
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  ecg4d_stage.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
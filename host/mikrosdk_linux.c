@@ -0,0 +1,412 @@
+/*
+    mikrosdk_linux.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   mikrosdk_linux.c
+@brief    mikroSDK Stubs for Linux
+
+    gcc -c -O2 -I../library -o mikrosdk_linux.o mikrosdk_linux.c
+
+See example/c/LINUX/Click_ECG_4_LINUX.c for a complete build.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "mikrosdk_linux.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define EEPROM_SIZE             1024
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static uint8_t pin_state[ 2 ][ 12 ];
+static uint8_t delay_real = 0xFF;
+static uint32_t delay_total;
+static uint32_t log_baud = 57600;
+static void ( *elapse_hook )( uint32_t );
+static uint8_t eeprom[ EEPROM_SIZE ];
+static uint8_t eeprom_ready;
+static FILE *eeprom_file;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+#define PIN_FUNCTIONS( bus, pin ) \
+static void pin_set_##bus##_##pin( uint8_t state ) { pin_state[ bus ][ pin ] = state; } \
+static uint8_t pin_get_##bus##_##pin( void ) { return pin_state[ bus ][ pin ]; }
+
+PIN_FUNCTIONS( 0, 0 )  PIN_FUNCTIONS( 0, 1 )  PIN_FUNCTIONS( 0, 2 )  PIN_FUNCTIONS( 0, 3 )
+PIN_FUNCTIONS( 0, 4 )  PIN_FUNCTIONS( 0, 5 )  PIN_FUNCTIONS( 0, 6 )  PIN_FUNCTIONS( 0, 7 )
+PIN_FUNCTIONS( 0, 8 )  PIN_FUNCTIONS( 0, 9 )  PIN_FUNCTIONS( 0, 10 ) PIN_FUNCTIONS( 0, 11 )
+PIN_FUNCTIONS( 1, 0 )  PIN_FUNCTIONS( 1, 1 )  PIN_FUNCTIONS( 1, 2 )  PIN_FUNCTIONS( 1, 3 )
+PIN_FUNCTIONS( 1, 4 )  PIN_FUNCTIONS( 1, 5 )  PIN_FUNCTIONS( 1, 6 )  PIN_FUNCTIONS( 1, 7 )
+PIN_FUNCTIONS( 1, 8 )  PIN_FUNCTIONS( 1, 9 )  PIN_FUNCTIONS( 1, 10 ) PIN_FUNCTIONS( 1, 11 )
+
+#define PIN_OBJECT( bus ) \
+{ \
+    { pin_set_##bus##_0, pin_set_##bus##_1, pin_set_##bus##_2, pin_set_##bus##_3, \
+      pin_set_##bus##_4, pin_set_##bus##_5, pin_set_##bus##_6, pin_set_##bus##_7, \
+      pin_set_##bus##_8, pin_set_##bus##_9, pin_set_##bus##_10, pin_set_##bus##_11 }, \
+    { pin_get_##bus##_0, pin_get_##bus##_1, pin_get_##bus##_2, pin_get_##bus##_3, \
+      pin_get_##bus##_4, pin_get_##bus##_5, pin_get_##bus##_6, pin_get_##bus##_7, \
+      pin_get_##bus##_8, pin_get_##bus##_9, pin_get_##bus##_10, pin_get_##bus##_11 } \
+}
+
+T_mikrobus_gpio _MIKROBUS1_GPIO = PIN_OBJECT( 0 );
+T_mikrobus_gpio _MIKROBUS2_GPIO = PIN_OBJECT( 1 );
+T_mikrobus_uart _MIKROBUS1_UART = { -1, 0, 0, { 0 }, 0, 0 };
+T_mikrobus_uart _MIKROBUS2_UART = { -1, 0, 0, { 0 }, 0, 0 };
+
+static T_mikrobus_uart *uart_get( uint8_t bus )
+{
+    return (bus == _MIKROBUS2) ? &_MIKROBUS2_UART : &_MIKROBUS1_UART;
+}
+
+static speed_t uart_speed( uint32_t baud )
+{
+    switch (baud)
+    {
+        case 9600 :
+            return B9600;
+        case 19200 :
+            return B19200;
+        case 38400 :
+            return B38400;
+        case 115200 :
+            return B115200;
+        default :
+            return B57600;
+    }
+}
+
+static uint8_t delay_is_real( void )
+{
+    const char *env;
+
+    if (delay_real == 0xFF)
+    {
+        env = getenv( "ECG4_DELAY" );
+        delay_real = (env != NULL) && (atoi( env ) != 0);
+    }
+
+    return delay_real;
+}
+
+static void conv( char *output, const char *format, long input )
+{
+    sprintf( output, format, input );
+}
+
+static void eeprom_open( void )
+{
+    const char *path;
+
+    if (eeprom_ready)
+    {
+        return;
+    }
+
+    eeprom_ready = 1;
+    memset( eeprom, 0xFF, EEPROM_SIZE );
+    path = getenv( "ECG4_EEPROM" );
+
+    if (path == NULL)
+    {
+        return;
+    }
+
+    eeprom_file = fopen( path, "r+b" );
+
+    if (eeprom_file == NULL)
+    {
+        eeprom_file = fopen( path, "w+b" );
+    }
+
+    if (eeprom_file == NULL)
+    {
+        perror( path );
+        return;
+    }
+
+    if (fread( eeprom, 1, EEPROM_SIZE, eeprom_file ) != EEPROM_SIZE)
+    {
+        clearerr( eeprom_file );
+    }
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+uint8_t mikrobus_gpioInit( uint8_t bus, uint8_t pin, uint8_t direction )
+{
+    (void)direction;
+
+    if ((bus > _MIKROBUS2) || (pin > _MIKROBUS_SDA_PIN))
+    {
+        return 1;
+    }
+
+    pin_state[ bus ][ pin ] = 0;
+
+    return 0;
+}
+
+uint8_t mikrobus_uartInit( uint8_t bus, const uint32_t *cfg )
+{
+    T_mikrobus_uart *uart;
+    struct termios tio;
+    const char *path;
+
+    uart = uart_get( bus );
+
+    if (uart->rx_idle != 0)
+    {
+        return 0;
+    }
+
+    path = getenv( (bus == _MIKROBUS2) ? "ECG4_UART2" : "ECG4_UART" );
+
+    if ((path == NULL) || (strcmp( path, "-" ) == 0))
+    {
+        uart->fd = STDIN_FILENO;
+    }
+    else
+    {
+        uart->fd = open( path, O_RDWR | O_NOCTTY );
+
+        if (uart->fd < 0)
+        {
+            uart->fd = open( path, O_RDONLY );
+        }
+
+        if (uart->fd < 0)
+        {
+            perror( path );
+            exit( 1 );
+        }
+    }
+
+    if (isatty( uart->fd ) && (tcgetattr( uart->fd, &tio ) == 0))
+    {
+        cfmakeraw( &tio );
+        cfsetispeed( &tio, uart_speed( cfg[ 0 ] ) );
+        cfsetospeed( &tio, uart_speed( cfg[ 0 ] ) );
+        tcsetattr( uart->fd, TCSANOW, &tio );
+    }
+
+    uart->rx_len = 0;
+    uart->rx_pos = 0;
+
+    return 0;
+}
+
+void mikrobus_uartInterrupt( uint8_t bus, void ( *isr )( void ) )
+{
+    uart_get( bus )->rx_isr = isr;
+}
+
+uint8_t mikrobus_pinState( uint8_t bus, uint8_t pin )
+{
+    return pin_state[ bus ][ pin ];
+}
+
+uint8_t mikrobus_logInit( uint8_t port, uint32_t baud )
+{
+    (void)port;
+    log_baud = baud;
+
+    return 0;
+}
+
+uint8_t mikrobus_logWrite( const char *data_, uint8_t format )
+{
+    uint32_t len;
+
+    if (format == _LOG_BYTE)
+    {
+        putchar( *data_ );
+        len = 1;
+    }
+    else
+    {
+        fputs( data_, stdout );
+        len = strlen( data_ );
+    }
+
+    if (format == _LOG_LINE)
+    {
+        fputs( "\r\n", stdout );
+        len += 2;
+    }
+
+    if (elapse_hook != 0)
+    {
+        elapse_hook( (uint32_t)((uint64_t)len * 10 * 1000000 / log_baud) );
+    }
+
+    return 0;
+}
+
+void mikrosdk_elapse_set( void ( *elapse )( uint32_t time_us ) )
+{
+    elapse_hook = elapse;
+}
+
+uint32_t mikrosdk_delay_total( void )
+{
+    return delay_total;
+}
+
+void Delay_ms( uint32_t time_ms )
+{
+    struct timespec ts;
+
+    delay_total += time_ms;
+
+    if (elapse_hook != 0)
+    {
+        elapse_hook( time_ms * 1000 );
+    }
+    else if (delay_is_real())
+    {
+        ts.tv_sec = time_ms / 1000;
+        ts.tv_nsec = (long)(time_ms % 1000) * 1000000;
+        nanosleep( &ts, NULL );
+    }
+}
+
+void Delay_us( uint32_t time_us )
+{
+    if (elapse_hook != 0)
+    {
+        elapse_hook( time_us );
+    }
+    else if (delay_is_real())
+    {
+        usleep( time_us );
+    }
+}
+
+void Delay_100ms( void )
+{
+    Delay_ms( 100 );
+}
+
+void Sound_Init( void *snd_port, uint8_t snd_pin )
+{
+    (void)snd_port;
+    (void)snd_pin;
+}
+
+void Sound_Play( uint16_t freq_in_hz, uint16_t duration_ms )
+{
+    (void)freq_in_hz;
+
+    Delay_ms( duration_ms );
+}
+
+void ByteToStr( uint8_t input, char *output )
+{
+    conv( output, "%3ld", input );
+}
+
+void ShortToStr( int8_t input, char *output )
+{
+    conv( output, "%4ld", input );
+}
+
+void WordToStr( uint16_t input, char *output )
+{
+    conv( output, "%5ld", input );
+}
+
+void IntToStr( int16_t input, char *output )
+{
+    conv( output, "%6ld", input );
+}
+
+void LongWordToStr( uint32_t input, char *output )
+{
+    sprintf( output, "%10lu", (unsigned long)input );
+}
+
+void LongToStr( int32_t input, char *output )
+{
+    conv( output, "%11ld", input );
+}
+
+uint8_t EEPROM_Read( uint16_t address )
+{
+    eeprom_open();
+
+    return eeprom[ address % EEPROM_SIZE ];
+}
+
+void EEPROM_Write( uint16_t address, uint8_t data_ )
+{
+    eeprom_open();
+    address %= EEPROM_SIZE;
+    eeprom[ address ] = data_;
+
+    if (eeprom_file != NULL)
+    {
+        fseek( eeprom_file, address, SEEK_SET );
+        fputc( data_, eeprom_file );
+        fflush( eeprom_file );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  mikrosdk_linux.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,213 @@
+/*
+    mikrosdk_linux.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   mikrosdk_linux.h
+@brief    mikroSDK Stubs for Linux
+
+The mikroSDK and mikroC library calls used by the ECG_4 driver and examples, implemented for a Linux host, so
+the driver (with library/HAL/__HAL_LINUX.c) and Click_ECG_4_LINUX.c can be built with gcc or clang, profiled
+with perf and run against captured data.
+
+- The mikroBUS 1 UART is a file descriptor: a capture file, a pipe or a pty (ECG4_UART, default - stdin).
+  A tty is configured raw at the baud rate given to mikrobus_uartInit.
+- The UART rx interrupt is emulated: while the core is in the idle mode (ecg4_wait_for_data), the routine set by
+  mikrobus_uartInterrupt is called once for every received byte. The end of the input file ends the program.
+- The log is stdout.
+- Delays are skipped and only counted, unless ECG4_DELAY=1, which makes them real. A simulator can take
+  the time of delays and log writes over with mikrosdk_elapse_set, and the UART with rx_idle.
+- GPIO pins only keep their state.
+- The data EEPROM (EEPROM_Read, EEPROM_Write, 1024 bytes, erased to 0xFF) is the file given by ECG4_EEPROM,
+  or kept in memory only. A byte write returns at once, as the PIC18 and AVR data EEPROM finishes it in the
+  background; the caller keeps the bytes written some milliseconds apart.
+*/
+
+#include <stdint.h>
+
+#ifndef _MIKROSDK_LINUX_H_
+#define _MIKROSDK_LINUX_H_
+
+/** @defgroup MIKROSDK_LINUX_VAR Variables */                 /** @{ */
+
+#define _MIKROBUS1              0
+#define _MIKROBUS2              1
+
+#define _MIKROBUS_AN_PIN        0
+#define _MIKROBUS_RST_PIN       1
+#define _MIKROBUS_CS_PIN        2
+#define _MIKROBUS_SCK_PIN       3
+#define _MIKROBUS_MISO_PIN      4
+#define _MIKROBUS_MOSI_PIN      5
+#define _MIKROBUS_PWM_PIN       6
+#define _MIKROBUS_INT_PIN       7
+#define _MIKROBUS_RX_PIN        8
+#define _MIKROBUS_TX_PIN        9
+#define _MIKROBUS_SCL_PIN       10
+#define _MIKROBUS_SDA_PIN       11
+
+#define _GPIO_INPUT             0
+#define _GPIO_OUTPUT            1
+
+#define _UART_8_BIT_DATA        8
+#define _UART_NOPARITY          0
+#define _UART_ONE_STOPBIT       1
+
+#define _LOG_USBUART            0x10
+#define _LOG_USBUART_A          0x11
+#define _LOG_USBUART_B          0x12
+
+#define _LOG_TEXT               0
+#define _LOG_LINE               1
+#define _LOG_BYTE               2
+
+                                                                       /** @} */
+/** @defgroup MIKROSDK_LINUX_TYPES Types */                   /** @{ */
+
+/**
+ * @struct T_mikrobus_gpio
+ * @brief mikroBUS GPIO object, the layout of T_hal_gpioObj
+ */
+typedef struct
+{
+    void    ( *gpioSet[ 12 ] )( uint8_t );
+    uint8_t ( *gpioGet[ 12 ] )( void );
+
+}T_mikrobus_gpio;
+
+/**
+ * @struct T_mikrobus_uart
+ * @brief mikroBUS UART object, the T_hal_uartObj of __HAL_LINUX.c
+ */
+typedef struct
+{
+    int      fd;
+    void     ( *rx_isr )( void );   /**< Emulated rx interrupt routine */
+    void     ( *rx_idle )( void );  /**< Virtual UART: waits for the next byte put in rx_buf instead of reading fd */
+    uint8_t  rx_buf[ 256 ];
+    uint16_t rx_len;
+    uint16_t rx_pos;
+
+}T_mikrobus_uart;
+
+                                                                       /** @} */
+
+extern T_mikrobus_gpio _MIKROBUS1_GPIO;
+extern T_mikrobus_gpio _MIKROBUS2_GPIO;
+extern T_mikrobus_uart _MIKROBUS1_UART;
+extern T_mikrobus_uart _MIKROBUS2_UART;
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup MIKROSDK_LINUX_FUNC Functions */                 /** @{ */
+
+uint8_t mikrobus_gpioInit( uint8_t bus, uint8_t pin, uint8_t direction );
+uint8_t mikrobus_uartInit( uint8_t bus, const uint32_t *cfg );
+uint8_t mikrobus_logInit( uint8_t port, uint32_t baud );
+uint8_t mikrobus_logWrite( const char *data_, uint8_t format );
+
+/**
+ * @brief UART Interrupt function
+ *
+ * @param[in] bus  mikroBUS
+ * @param[in] isr  Rx interrupt routine, 0 - disabled
+ *
+ * Function sets the emulated rx interrupt routine, it takes the place of the interrupt vector and its enable bits.
+ */
+void mikrobus_uartInterrupt( uint8_t bus, void ( *isr )( void ) );
+
+/**
+ * @brief Pin State function
+ *
+ * @returns Last state written to a mikroBUS output pin
+ */
+uint8_t mikrobus_pinState( uint8_t bus, uint8_t pin );
+
+/**
+ * @brief Elapse Hook function
+ *
+ * @param[in] elapse  Function called with the time spent by a delay, a Sound_Play or a log write
+ *                    (at the log baud rate), instead of the real delay, 0 - real time
+ *
+ * Function lets a simulator run the example in virtual time.
+ */
+void mikrosdk_elapse_set( void ( *elapse )( uint32_t time_us ) );
+
+/**
+ * @brief Delay Total function
+ *
+ * @returns Milliseconds of all delays since the start, skipped or not
+ */
+uint32_t mikrosdk_delay_total( void );
+
+void Delay_ms( uint32_t time_ms );
+void Delay_us( uint32_t time_us );
+void Delay_100ms( void );
+
+void Sound_Init( void *snd_port, uint8_t snd_pin );
+void Sound_Play( uint16_t freq_in_hz, uint16_t duration_ms );
+
+void ByteToStr( uint8_t input, char *output );
+void ShortToStr( int8_t input, char *output );
+void WordToStr( uint16_t input, char *output );
+void IntToStr( int16_t input, char *output );
+void LongWordToStr( uint32_t input, char *output );
+void LongToStr( int32_t input, char *output );
+
+uint8_t EEPROM_Read( uint16_t address );
+void EEPROM_Write( uint16_t address, uint8_t data_ );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+/* -------------------------------------------------------------------------- */
+/*
+  mikrosdk_linux.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
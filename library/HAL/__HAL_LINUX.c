@@ -0,0 +1,203 @@
+/*
+    __HAL_LINUX.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __HAL_LINUX.c
+@brief    HAL for a Linux host
+@{
+
+| Global Library Prefix | **HAL**            |
+|:---------------------:|:------------------:|
+| Version               | **3.2.0**          |
+| Date                  | **Sep 2017**       |
+| Developer             | **MikroE FW Team** |
+
+The UART object is the T_mikrobus_uart of host/mikrosdk_linux.h, a file descriptor (capture file, pipe or pty)
+read through a 256 byte buffer. hal_uartIdle stands for the idle mode of the core: it waits for the next byte
+and runs the rx interrupt routine of the object for it, so the driver sees one interrupt per received byte as on
+the target. The end of the input file ends the program, a read or poll error other than an interrupted
+wait ends it with an error. A virtual UART (rx_idle set, see host/ecg4_sim.c) gets
+its bytes in rx_buf from the simulator, which also runs the rx interrupt routine.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "mikrosdk_linux.h"
+
+#ifdef __HAL_UART__
+
+typedef T_mikrobus_uart T_hal_uartObj;
+
+// the HAL interface is declared for every target, the driver does not call all of it
+#define HAL_UNUSED              __attribute__(( unused ))
+
+static T_hal_uartObj *hal_uart;
+
+static uint8_t hal_uartFill( int timeout_ms )
+{
+    struct pollfd pfd;
+    ssize_t res;
+    int ready;
+
+    pfd.fd = hal_uart->fd;
+    pfd.events = POLLIN;
+    ready = poll( &pfd, 1, timeout_ms );
+
+    if (ready <= 0)
+    {
+        if ((ready < 0) && (errno != EINTR))
+        {
+            perror( "uart poll" );
+            exit( 1 );
+        }
+
+        return 0;
+    }
+
+    res = read( hal_uart->fd, hal_uart->rx_buf, sizeof( hal_uart->rx_buf ) );
+
+    if (res < 0)
+    {
+        if ((errno != EINTR) && (errno != EAGAIN))
+        {
+            perror( "uart read" );
+            exit( 1 );
+        }
+
+        return 0;
+    }
+
+    if (res == 0)
+    {
+        if (timeout_ms < 0)
+        {
+            exit( 0 );
+        }
+
+        return 0;
+    }
+
+    hal_uart->rx_len = (uint16_t)res;
+    hal_uart->rx_pos = 0;
+
+    return 1;
+}
+
+static void hal_uartMap(T_HAL_P uartObj)
+{
+    hal_uart = (T_hal_uartObj*)uartObj;
+}
+
+static HAL_UNUSED void hal_uartWrite(uint8_t input)
+{
+    if (write( hal_uart->fd, &input, 1 ) != 1)
+    {
+        return;
+    }
+}
+
+static uint8_t hal_uartRead()
+{
+    // an interrupted wait leaves the buffer empty
+    while (hal_uart->rx_pos == hal_uart->rx_len)
+    {
+        hal_uartFill( -1 );
+    }
+
+    return hal_uart->rx_buf[ hal_uart->rx_pos++ ];
+}
+
+static HAL_UNUSED uint8_t hal_uartReady()
+{
+    if (hal_uart->rx_pos != hal_uart->rx_len)
+    {
+        return 1;
+    }
+
+    if (hal_uart->rx_idle != 0)
+    {
+        return 0;
+    }
+
+    return hal_uartFill( 0 );
+}
+
+static void hal_uartIdle()
+{
+    if (hal_uart->rx_idle != 0)
+    {
+        hal_uart->rx_idle();
+
+        return;
+    }
+
+    if ((hal_uart->rx_pos == hal_uart->rx_len) && !hal_uartFill( -1 ))
+    {
+        return;
+    }
+
+    if (hal_uart->rx_isr != 0)
+    {
+        hal_uart->rx_isr();
+    }
+    else
+    {
+        usleep( 1000 );
+    }
+}
+
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __HAL_LINUX.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,254 @@
+/*
+    __ecg4_capture.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_capture.h"
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_CAPTURE_ARMED                = 0x00;
+const uint8_t _ECG4_CAPTURE_POST_TRIGGER         = 0x01;
+const uint8_t _ECG4_CAPTURE_FROZEN               = 0x02;
+
+const uint8_t _ECG4_CAPTURE_MANUAL               = 0x01;
+const uint8_t _ECG4_CAPTURE_LEADOFF              = 0x02;
+const uint8_t _ECG4_CAPTURE_QUALITY              = 0x03;
+const uint8_t _ECG4_CAPTURE_ARRHYTHMIA           = 0x04;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void capture_freeze( T_ecg4_capture *cap )
+{
+    cap->read_left = cap->pre_len + ECG4_CAPTURE_POST;
+
+    if (cap->head >= cap->read_left)
+    {
+        cap->read_idx = cap->head - cap->read_left;
+    }
+    else
+    {
+        cap->read_idx = cap->head + ECG4_CAPTURE_LEN - cap->read_left;
+    }
+
+    // from now on fill counts the history pushed after the window
+    cap->win_len = cap->read_left;
+    cap->fill = 0;
+    cap->missed = 0;
+    cap->state = _ECG4_CAPTURE_FROZEN;
+}
+
+static uint8_t capture_frozen_push( T_ecg4_capture *cap )
+{
+    if (cap->read_left + cap->fill < ECG4_CAPTURE_LEN)
+    {
+        return 1;
+    }
+
+    // no slot left, the history since the freeze would have a gap, so it restarts after the window
+    cap->missed += cap->fill;
+    cap->fill = 0;
+    cap->win_len = 0;
+    cap->head = cap->read_idx + cap->read_left;
+
+    if (cap->head >= ECG4_CAPTURE_LEN)
+    {
+        cap->head -= ECG4_CAPTURE_LEN;
+    }
+
+    if (cap->read_left < ECG4_CAPTURE_LEN)
+    {
+        return 1;
+    }
+
+    cap->missed++;
+
+    return 0;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_capture_init( T_ecg4_capture *cap )
+{
+    cap->n = 0;
+    cap->reason = 0;
+    cap->trigger_n = 0;
+    cap->missed = 0;
+    cap->head = 0;
+    cap->fill = 0;
+    cap->win_len = 0;
+    cap->state = _ECG4_CAPTURE_ARMED;
+    ecg4_capture_release( cap );
+}
+
+uint8_t ecg4_capture_push( T_ecg4_capture *cap, int16_t sample )
+{
+    cap->n++;
+
+    if ((cap->state == _ECG4_CAPTURE_FROZEN) && !capture_frozen_push( cap ))
+    {
+        return 0;
+    }
+
+    cap->buf[ cap->head ] = sample;
+
+    if (++cap->head == ECG4_CAPTURE_LEN)
+    {
+        cap->head = 0;
+    }
+
+    if (cap->fill < ECG4_CAPTURE_LEN)
+    {
+        cap->fill++;
+    }
+
+    if (cap->state == _ECG4_CAPTURE_POST_TRIGGER)
+    {
+        if (--cap->post_left == 0)
+        {
+            capture_freeze( cap );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t ecg4_capture_trigger( T_ecg4_capture *cap, uint8_t reason )
+{
+    if (cap->state != _ECG4_CAPTURE_ARMED)
+    {
+        return 0;
+    }
+
+    cap->reason = reason;
+    cap->trigger_n = cap->n;
+    cap->pre_len = cap->fill;
+
+    if (cap->pre_len > ECG4_CAPTURE_PRE)
+    {
+        cap->pre_len = ECG4_CAPTURE_PRE;
+    }
+
+    cap->post_left = ECG4_CAPTURE_POST;
+    cap->state = _ECG4_CAPTURE_POST_TRIGGER;
+
+    return 1;
+}
+
+uint8_t ecg4_capture_state( T_ecg4_capture *cap )
+{
+    return cap->state;
+}
+
+uint8_t ecg4_capture_info( T_ecg4_capture *cap, T_ecg4_capture_info *info )
+{
+    if (cap->state != _ECG4_CAPTURE_FROZEN)
+    {
+        return 0;
+    }
+
+    info->reason = cap->reason;
+    info->first_n = cap->trigger_n - cap->pre_len;
+    info->trigger_n = cap->trigger_n;
+    info->len = cap->pre_len + ECG4_CAPTURE_POST;
+    info->missed = cap->missed;
+
+    return 1;
+}
+
+uint16_t ecg4_capture_read( T_ecg4_capture *cap, int16_t *samples, uint16_t max_samples )
+{
+    uint16_t cnt;
+
+    if (cap->state != _ECG4_CAPTURE_FROZEN)
+    {
+        return 0;
+    }
+
+    for (cnt = 0; (cnt < max_samples) && (cnt < cap->read_left); cnt++)
+    {
+        samples[ cnt ] = cap->buf[ cap->read_idx ];
+
+        if (++cap->read_idx == ECG4_CAPTURE_LEN)
+        {
+            cap->read_idx = 0;
+        }
+    }
+
+    cap->read_left -= cnt;
+
+    if (cap->read_left == 0)
+    {
+        ecg4_capture_release( cap );
+    }
+
+    return cnt;
+}
+
+void ecg4_capture_release( T_ecg4_capture *cap )
+{
+    if (cap->state == _ECG4_CAPTURE_FROZEN)
+    {
+        cap->fill += cap->win_len;
+
+        if (cap->fill > ECG4_CAPTURE_LEN)
+        {
+            cap->fill = ECG4_CAPTURE_LEN;
+        }
+    }
+
+    cap->win_len = 0;
+    cap->pre_len = 0;
+    cap->post_left = 0;
+    cap->read_idx = 0;
+    cap->read_left = 0;
+    cap->state = _ECG4_CAPTURE_ARMED;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_capture.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*
+    __ecg4_capture.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_capture.h
+@brief    ECG_4 Event Capture
+*/
+/**
+@defgroup   ECG4_CAPTURE
+@brief      ECG_4 Event Capture
+@{
+
+Pre-trigger capture of the 512 Hz raw data.
+
+Samples are kept in a circular history of ECG4_CAPTURE_PRE + ECG4_CAPTURE_POST samples. A trigger
+(arrhythmia, button press, quality drop, ...) keeps the ECG4_CAPTURE_PRE samples before it, collects
+ECG4_CAPTURE_POST samples after it and freezes the window. The frozen window is read out in chunks of any
+size with ecg4_capture_read, in the background, while ecg4_capture_push keeps writing the history into the
+slots of the ring outside the window, and into the slots already read. The capture is re-armed when the whole
+window has been read, or released, with the window and the samples pushed since as its history, so an event
+during or just after a read out still has its pre-trigger samples. Only when the read out is slower than the
+free slots fill up, the samples since the freeze are dropped, counted as missed, and the history restarts.
+
+The window lengths are set at compile time, by defining ECG4_CAPTURE_PRE and ECG4_CAPTURE_POST in the
+project, and checked against ECG4_CAPTURE_RAM_MAX. It is a fixed RAM budget for the history, not the RAM
+actually free on the target: 1024 bytes on PIC and AVR, 16384 bytes on the other targets by default. Define it
+in the project from the data memory left in the linker statistics of the application to check against that.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_CAPTURE_H_
+#define _ECG4_CAPTURE_H_
+
+/** @defgroup ECG4_CAPTURE_VAR Variables */                   /** @{ */
+
+#ifndef ECG4_CAPTURE_RAM_MAX
+#if defined( __MIKROC_PRO_FOR_PIC__ ) || defined( __MIKROC_PRO_FOR_AVR__ )
+#define ECG4_CAPTURE_RAM_MAX    1024
+#else
+#define ECG4_CAPTURE_RAM_MAX    16384
+#endif
+#endif
+
+#ifndef ECG4_CAPTURE_PRE
+#if ECG4_CAPTURE_RAM_MAX < 16384
+#define ECG4_CAPTURE_PRE        384
+#else
+#define ECG4_CAPTURE_PRE        2048
+#endif
+#endif
+
+#ifndef ECG4_CAPTURE_POST
+#if ECG4_CAPTURE_RAM_MAX < 16384
+#define ECG4_CAPTURE_POST       128
+#else
+#define ECG4_CAPTURE_POST       1024
+#endif
+#endif
+
+#define ECG4_CAPTURE_LEN        ( ECG4_CAPTURE_PRE + ECG4_CAPTURE_POST )
+
+/**
+ * Compilation fails here when the capture history does not fit in ECG4_CAPTURE_RAM_MAX.
+ */
+typedef char T_ecg4_capture_ram_check[ ( ECG4_CAPTURE_LEN * 2 <= ECG4_CAPTURE_RAM_MAX ) ? 1 : -1 ];
+
+extern const uint8_t _ECG4_CAPTURE_ARMED                ;
+extern const uint8_t _ECG4_CAPTURE_POST_TRIGGER         ;
+extern const uint8_t _ECG4_CAPTURE_FROZEN               ;
+
+extern const uint8_t _ECG4_CAPTURE_MANUAL               ;
+extern const uint8_t _ECG4_CAPTURE_LEADOFF              ;
+extern const uint8_t _ECG4_CAPTURE_QUALITY              ;
+extern const uint8_t _ECG4_CAPTURE_ARRHYTHMIA           ;
+
+                                                                       /** @} */
+/** @defgroup ECG4_CAPTURE_TYPES Types */                     /** @{ */
+
+/**
+ * @struct T_ecg4_capture
+ * @brief Event capture context
+ */
+typedef struct
+{
+    int16_t  buf[ ECG4_CAPTURE_LEN ];
+    uint16_t head;          /**< Index of the next write */
+    uint16_t fill;          /**< Valid samples in the history */
+    uint8_t  state;
+    uint8_t  reason;        /**< Trigger reason */
+    uint32_t n;             /**< Index of the next pushed sample */
+    uint32_t trigger_n;     /**< Index of the first sample after the trigger */
+    uint16_t pre_len;       /**< Pre-trigger samples in the window */
+    uint16_t post_left;     /**< Post-trigger samples still to collect */
+    uint16_t read_idx;      /**< Index of the next read */
+    uint16_t read_left;     /**< Samples still to read */
+    uint16_t win_len;       /**< Window samples contiguous with the history pushed while frozen, 0 - after a gap */
+    uint32_t missed;        /**< Samples pushed while frozen and not kept in the history */
+
+}T_ecg4_capture;
+
+/**
+ * @struct T_ecg4_capture_info
+ * @brief Frozen window description
+ */
+typedef struct
+{
+    uint8_t  reason;        /**< Trigger reason */
+    uint32_t first_n;       /**< Sample index of the first sample of the window */
+    uint32_t trigger_n;     /**< Sample index of the first sample after the trigger */
+    uint16_t len;           /**< Samples in the window */
+    uint32_t missed;        /**< Samples pushed while frozen and not kept in the history, up to now */
+
+}T_ecg4_capture_info;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_CAPTURE_FUNC Event Capture Functions */    /** @{ */
+
+/**
+ * @brief Capture Init function
+ *
+ * @param[in] cap  Event capture context
+ *
+ * Function empties the history and arms the capture.
+ */
+void ecg4_capture_init( T_ecg4_capture *cap );
+
+/**
+ * @brief Capture Push function
+ *
+ * @param[in] cap     Event capture context
+ * @param[in] sample  Raw data sample
+ *
+ * @returns 1 - window frozen by this sample, 0 - otherwise
+ */
+uint8_t ecg4_capture_push( T_ecg4_capture *cap, int16_t sample );
+
+/**
+ * @brief Capture Trigger function
+ *
+ * @param[in] cap     Event capture context
+ * @param[in] reason  Trigger reason, _ECG4_CAPTURE_MANUAL, _ECG4_CAPTURE_LEADOFF, ... or an application code
+ *
+ * @returns 1 - trigger accepted, 0 - a window is already being captured or read
+ */
+uint8_t ecg4_capture_trigger( T_ecg4_capture *cap, uint8_t reason );
+
+/**
+ * @brief Capture State function
+ *
+ * @returns _ECG4_CAPTURE_ARMED, _ECG4_CAPTURE_POST_TRIGGER or _ECG4_CAPTURE_FROZEN
+ */
+uint8_t ecg4_capture_state( T_ecg4_capture *cap );
+
+/**
+ * @brief Capture Info function
+ *
+ * @param[in]  cap   Event capture context
+ * @param[out] info  Frozen window description
+ *
+ * @returns 1 - window frozen, 0 - no frozen window
+ */
+uint8_t ecg4_capture_info( T_ecg4_capture *cap, T_ecg4_capture_info *info );
+
+/**
+ * @brief Capture Read function
+ *
+ * @param[in]  cap          Event capture context
+ * @param[out] samples      Samples of the frozen window, oldest first
+ * @param[in]  max_samples  Size of the samples array
+ *
+ * @returns Number of samples read, 0 - no frozen window
+ *
+ * Function reads the next chunk of the frozen window and re-arms the capture when the window has been read.
+ */
+uint16_t ecg4_capture_read( T_ecg4_capture *cap, int16_t *samples, uint16_t max_samples );
+
+/**
+ * @brief Capture Release function
+ *
+ * @param[in] cap  Event capture context
+ *
+ * Function drops the captured window, if any, and re-arms the capture. The history is kept.
+ */
+void ecg4_capture_release( T_ecg4_capture *cap );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_capture.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
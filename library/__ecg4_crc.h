@@ -0,0 +1,102 @@
+/*
+    __ecg4_crc.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_crc.h
+@brief    ECG_4 CRC
+*/
+/**
+@defgroup   ECG4_CRC
+@brief      ECG_4 CRC
+@{
+
+CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF, no reflection), computed bitwise without a table.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_CRC_H_
+#define _ECG4_CRC_H_
+
+/** @defgroup ECG4_CRC_VAR Variables */                       /** @{ */
+
+/**
+ * @macro ECG4_CRC16_INIT
+ * @brief Initial CRC value
+ */
+#define ECG4_CRC16_INIT     0xFFFF
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_CRC_FUNC CRC Functions */                  /** @{ */
+
+/**
+ * @brief CRC-16 function
+ *
+ * @param[in] crc  ECG4_CRC16_INIT, or the CRC of the preceding data
+ * @param[in] buf  Data
+ * @param[in] len  Number of bytes
+ *
+ * @returns CRC of the data
+ */
+uint16_t ecg4_crc16( uint16_t crc, const uint8_t *buf, uint16_t len );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_crc.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
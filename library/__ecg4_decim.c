@@ -0,0 +1,239 @@
+/*
+    __ecg4_decim.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_decim.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define DECIM_LEVEL_UP_PCT      75
+#define DECIM_LEVEL_DOWN_PCT    25
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void decim_window_start( T_ecg4_decim *dec )
+{
+    dec->win_len = (uint16_t)1 << (dec->level + 1);
+    dec->win_cnt = 0;
+}
+
+static void decim_drain( T_ecg4_decim *dec, uint32_t drain_q8 )
+{
+    if (dec->queue_q8 > drain_q8)
+    {
+        dec->queue_q8 -= drain_q8;
+    }
+    else
+    {
+        dec->queue_q8 = 0;
+    }
+}
+
+static void decim_elapse( T_ecg4_decim *dec )
+{
+    uint32_t now;
+    uint32_t elapsed;
+
+    now = dec->clock();
+    elapsed = now - dec->last_ms;
+    dec->last_ms = now;
+
+    // a long pause empties the queue, without overflowing the product
+    if (elapsed > dec->queue_q8 / dec->rate_q8)
+    {
+        dec->queue_q8 = 0;
+    }
+    else
+    {
+        decim_drain( dec, elapsed * dec->rate_q8 );
+    }
+}
+
+static void decim_adapt( T_ecg4_decim *dec )
+{
+    uint8_t occupancy;
+
+    occupancy = ecg4_decim_occupancy( dec );
+
+    if ((occupancy > DECIM_LEVEL_UP_PCT) && (dec->level < dec->max_level))
+    {
+        dec->level++;
+    }
+    else if ((occupancy < DECIM_LEVEL_DOWN_PCT) && (dec->level > 0))
+    {
+        dec->level--;
+    }
+
+    decim_window_start( dec );
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_decim_init( T_ecg4_decim *dec, uint32_t baud, uint16_t sample_rate, uint16_t queue_size, uint8_t max_level )
+{
+    dec->queue_q8 = 0;
+    dec->queue_max_q8 = (uint32_t)queue_size << 8;
+    dec->drain_q8 = (uint16_t)(((baud / 10) << 8) / sample_rate);
+    dec->rate_q8 = (uint16_t)(((baud / 10) << 8) / 1000);
+
+    if (dec->rate_q8 == 0)
+    {
+        dec->rate_q8 = 1;
+    }
+
+    dec->clock = 0;
+    dec->last_ms = 0;
+    dec->queue = 0;
+    dec->level = 0;
+    dec->max_level = max_level;
+
+    decim_window_start( dec );
+}
+
+uint8_t ecg4_decim_push( T_ecg4_decim *dec, int16_t sample, int16_t *out )
+{
+    if (dec->clock != 0)
+    {
+        decim_elapse( dec );
+    }
+    else
+    {
+        decim_drain( dec, dec->drain_q8 );
+    }
+
+    if (dec->level == 0)
+    {
+        out[ 0 ] = sample;
+        decim_adapt( dec );
+
+        return 1;
+    }
+
+    if (dec->win_cnt == 0)
+    {
+        dec->win_min = sample;
+        dec->win_max = sample;
+        dec->min_pos = 0;
+        dec->max_pos = 0;
+    }
+    else if (sample < dec->win_min)
+    {
+        dec->win_min = sample;
+        dec->min_pos = dec->win_cnt;
+    }
+    else if (sample > dec->win_max)
+    {
+        dec->win_max = sample;
+        dec->max_pos = dec->win_cnt;
+    }
+
+    dec->win_cnt++;
+
+    if (dec->win_cnt < dec->win_len)
+    {
+        return 0;
+    }
+
+    if (dec->min_pos <= dec->max_pos)
+    {
+        out[ 0 ] = dec->win_min;
+        out[ 1 ] = dec->win_max;
+    }
+    else
+    {
+        out[ 0 ] = dec->win_max;
+        out[ 1 ] = dec->win_min;
+    }
+
+    decim_adapt( dec );
+
+    return 2;
+}
+
+void ecg4_decim_sent( T_ecg4_decim *dec, uint16_t bytes )
+{
+    if (dec->clock != 0)
+    {
+        decim_elapse( dec );
+    }
+
+    dec->queue_q8 += (uint32_t)bytes << 8;
+}
+
+void ecg4_decim_clock( T_ecg4_decim *dec, T_ecg4_decim_clock clock )
+{
+    dec->clock = clock;
+
+    if (clock != 0)
+    {
+        dec->last_ms = clock();
+    }
+}
+
+void ecg4_decim_queue( T_ecg4_decim *dec, T_ecg4_decim_queue queue )
+{
+    dec->queue = queue;
+}
+
+uint8_t ecg4_decim_occupancy( T_ecg4_decim *dec )
+{
+    if (dec->queue != 0)
+    {
+        return dec->queue();
+    }
+
+    if (dec->queue_q8 >= dec->queue_max_q8)
+    {
+        return 100;
+    }
+
+    return (uint8_t)((dec->queue_q8 * 100) / dec->queue_max_q8);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_decim.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
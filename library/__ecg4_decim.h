@@ -0,0 +1,200 @@
+/*
+    __ecg4_decim.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_decim.h
+@brief    ECG_4 Plot Stream Decimator
+*/
+/**
+@defgroup   ECG4_DECIM
+@brief      ECG_4 Plot Stream Decimator
+@{
+
+Min/max preserving decimator which fits the plot stream into the log link budget.
+Every decimation window of 2^(level + 1) samples is reduced to its minimum and maximum, written in the order
+they occurred, so QRS peaks survive decimation. The decimation level is picked from the occupancy of the
+transmit queue, modelled from the bytes reported by ecg4_decim_sent and drained at the link byte rate
+in the sample time.
+
+With a millisecond clock set by ecg4_decim_clock (ecg4_time_ms of the driver, when ecg4_tick runs), the queue is
+drained from the elapsed time instead, on every push and every ecg4_decim_sent, so it also drains while no sample
+is pushed (sensor off, pipeline settling) and the level is right when plotting resumes. Without a clock, text
+written while no samples are pushed stays in the model until they are pushed again.
+
+When the log text goes through a real queue drained in the background, such as the log queue (__ecg4_logq.h),
+ecg4_decim_queue sets a function returning its occupancy, which replaces the model.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_DECIM_H_
+#define _ECG4_DECIM_H_
+
+/** @defgroup ECG4_DECIM_TYPES Types */                       /** @{ */
+
+/**
+ * @brief Millisecond clock used to drain the modelled tx queue
+ */
+typedef uint32_t ( *T_ecg4_decim_clock )( void );
+
+/**
+ * @brief Occupancy of the real tx queue in percent
+ */
+typedef uint8_t ( *T_ecg4_decim_queue )( void );
+
+/**
+ * @struct T_ecg4_decim
+ * @brief Decimator context
+ */
+typedef struct
+{
+    uint32_t queue_q8;      /**< Modelled tx queue occupancy in bytes, Q8 */
+    uint32_t queue_max_q8;  /**< Modelled tx queue size in bytes, Q8 */
+    uint16_t drain_q8;      /**< Bytes drained from the tx queue per input sample, Q8 */
+    uint16_t rate_q8;       /**< Bytes drained from the tx queue per millisecond, Q8 */
+    T_ecg4_decim_clock clock;   /**< Millisecond clock, 0 - drained per input sample */
+    uint32_t last_ms;       /**< Clock time the queue was last drained */
+    T_ecg4_decim_queue queue;   /**< Occupancy of the real tx queue, 0 - modelled */
+    uint8_t  level;         /**< Decimation level, 0 - pass through */
+    uint8_t  max_level;     /**< Maximum decimation level */
+    uint16_t win_len;       /**< Window length of the current level */
+    uint16_t win_cnt;       /**< Samples in the current window */
+    int16_t  win_min;       /**< Minimum of the current window */
+    int16_t  win_max;       /**< Maximum of the current window */
+    uint16_t min_pos;       /**< Position of the minimum in the current window */
+    uint16_t max_pos;       /**< Position of the maximum in the current window */
+
+}T_ecg4_decim;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_DECIM_FUNC Decimator Functions */          /** @{ */
+
+/**
+ * @brief Decimator Init function
+ *
+ * @param[in] dec          Decimator context
+ * @param[in] baud         Log link baud rate, 10 bits per byte are assumed
+ * @param[in] sample_rate  Input sample rate in Hz, 512 for the BMD101 raw data
+ * @param[in] queue_size   Size of the modelled tx queue in bytes
+ * @param[in] max_level    Maximum decimation level, the window length is 2^(max_level + 1) samples
+ *
+ * Function initializes the decimator at the pass through level.
+ */
+void ecg4_decim_init( T_ecg4_decim *dec, uint32_t baud, uint16_t sample_rate, uint16_t queue_size, uint8_t max_level );
+
+/**
+ * @brief Decimator Push function
+ *
+ * @param[in]  dec     Decimator context
+ * @param[in]  sample  Input sample
+ * @param[out] out     Output samples, room for 2 samples is required
+ *
+ * @returns Number of output samples written to out (0, 1 or 2)
+ *
+ * Function pushes one input sample to the decimator and drains the modelled tx queue by one sample time,
+ * or by the time elapsed since the last drain when a clock is set.
+ * The decimation level is updated on the window boundary.
+ */
+uint8_t ecg4_decim_push( T_ecg4_decim *dec, int16_t sample, int16_t *out );
+
+/**
+ * @brief Decimator Sent function
+ *
+ * @param[in] dec    Decimator context
+ * @param[in] bytes  Number of bytes written to the log link
+ *
+ * Function accounts bytes written to the log link, plot and status text alike. When a clock is set, the queue
+ * is drained by the time elapsed since the last drain first.
+ */
+void ecg4_decim_sent( T_ecg4_decim *dec, uint16_t bytes );
+
+/**
+ * @brief Decimator Clock function
+ *
+ * @param[in] dec    Decimator context
+ * @param[in] clock  Function returning a free running millisecond time, 0 - drain per input sample
+ *
+ * Function sets the clock which drains the modelled tx queue from the elapsed time.
+ * @note On 8 and 16 bit targets the clock should read its counter with the tick interrupt disabled.
+ */
+void ecg4_decim_clock( T_ecg4_decim *dec, T_ecg4_decim_clock clock );
+
+/**
+ * @brief Decimator Queue function
+ *
+ * @param[in] dec    Decimator context
+ * @param[in] queue  Function returning the occupancy of the real tx queue in percent, 0 - modelled queue
+ *
+ * Function sets the real tx queue the decimation level follows, instead of the modelled one.
+ */
+void ecg4_decim_queue( T_ecg4_decim *dec, T_ecg4_decim_queue queue );
+
+/**
+ * @brief Decimator Occupancy function
+ *
+ * @param[in] dec  Decimator context
+ *
+ * @returns Tx queue occupancy in percent, 0 - 100, of the real queue when it is set, or else of the modelled one
+ */
+uint8_t ecg4_decim_occupancy( T_ecg4_decim *dec );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_decim.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -12,10 +12,17 @@
 ----------------------------------------------------------------------------- */
 
 #include "__ecg4_driver.h"
+#include "__ecg4_parser.h"
 #include "__ecg4_hal.c"
 
 /* ------------------------------------------------------------------- MACROS */
 
+#define RESET_HOLD_MS        200
+#define RESET_BOOT_MS        200
+
+#define RESET_PHASE_HOLD     0x01
+#define RESET_PHASE_BOOT     0x02
+#define RESET_PHASE_WAIT     0x03
 
 
 /* ---------------------------------------------------------------- VARIABLES */
@@ -24,8 +31,41 @@
 static uint8_t _slaveAddress;
 #endif
 
-static T_ecg4_hdl  driver_hdl;
-static T_ECG4_RETVAL  response_ready;
+static T_ecg4_parser  parser;
+static volatile T_ECG4_RETVAL  response_ready;
+static volatile uint8_t  cpu_idle;
+static T_ecg4_duty  duty_stats;
+static volatile uint32_t  time_ms;
+
+static volatile uint8_t  signal_quality;
+static volatile uint8_t  quality_update;
+
+static uint8_t  pm_enabled;
+static uint8_t  pm_state;
+static uint8_t  pm_off_seen;
+static volatile uint8_t  pm_wake_req;
+static uint16_t  pm_leadoff_ms;
+static uint32_t  pm_sleep_ms;
+static uint16_t  pm_reacquire_ms;
+static uint32_t  pm_timer;
+static T_ecg4_pm_stats  pm_stats;
+
+static volatile uint8_t  packet_flag;
+static volatile uint8_t  reset_state;
+static uint8_t  reset_phase;
+static uint16_t  reset_timer;
+static uint16_t  reset_elapsed;
+static uint16_t  reset_timeout;
+static uint16_t  reset_ready_ms;
+
+static volatile uint8_t  packet_cnt;
+static volatile uint8_t  resync_req;
+static uint8_t  wdg_packet_cnt;
+static uint8_t  wdg_recovering;
+static uint16_t  wdg_timeout;
+static uint16_t  wdg_reset_timeout;
+static uint16_t  wdg_timer;
+static T_ecg4_wdg_stats  wdg_stats;
 
 const uint8_t _ECG4_SYNC_BYTE                    = 0xAA;
 const uint8_t _ECG4_EXCODE_BYTE                  = 0x55;
@@ -36,6 +76,14 @@ const T_ECG4_RETVAL _ECG4_RESPONSE_READY         = 0x01;
 const T_ECG4_RETVAL _ECG4_RESPONSE_NOT_READY     = 0x00;
 const uint8_t _ECG4_ENABLE_LDO_CTRL              = 0x01;
 const uint8_t _ECG4_DISABLE_LDO_CTRL             = 0x00;
+const uint8_t _ECG4_SENSOR_OFF                   = 0x00;
+const uint8_t _ECG4_PM_POWERED                   = 0x00;
+const uint8_t _ECG4_PM_GATED                     = 0x01;
+const uint8_t _ECG4_PM_REACQUIRE                 = 0x02;
+const uint8_t _ECG4_RESET_IDLE                   = 0x00;
+const uint8_t _ECG4_RESET_IN_PROGRESS            = 0x01;
+const uint8_t _ECG4_RESET_READY                  = 0x02;
+const uint8_t _ECG4_RESET_TIMEOUT                = 0x03;
 
 /* -------------------------------------------- PRIVATE FUNCTION DECLARATIONS */
 
@@ -43,6 +91,177 @@ const uint8_t _ECG4_DISABLE_LDO_CTRL             = 0x00;
 
 /* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
 
+static void reset_tick( void )
+{
+    reset_elapsed++;
+    reset_timer++;
+
+    if (reset_phase == RESET_PHASE_HOLD)
+    {
+        if (reset_timer >= RESET_HOLD_MS)
+        {
+            hal_gpio_rstSet( 1 );
+            reset_phase = RESET_PHASE_BOOT;
+            reset_timer = 0;
+        }
+    }
+    else if (reset_phase == RESET_PHASE_BOOT)
+    {
+        if (reset_timer >= RESET_BOOT_MS)
+        {
+            ecg4_enable_LDO_ctrl( _ECG4_ENABLE_LDO_CTRL );
+            packet_flag = 0;
+            reset_phase = RESET_PHASE_WAIT;
+            reset_timer = 0;
+        }
+    }
+    else if (packet_flag)
+    {
+        reset_ready_ms = reset_elapsed;
+        reset_state = _ECG4_RESET_READY;
+    }
+    else if (reset_timer >= reset_timeout)
+    {
+        reset_state = _ECG4_RESET_TIMEOUT;
+    }
+}
+
+static void wdg_tick( void )
+{
+    uint8_t cnt;
+
+    if (wdg_recovering)
+    {
+        wdg_recovering = 0;
+
+        if (reset_state == _ECG4_RESET_READY)
+        {
+            wdg_stats.recovery_cnt++;
+            wdg_stats.recovery_ms = wdg_timeout + reset_ready_ms;
+
+            if (wdg_stats.recovery_ms > wdg_stats.recovery_max_ms)
+            {
+                wdg_stats.recovery_max_ms = wdg_stats.recovery_ms;
+            }
+        }
+        else
+        {
+            wdg_stats.fail_cnt++;
+        }
+    }
+
+    cnt = packet_cnt;
+
+    if ((cnt != wdg_packet_cnt) || (pm_enabled && (pm_state == _ECG4_PM_GATED)))
+    {
+        wdg_packet_cnt = cnt;
+        wdg_timer = 0;
+
+        return;
+    }
+
+    wdg_timer++;
+
+    if (wdg_timer >= wdg_timeout)
+    {
+        wdg_stats.stall_cnt++;
+        wdg_timer = 0;
+        wdg_recovering = 1;
+
+        // the parser belongs to the uart interrupt routine, which may preempt this one or be preempted by it
+        resync_req = 1;
+        ecg4_reset_start( wdg_reset_timeout );
+    }
+}
+
+static void pm_gate( void )
+{
+    ecg4_enable_LDO_ctrl( _ECG4_DISABLE_LDO_CTRL );
+    pm_state = _ECG4_PM_GATED;
+    pm_timer = 0;
+    pm_off_seen = 0;
+    pm_stats.gate_cnt++;
+}
+
+static void pm_power_up( void )
+{
+    ecg4_enable_LDO_ctrl( _ECG4_ENABLE_LDO_CTRL );
+    quality_update = 0;
+    pm_state = _ECG4_PM_REACQUIRE;
+    pm_timer = 0;
+    pm_stats.wake_cnt++;
+}
+
+static void pm_tick( void )
+{
+    uint8_t update;
+
+    update = quality_update;
+    quality_update = 0;
+
+    if (pm_state == _ECG4_PM_GATED)
+    {
+        pm_stats.gated_ms++;
+        pm_timer++;
+
+        if (pm_wake_req || ((pm_sleep_ms != 0) && (pm_timer >= pm_sleep_ms)))
+        {
+            pm_power_up();
+        }
+
+        pm_wake_req = 0;
+
+        return;
+    }
+
+    pm_stats.powered_ms++;
+    pm_wake_req = 0;
+
+    if (pm_timer < 0xFFFFFFFF)
+    {
+        pm_timer++;
+    }
+
+    if (pm_state == _ECG4_PM_REACQUIRE)
+    {
+        if (update && (signal_quality != _ECG4_SENSOR_OFF))
+        {
+            pm_stats.reacq_ms = (uint16_t)pm_timer;
+
+            if (pm_stats.reacq_ms > pm_stats.reacq_max_ms)
+            {
+                pm_stats.reacq_max_ms = pm_stats.reacq_ms;
+            }
+
+            pm_state = _ECG4_PM_POWERED;
+            pm_timer = 0;
+        }
+        else if (pm_timer >= pm_reacquire_ms)
+        {
+            pm_stats.reacq_fail_cnt++;
+            pm_gate();
+        }
+
+        return;
+    }
+
+    // lead-off time counts from a received sensor off report, not from the power-up or a silent stream
+    if (update && (signal_quality != _ECG4_SENSOR_OFF))
+    {
+        pm_timer = 0;
+        pm_off_seen = 0;
+    }
+    else if (update && !pm_off_seen)
+    {
+        pm_timer = 0;
+        pm_off_seen = 1;
+    }
+    else if (pm_off_seen && (pm_timer >= pm_leadoff_ms))
+    {
+        pm_gate();
+    }
+}
+
 
 
 /* --------------------------------------------------------- PUBLIC FUNCTIONS */
@@ -88,138 +307,43 @@ void ecg4_uartDriverInit(T_ECG4_P gpioObj, T_ECG4_P uartObj)
 
 void ecg4_response_handler_set( void ( *handler )( uint8_t*, uint8_t*, uint8_t*, uint8_t* ) )
 {
-    driver_hdl = handler;
+    parser.hdl = handler;
 }
 
 void ecg4_uart_isr( void )
 {
-    static uint8_t rx_buff[ 256 ];
-    static uint8_t rx_cnt = 0;
-    static uint8_t rx_idx;
-    static uint8_t payload_size;
-    static uint8_t row_check = 0;
-    static uint8_t op_code;
-    static uint8_t row_size;
-    static uint8_t row_size_check;
-    static uint8_t checksum = 0;
-    static uint8_t row_cnt = 0;
-    uint8_t rx_dat;
-    
-    rx_dat = hal_uartRead();
-    
-    if ((rx_cnt == 0) && (rx_dat != _ECG4_SYNC_BYTE))
-    {
-        rx_cnt = 0;
-        
-        return;
-    }
-    else if ((rx_cnt == 1) && (rx_dat != _ECG4_SYNC_BYTE))
+    uint8_t res;
+
+    if (resync_req)
     {
-        rx_cnt = 0;
-        
-        return;
+        resync_req = 0;
+        ecg4_parser_reset( &parser );
+        response_ready = _ECG4_RESPONSE_NOT_READY;
     }
-    else if (rx_cnt == 2)
+
+    res = ecg4_parser_byte( &parser, hal_uartRead() );
+
+    if (res == _ECG4_PARSER_NONE)
     {
-        payload_size = rx_dat;
-        rx_cnt++;
-        row_check = 1;
-        
         return;
     }
-    else if (rx_cnt > 2)
+
+    if (res & _ECG4_PARSER_PACKET)
     {
-        if (rx_cnt - 3 < payload_size)
-        {
-            if (rx_dat == _ECG4_EXCODE_BYTE)
-            {
-                row_check = 1;
-                checksum += rx_dat;
-                rx_cnt++;
-                
-                return;
-            }
-            
-            if (row_check == 1)
-            {
-                op_code = rx_dat;
-                row_check = 0;
-                checksum += rx_dat;
-                
-                if ((op_code == _ECG4_SIGNAL_QUALITY_CODE_BYTE) || (op_code == _ECG4_HEART_RATE_CODE_BYTE))
-                {
-                    row_size = 1;
-                    row_size_check = 0;
-                }
-                else if (op_code == _ECG4_RAW_DATA_CODE_BYTE)
-                {
-                    row_size_check = 1;
-                }
-                else
-                {
-                    rx_cnt = 0;
-                    checksum = 0;
-                    
-                    return;
-                }
-                
-                rx_idx = 0;
-                rx_cnt++;
-                
-                return;
-            }
-            
-            if (row_size_check == 1)
-            {
-                row_size = rx_dat;
-                row_size_check = 0;
-                checksum += rx_dat;
-                rx_cnt++;
-                
-                return;
-            }
-            
-            if (rx_idx < row_size)
-            {
-                rx_buff[ rx_idx ] = rx_dat;
-                rx_idx++;
-                checksum += rx_dat;
-                
-                if (rx_idx == row_size)
-                {
-                    driver_hdl( &op_code, &row_size, rx_buff, &row_cnt );
-                    row_cnt++;
-                    row_check = 1;
-                }
-                
-                rx_cnt++;
-                
-                return;
-            }
-        }
-        else
+        response_ready = _ECG4_RESPONSE_READY;
+        packet_flag = 1;
+        packet_cnt++;
+
+        if (res & _ECG4_PARSER_QUALITY)
         {
-            checksum = ~checksum;
-            
-            if (checksum == rx_dat)
-            {
-                response_ready = _ECG4_RESPONSE_READY;
-            }
-            else
-            {
-                response_ready = _ECG4_RESPONSE_NOT_READY;
-            }
-            
-            checksum = 0;
-            row_cnt = 0;
-            rx_cnt = 0;
-            rx_idx = 0;
-            
-            return;
+            signal_quality = parser.quality;
+            quality_update = 1;
         }
     }
-    
-    rx_cnt++;
+    else
+    {
+        response_ready = _ECG4_RESPONSE_NOT_READY;
+    }
 }
 
 T_ECG4_RETVAL ecg4_responseReady( void )
@@ -234,6 +358,120 @@ T_ECG4_RETVAL ecg4_responseReady( void )
     return _ECG4_RESPONSE_NOT_READY;
 }
 
+T_ECG4_RETVAL ecg4_wait_for_data( void )
+{
+    for (;;)
+    {
+        // a packet completed between the check and the idle instruction would be waited for until the next one
+        hal_cpuIdleLock();
+
+        if (response_ready != _ECG4_RESPONSE_NOT_READY)
+        {
+            hal_cpuIdleUnlock();
+            break;
+        }
+
+        cpu_idle = 1;
+        hal_cpuIdle();
+        cpu_idle = 0;
+        duty_stats.wakeups++;
+    }
+
+    response_ready = _ECG4_RESPONSE_NOT_READY;
+    duty_stats.packets++;
+
+    return _ECG4_RESPONSE_READY;
+}
+
+void ecg4_tick( void )
+{
+    time_ms++;
+    duty_stats.total_ms++;
+
+    if (cpu_idle)
+    {
+        duty_stats.idle_ms++;
+    }
+
+    if (reset_state == _ECG4_RESET_IN_PROGRESS)
+    {
+        reset_tick();
+
+        return;
+    }
+
+    if (pm_enabled)
+    {
+        pm_tick();
+    }
+
+    if (wdg_timeout != 0)
+    {
+        wdg_tick();
+    }
+}
+
+uint8_t ecg4_signal_quality( void )
+{
+    return signal_quality;
+}
+
+void ecg4_pm_config( uint16_t leadoff_ms, uint32_t sleep_ms, uint16_t reacquire_ms )
+{
+    pm_leadoff_ms = leadoff_ms;
+    pm_sleep_ms = sleep_ms;
+    pm_reacquire_ms = reacquire_ms;
+}
+
+void ecg4_pm_enable( uint8_t state )
+{
+    pm_enabled = 0;
+
+    if (pm_state == _ECG4_PM_GATED)
+    {
+        ecg4_enable_LDO_ctrl( _ECG4_ENABLE_LDO_CTRL );
+    }
+
+    pm_state = _ECG4_PM_POWERED;
+    pm_timer = 0;
+    pm_off_seen = 0;
+    pm_wake_req = 0;
+    pm_enabled = state;
+}
+
+void ecg4_pm_wake( void )
+{
+    pm_wake_req = 1;
+}
+
+uint8_t ecg4_pm_state( void )
+{
+    return pm_state;
+}
+
+void ecg4_pm_stats_get( T_ecg4_pm_stats *stats )
+{
+    *stats = pm_stats;
+}
+
+uint32_t ecg4_time_ms( void )
+{
+    return time_ms;
+}
+
+void ecg4_duty_get( T_ecg4_duty *duty )
+{
+    *duty = duty_stats;
+}
+
+void ecg4_duty_clear( void )
+{
+    duty_stats.total_ms = 0;
+    duty_stats.idle_ms = 0;
+    duty_stats.wakeups = 0;
+    duty_stats.packets = 0;
+}
+
 void ecg4_reset( void )
 {
     hal_gpio_rstSet( 0 );
@@ -244,6 +482,49 @@ void ecg4_reset( void )
     Delay_100ms();
 }
 
+void ecg4_reset_start( uint16_t timeout_ms )
+{
+    reset_state = _ECG4_RESET_IDLE;
+
+    hal_gpio_rstSet( 0 );
+    ecg4_enable_LDO_ctrl( _ECG4_DISABLE_LDO_CTRL );
+
+    pm_state = _ECG4_PM_POWERED;
+    pm_timer = 0;
+    pm_off_seen = 0;
+    reset_timeout = timeout_ms;
+    reset_phase = RESET_PHASE_HOLD;
+    reset_timer = 0;
+    reset_elapsed = 0;
+    reset_ready_ms = 0;
+    reset_state = _ECG4_RESET_IN_PROGRESS;
+}
+
+uint8_t ecg4_reset_poll( void )
+{
+    return reset_state;
+}
+
+uint16_t ecg4_reset_ready_time( void )
+{
+    return reset_ready_ms;
+}
+
+void ecg4_watchdog_config( uint16_t timeout_ms, uint16_t reset_timeout_ms )
+{
+    wdg_timeout = 0;
+    wdg_timer = 0;
+    wdg_recovering = 0;
+    wdg_packet_cnt = packet_cnt;
+    wdg_reset_timeout = reset_timeout_ms;
+    wdg_timeout = timeout_ms;
+}
+
+void ecg4_watchdog_stats_get( T_ecg4_wdg_stats *stats )
+{
+    *stats = wdg_stats;
+}
+
 void ecg4_enable_LDO_ctrl( uint8_t state )
 {
     if (state)
@@ -64,12 +64,63 @@ extern const T_ECG4_RETVAL _ECG4_RESPONSE_READY         ;
 extern const T_ECG4_RETVAL _ECG4_RESPONSE_NOT_READY     ;
 extern const uint8_t _ECG4_ENABLE_LDO_CTRL              ;
 extern const uint8_t _ECG4_DISABLE_LDO_CTRL             ;
+extern const uint8_t _ECG4_SENSOR_OFF                   ;
+extern const uint8_t _ECG4_PM_POWERED                   ;
+extern const uint8_t _ECG4_PM_GATED                     ;
+extern const uint8_t _ECG4_PM_REACQUIRE                 ;
+extern const uint8_t _ECG4_RESET_IDLE                   ;
+extern const uint8_t _ECG4_RESET_IN_PROGRESS            ;
+extern const uint8_t _ECG4_RESET_READY                  ;
+extern const uint8_t _ECG4_RESET_TIMEOUT                ;
 
                                                                        /** @} */
 /** @defgroup ECG4_TYPES Types */                             /** @{ */
 
 typedef void ( *T_ecg4_hdl )( uint8_t*, uint8_t*, uint8_t*, uint8_t* );
 
+/**
+ * @struct T_ecg4_duty
+ * @brief Duty-cycle statistics of the ecg4_wait_for_data function
+ */
+typedef struct
+{
+    uint32_t total_ms;      /**< Milliseconds counted by ecg4_tick */
+    uint32_t idle_ms;       /**< Milliseconds the core spent in the idle mode */
+    uint32_t wakeups;       /**< Number of wake-ups from the idle mode */
+    uint32_t packets;       /**< Number of packets delivered by ecg4_wait_for_data */
+
+}T_ecg4_duty;
+
+/**
+ * @struct T_ecg4_pm_stats
+ * @brief Statistics of the LDO power manager
+ */
+typedef struct
+{
+    uint32_t powered_ms;    /**< Milliseconds the LDO was powered */
+    uint32_t gated_ms;      /**< Milliseconds the LDO was gated off */
+    uint16_t gate_cnt;      /**< Number of times the LDO was gated off */
+    uint16_t wake_cnt;      /**< Number of scheduled or external power-ups */
+    uint16_t reacq_fail_cnt;/**< Number of power-ups which did not find the sensor on the skin */
+    uint16_t reacq_ms;      /**< Last re-acquisition latency, from the power-up to the first sensor on report */
+    uint16_t reacq_max_ms;  /**< Maximum re-acquisition latency */
+
+}T_ecg4_pm_stats;
+
+/**
+ * @struct T_ecg4_wdg_stats
+ * @brief Statistics of the stream-stall watchdog
+ */
+typedef struct
+{
+    uint16_t stall_cnt;       /**< Number of detected stream stalls */
+    uint16_t recovery_cnt;    /**< Number of stalls recovered by the reset sequence */
+    uint16_t fail_cnt;        /**< Number of reset sequences which ended without a verified response */
+    uint16_t recovery_ms;     /**< Last recovery time, from the last verified response to the first one after the reset */
+    uint16_t recovery_max_ms; /**< Maximum recovery time */
+
+}T_ecg4_wdg_stats;
+
                                                                        /** @} */
 #ifdef __cplusplus
 extern "C"{
@@ -113,6 +164,105 @@ void ecg4_uart_isr( void );
  */
 T_ECG4_RETVAL ecg4_responseReady( void );
 
+/**
+ * @brief Wait For Data function
+ *
+ * @returns 1 - response is ready
+ *
+ * Function puts the core in the idle mode until the uart interrupt routine has published a new verified response,
+ * and then returns the same ready state as ecg4_responseReady.
+ * @note Targets without the idle mode fall back to polling of the response ready flag.
+ *       The flag is checked with the interrupts disabled, the idle instruction is entered before they are enabled
+ *       again, so a response published in between wakes the core instead of waiting for the next received byte.
+ *       Interrupts are enabled on return.
+ */
+T_ECG4_RETVAL ecg4_wait_for_data( void );
+
+/**
+ * @brief Tick function
+ *
+ * Function should be called every 1 ms from the timer interrupt routine.
+ * It is the time base of the driver, used for the duty-cycle statistics.
+ */
+void ecg4_tick( void );
+
+/**
+ * @brief Time function
+ *
+ * @returns Milliseconds counted by ecg4_tick, free running
+ * @note On 8 and 16 bit targets the 32 bit counter should be read with the tick interrupt disabled.
+ */
+uint32_t ecg4_time_ms( void );
+
+/**
+ * @brief Duty-Cycle Get function
+ *
+ * @param[out] duty  Duty-cycle statistics
+ *
+ * Function copies the duty-cycle statistics collected since the last clear.
+ * @note The idle and total time is counted only when ecg4_tick is called.
+ */
+void ecg4_duty_get( T_ecg4_duty *duty );
+
+/**
+ * @brief Duty-Cycle Clear function
+ *
+ * Function clears the duty-cycle statistics.
+ */
+void ecg4_duty_clear( void );
+
+/**
+ * @brief Signal Quality Get function
+ *
+ * @returns Last signal quality reported in a verified response (0 - sensor off, 200 - sensor on)
+ */
+uint8_t ecg4_signal_quality( void );
+
+/**
+ * @brief Power Manager Config function
+ *
+ * @param[in] leadoff_ms    Time from a sensor off report, with no sensor on report since, after which the LDO is
+ *                          gated off (no report at all, e.g. a stream not running yet, never gates it)
+ * @param[in] sleep_ms      Time after which the gated LDO is powered up again, 0 - only ecg4_pm_wake powers it up
+ * @param[in] reacquire_ms  Time the sensor should be found on the skin after the power-up, otherwise LDO is gated off again
+ *
+ * Function configures the optional LDO power manager.
+ */
+void ecg4_pm_config( uint16_t leadoff_ms, uint32_t sleep_ms, uint16_t reacquire_ms );
+
+/**
+ * @brief Power Manager Enable function
+ *
+ * @param[in] state  0 - Disable power manager, 1 - Enable power manager
+ *
+ * Function enables the LDO power manager driven by ecg4_tick. Disabling the power manager powers the LDO up.
+ * @note While the power manager is enabled, the application should not call ecg4_enable_LDO_ctrl.
+ */
+void ecg4_pm_enable( uint8_t state );
+
+/**
+ * @brief Power Manager Wake function
+ *
+ * Function requests the LDO power-up on the next tick, for example from a button or motion interrupt.
+ */
+void ecg4_pm_wake( void );
+
+/**
+ * @brief Power Manager State function
+ *
+ * @returns _ECG4_PM_POWERED, _ECG4_PM_GATED or _ECG4_PM_REACQUIRE
+ */
+uint8_t ecg4_pm_state( void );
+
+/**
+ * @brief Power Manager Statistics function
+ *
+ * @param[out] stats  Power manager statistics
+ *
+ * Function copies the time spent powered and gated off and the re-acquisition latency.
+ */
+void ecg4_pm_stats_get( T_ecg4_pm_stats *stats );
+
 /**
  * @brief Reset function
  *
@@ -120,6 +270,55 @@ T_ECG4_RETVAL ecg4_responseReady( void );
  */
 void ecg4_reset( void );
 
+/**
+ * @brief Reset Start function
+ *
+ * @param[in] timeout_ms  Time to wait for the first verified response after the power-up
+ *
+ * Function starts the non-blocking reset and power-up sequence driven by ecg4_tick.
+ * The sequence holds the reset low for 200 ms, waits 200 ms after the reset release, powers up the LDO
+ * and waits for the first verified response, which marks the device as ready.
+ */
+void ecg4_reset_start( uint16_t timeout_ms );
+
+/**
+ * @brief Reset Poll function
+ *
+ * @returns _ECG4_RESET_IDLE, _ECG4_RESET_IN_PROGRESS, _ECG4_RESET_READY or _ECG4_RESET_TIMEOUT
+ *
+ * Function returns the state of the sequence started by ecg4_reset_start.
+ */
+uint8_t ecg4_reset_poll( void );
+
+/**
+ * @brief Reset Ready Time function
+ *
+ * @returns Time in ms from ecg4_reset_start to the first verified response
+ */
+uint16_t ecg4_reset_ready_time( void );
+
+/**
+ * @brief Watchdog Config function
+ *
+ * @param[in] timeout_ms        Time without a verified response after which the stream is declared stalled, 0 - disabled
+ * @param[in] reset_timeout_ms  Timeout of the reset sequence started by the recovery
+ *
+ * Function configures the stream-stall watchdog driven by ecg4_tick. On a stall the watchdog runs the ecg4_reset_start
+ * sequence and requests a parser resynchronisation, which ecg4_uart_isr does before the next received byte, so the
+ * parser is only ever touched by the uart interrupt routine. The watchdog is suspended while the power manager keeps
+ * the LDO gated off.
+ */
+void ecg4_watchdog_config( uint16_t timeout_ms, uint16_t reset_timeout_ms );
+
+/**
+ * @brief Watchdog Statistics function
+ *
+ * @param[out] stats  Watchdog statistics
+ *
+ * Function copies the number of stalls, recoveries and failed recoveries and the recovery time.
+ */
+void ecg4_watchdog_stats_get( T_ecg4_wdg_stats *stats );
+
 /**
  * @brief LDO Control function
  *
@@ -148,6 +347,7 @@ void ecg4_enable_LDO_ctrl( uint8_t state );
     @example Click_ECG_4_DSPIC.c
     @example Click_ECG_4_AVR.c
     @example Click_ECG_4_FT90x.c
+    @example Click_ECG_4_LINUX.c
     @example Click_ECG_4_STM.mbas
     @example Click_ECG_4_TIVA.mbas
     @example Click_ECG_4_CEC.mbas
@@ -0,0 +1,190 @@
+/*
+    __ecg4_filter.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_filter.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define FILTER_NOTCH_50_B0      15933
+#define FILTER_NOTCH_50_B1      (-26053)
+#define FILTER_NOTCH_50_A1      (-25987)
+#define FILTER_NOTCH_60_B0      15921
+#define FILTER_NOTCH_60_B1      (-23593)
+#define FILTER_NOTCH_60_A1      (-23551)
+#define FILTER_NOTCH_A2         15416
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_FILTER_NOTCH_OFF             = 0x00;
+const uint8_t _ECG4_FILTER_NOTCH_50HZ            = 0x01;
+const uint8_t _ECG4_FILTER_NOTCH_60HZ            = 0x02;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void filter_highpass( T_ecg4_filter *flt, int16_t *samples, uint16_t n_samples )
+{
+    uint16_t cnt;
+    int16_t x;
+    int32_t y;
+
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        x = samples[ cnt ];
+        flt->hp_acc += ((int32_t)x - flt->hp_x1) * 256 - (flt->hp_acc >> flt->hp_shift);
+        flt->hp_x1 = x;
+        y = flt->hp_acc >> 8;
+
+        if (y > 32767)
+        {
+            y = 32767;
+        }
+        else if (y < -32768)
+        {
+            y = -32768;
+        }
+
+        samples[ cnt ] = (int16_t)y;
+    }
+}
+
+static void filter_notch( T_ecg4_filter *flt, int16_t *samples, uint16_t n_samples )
+{
+    uint16_t cnt;
+    int16_t x;
+    int32_t acc;
+    int32_t y;
+
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        x = samples[ cnt ];
+        acc = (int32_t)flt->b0 * x + (int32_t)flt->b1 * flt->x1 + (int32_t)flt->b0 * flt->x2 -
+              (int32_t)flt->a1 * flt->y1 - (int32_t)flt->a2 * flt->y2 + flt->err;
+        y = acc >> 14;
+        flt->err = (int16_t)(acc - y * 16384);
+
+        if (y > 32767)
+        {
+            y = 32767;
+        }
+        else if (y < -32768)
+        {
+            y = -32768;
+        }
+
+        flt->x2 = flt->x1;
+        flt->x1 = x;
+        flt->y2 = flt->y1;
+        flt->y1 = (int16_t)y;
+        samples[ cnt ] = (int16_t)y;
+    }
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_filter_init( T_ecg4_filter *flt, uint8_t hp_shift, uint8_t notch )
+{
+    flt->hp_shift = hp_shift;
+    flt->hp_x1 = 0;
+    flt->hp_acc = 0;
+
+    flt->notch = notch;
+    flt->a2 = FILTER_NOTCH_A2;
+
+    if (notch == _ECG4_FILTER_NOTCH_60HZ)
+    {
+        flt->b0 = FILTER_NOTCH_60_B0;
+        flt->b1 = FILTER_NOTCH_60_B1;
+        flt->a1 = FILTER_NOTCH_60_A1;
+    }
+    else
+    {
+        flt->b0 = FILTER_NOTCH_50_B0;
+        flt->b1 = FILTER_NOTCH_50_B1;
+        flt->a1 = FILTER_NOTCH_50_A1;
+    }
+
+    flt->x1 = 0;
+    flt->x2 = 0;
+    flt->y1 = 0;
+    flt->y2 = 0;
+    flt->err = 0;
+}
+
+void ecg4_filter_block( T_ecg4_filter *flt, int16_t *samples, uint16_t n_samples )
+{
+    if (flt->hp_shift != 0)
+    {
+        filter_highpass( flt, samples, n_samples );
+    }
+
+    if (flt->notch != _ECG4_FILTER_NOTCH_OFF)
+    {
+        filter_notch( flt, samples, n_samples );
+    }
+}
+
+uint32_t ecg4_filter_bench( T_ecg4_filter *flt, int16_t *samples, uint16_t n_samples, T_ecg4_filter_cycles cycles )
+{
+    uint32_t start;
+    uint32_t elapsed;
+
+    if (n_samples == 0)
+    {
+        return 0;
+    }
+
+    start = cycles();
+    ecg4_filter_block( flt, samples, n_samples );
+    elapsed = cycles() - start;
+
+    return (elapsed * 16) / n_samples;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_filter.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
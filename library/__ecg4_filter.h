@@ -0,0 +1,173 @@
+/*
+    __ecg4_filter.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_filter.h
+@brief    ECG_4 Filter Chain
+*/
+/**
+@defgroup   ECG4_FILTER
+@brief      ECG_4 Filter Chain
+@{
+
+Fixed-point conditioning of the 512 Hz raw data, applied in place on contiguous sample blocks.
+
+| Stage            | Operation                                                                          |
+|:----------------:|:-----------------------------------------------------------------------------------|
+| Baseline wander  | y(n) = x(n) - x(n-1) + (1 - 2^-shift) y(n-1), shift only, Q8 state                 |
+| Mains notch      | second order IIR notch at 50 Hz or 60 Hz, pole radius 0.97 (about 5 Hz wide),      |
+|                  | Q14 coefficients, unity DC gain, error feedback against limit cycles               |
+
+The high-pass cut-off is 512 / (2 pi 2^shift) Hz: shift 7 gives 0.64 Hz, shift 8 gives 0.32 Hz.
+The notch accumulator keeps headroom for samples within +-16384, the output is saturated to 16 bits.
+
+Per-sample cost is one subtraction and shift for the high-pass, five 16 x 16 bit multiplications for the notch.
+Use ecg4_filter_bench with the cycle counter of the target to measure it: DWT_CYCCNT on ARM Cortex-M
+(STM32, TIVA, KINETIS, MSP432, CEC1702), the core timer on PIC32, a free running timer clocked from
+the instruction clock on PIC, dsPIC, AVR and FT90x.
+No per-family cycles per sample are recorded here: the benchmark has not been run on the target boards yet.
+Only the host figures of ecg4_dsp_bench (notch, q15 variant) exist, and they do not carry over to the MCUs.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_FILTER_H_
+#define _ECG4_FILTER_H_
+
+/** @defgroup ECG4_FILTER_VAR Variables */                    /** @{ */
+
+extern const uint8_t _ECG4_FILTER_NOTCH_OFF             ;
+extern const uint8_t _ECG4_FILTER_NOTCH_50HZ            ;
+extern const uint8_t _ECG4_FILTER_NOTCH_60HZ            ;
+
+                                                                       /** @} */
+/** @defgroup ECG4_FILTER_TYPES Types */                      /** @{ */
+
+/**
+ * @struct T_ecg4_filter
+ * @brief Filter chain state of one channel
+ */
+typedef struct
+{
+    uint8_t  hp_shift;      /**< High-pass pole, 0 - high-pass off */
+    int16_t  hp_x1;
+    int32_t  hp_acc;        /**< High-pass output, Q8 */
+
+    uint8_t  notch;         /**< _ECG4_FILTER_NOTCH_OFF, _50HZ or _60HZ */
+    int16_t  b0;            /**< Notch coefficients, Q14 (b2 equals b0) */
+    int16_t  b1;
+    int16_t  a1;
+    int16_t  a2;
+    int16_t  x1;
+    int16_t  x2;
+    int16_t  y1;
+    int16_t  y2;
+    int16_t  err;           /**< Notch quantization error feedback */
+
+}T_ecg4_filter;
+
+/**
+ * @brief Cycle counter function used by ecg4_filter_bench
+ */
+typedef uint32_t ( *T_ecg4_filter_cycles )( void );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_FILTER_FUNC Filter Chain Functions */      /** @{ */
+
+/**
+ * @brief Filter Init function
+ *
+ * @param[in] flt       Filter chain state
+ * @param[in] hp_shift  High-pass pole, 1 - 2^-hp_shift (7 - 0.64 Hz cut-off), 0 - high-pass off
+ * @param[in] notch     _ECG4_FILTER_NOTCH_OFF, _ECG4_FILTER_NOTCH_50HZ or _ECG4_FILTER_NOTCH_60HZ
+ *
+ * Function initializes the filter chain state of one channel.
+ */
+void ecg4_filter_init( T_ecg4_filter *flt, uint8_t hp_shift, uint8_t notch );
+
+/**
+ * @brief Filter Block function
+ *
+ * @param[in]     flt        Filter chain state
+ * @param[in,out] samples    Samples, filtered in place
+ * @param[in]     n_samples  Number of samples
+ *
+ * Function runs the high-pass and the notch over a contiguous sample block.
+ */
+void ecg4_filter_block( T_ecg4_filter *flt, int16_t *samples, uint16_t n_samples );
+
+/**
+ * @brief Filter Benchmark function
+ *
+ * @param[in]     flt        Filter chain state
+ * @param[in,out] samples    Samples, filtered in place
+ * @param[in]     n_samples  Number of samples
+ * @param[in]     cycles     Function returning a free running cycle counter
+ *
+ * @returns Cycles per sample, Q4 (1/16 cycle resolution)
+ *
+ * Function runs ecg4_filter_block once and measures it with the given cycle counter.
+ * @note The call overhead of the cycle counter function is included.
+ */
+uint32_t ecg4_filter_bench( T_ecg4_filter *flt, int16_t *samples, uint16_t n_samples, T_ecg4_filter_cycles cycles );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_filter.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
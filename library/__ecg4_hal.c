@@ -448,6 +448,111 @@ static void hal_gpioMap(T_HAL_P gpioObj)
 #endif
 #endif
 
+#ifdef __linux__
+#include "__HAL_LINUX.c"
+#endif
+
+/** @defgroup ECG4_HAL_PWR HAL Power Interface */              /** @{ */
+
+/**
+ * @brief hal_cpuIdleLock
+ *
+ * Function disables the interrupts before the caller checks its wake-up
+ * condition, so an interrupt which sets it cannot run between the check and
+ * hal_cpuIdle. It is followed by hal_cpuIdle or hal_cpuIdleUnlock.
+ */
+static void hal_cpuIdleLock()
+{
+#ifdef __MIKROC_PRO_FOR_ARM__
+    asm CPSID I;
+#endif
+#ifdef __MIKROC_PRO_FOR_PIC__
+    GIE_bit = 0;
+#endif
+#ifdef __MIKROC_PRO_FOR_PIC32__
+    asm di;
+#endif
+#ifdef __MIKROC_PRO_FOR_DSPIC__
+    SR |= 0x00E0;
+#endif
+#ifdef __MIKROC_PRO_FOR_AVR__
+    asm cli;
+#endif
+}
+
+/**
+ * @brief hal_cpuIdleUnlock
+ *
+ * Function enables the interrupts disabled by hal_cpuIdleLock.
+ */
+static void hal_cpuIdleUnlock()
+{
+#ifdef __MIKROC_PRO_FOR_ARM__
+    asm CPSIE I;
+#endif
+#ifdef __MIKROC_PRO_FOR_PIC__
+    GIE_bit = 1;
+#endif
+#ifdef __MIKROC_PRO_FOR_PIC32__
+    asm ei;
+#endif
+#ifdef __MIKROC_PRO_FOR_DSPIC__
+    SR &= 0xFF1F;
+#endif
+#ifdef __MIKROC_PRO_FOR_AVR__
+    asm sei;
+#endif
+}
+
+/**
+ * @brief hal_cpuIdle
+ *
+ * Function puts the core in the idle mode until the next interrupt, it is
+ * called after hal_cpuIdleLock and returns with the interrupts enabled.
+ *
+ * @note
+ * Only the core clock is stopped, peripherals (UART) keep running and their
+ * interrupts wake the core. An interrupt pending while the interrupts are
+ * disabled still wakes the core (WFI on ARM, SLEEP on PIC18, WAIT on PIC32,
+ * PWRSAV below the CPU priority on dsPIC), and is served when they are enabled
+ * again, on AVR SEI enables them only after the following SLEEP. Targets
+ * without an idle instruction return immediately, what makes the caller fall
+ * back to polling. On Linux the idle mode waits for the next received byte and
+ * runs its rx interrupt.
+ */
+static void hal_cpuIdle()
+{
+#ifdef __MIKROC_PRO_FOR_ARM__
+    asm WFI;
+    asm CPSIE I;
+#endif
+#ifdef __MIKROC_PRO_FOR_PIC__
+#ifdef P18
+    IDLEN_bit = 1;
+    asm sleep;
+#endif
+    GIE_bit = 1;
+#endif
+#ifdef __MIKROC_PRO_FOR_PIC32__
+    asm wait;
+    asm ei;
+#endif
+#ifdef __MIKROC_PRO_FOR_DSPIC__
+    asm pwrsav #1;
+    SR &= 0xFF1F;
+#endif
+#ifdef __MIKROC_PRO_FOR_AVR__
+    SE_bit = 1;
+    asm sei;
+    asm sleep;
+    SE_bit = 0;
+#endif
+#ifdef __linux__
+    hal_uartIdle();
+#endif
+}
+                                                                       /** @} */
+
 /* -------------------------------------------------------------------------- */
 /*
   __ecg4_hal.c
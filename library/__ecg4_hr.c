@@ -0,0 +1,219 @@
+/*
+    __ecg4_hr.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_hr.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define HR_SAMPLES_PER_MIN      30720
+#define HR_RR_MIN               123
+#define HR_RR_MAX               1024
+#define HR_GOOD_MIN             2
+#define HR_PEND_MIN             3
+#define HR_QUALITY_NONE         0xFF
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint8_t hr_agree( uint16_t rr, uint16_t ref )
+{
+    uint16_t tol;
+
+    tol = ref / 5;
+
+    return (rr + tol >= ref) && (rr <= ref + tol);
+}
+
+static void hr_beat( T_ecg4_hr *hr, uint16_t rr )
+{
+    hr->rr = rr;
+
+    if ((rr < HR_RR_MIN) || (rr > HR_RR_MAX))
+    {
+        hr->good_cnt = 0;
+        hr->pend_cnt = 0;
+        return;
+    }
+
+    hr->bpm = (uint8_t)((HR_SAMPLES_PER_MIN + rr / 2) / rr);
+
+    if ((hr->rr_avg_q4 == 0) || hr_agree( rr, hr->rr_avg_q4 >> 4 ))
+    {
+        if (hr->rr_avg_q4 == 0)
+        {
+            hr->rr_avg_q4 = rr << 4;
+        }
+        else
+        {
+            hr->rr_avg_q4 = hr->rr_avg_q4 - (hr->rr_avg_q4 >> 3) + (rr << 1);
+        }
+
+        if (hr->good_cnt < 255)
+        {
+            hr->good_cnt++;
+        }
+
+        hr->pend_cnt = 0;
+        return;
+    }
+
+    hr->good_cnt = 0;
+
+    if ((hr->pend_cnt != 0) && hr_agree( rr, hr->pend_rr ))
+    {
+        hr->pend_cnt++;
+    }
+    else
+    {
+        hr->pend_cnt = 1;
+    }
+
+    hr->pend_rr = rr;
+
+    if (hr->pend_cnt >= HR_PEND_MIN)
+    {
+        hr->rr_avg_q4 = rr << 4;
+        hr->good_cnt = HR_GOOD_MIN;
+        hr->pend_cnt = 0;
+    }
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_hr_init( T_ecg4_hr *hr )
+{
+    hr->rr_avg_q4 = 0;
+    hr->rr = 0;
+    hr->bpm = 0;
+    hr->good_cnt = 0;
+    hr->pend_rr = 0;
+    hr->pend_cnt = 0;
+    hr->last_beat = 0;
+    hr->overdue = 1;
+    hr->quality = HR_QUALITY_NONE;
+    hr->device_bpm = 0;
+}
+
+void ecg4_hr_warm_start( T_ecg4_hr *hr, uint16_t rr_avg_q4, uint16_t rr )
+{
+    ecg4_hr_init( hr );
+
+    if (((rr_avg_q4 >> 4) < HR_RR_MIN) || ((rr_avg_q4 >> 4) > HR_RR_MAX))
+    {
+        return;
+    }
+
+    // the restored average stands for the first accepted interval
+    hr->rr_avg_q4 = rr_avg_q4;
+    hr->rr = rr;
+    hr->good_cnt = HR_GOOD_MIN - 1;
+}
+
+uint8_t ecg4_hr_update( T_ecg4_hr *hr, T_ecg4_qrs *qrs, uint8_t beat )
+{
+    uint32_t limit;
+
+    if (beat)
+    {
+        hr->last_beat = ecg4_qrs_beat( qrs );
+        hr->overdue = 0;
+
+        if (ecg4_qrs_rr( qrs ) != 0)
+        {
+            hr_beat( hr, ecg4_qrs_rr( qrs ) );
+        }
+
+        return ecg4_hr_confident( hr );
+    }
+
+    if (!hr->overdue)
+    {
+        limit = HR_RR_MAX;
+
+        if (hr->rr_avg_q4 != 0)
+        {
+            limit = hr->rr_avg_q4 >> 3;
+        }
+
+        if (qrs->n - hr->last_beat > limit + ECG4_QRS_DELAY)
+        {
+            hr->overdue = 1;
+            hr->good_cnt = 0;
+        }
+    }
+
+    return 0;
+}
+
+void ecg4_hr_quality( T_ecg4_hr *hr, uint8_t quality )
+{
+    hr->quality = quality;
+}
+
+void ecg4_hr_device( T_ecg4_hr *hr, uint8_t bpm )
+{
+    hr->device_bpm = bpm;
+}
+
+uint8_t ecg4_hr_confident( T_ecg4_hr *hr )
+{
+    return (hr->good_cnt >= HR_GOOD_MIN) && !hr->overdue && (hr->quality != 0);
+}
+
+uint8_t ecg4_hr_get( T_ecg4_hr *hr )
+{
+    if (ecg4_hr_confident( hr ))
+    {
+        return hr->bpm;
+    }
+
+    return hr->device_bpm;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_hr.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
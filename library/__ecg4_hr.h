@@ -0,0 +1,181 @@
+/*
+    __ecg4_hr.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_hr.h
+@brief    ECG_4 Beat-to-beat Heart Rate
+*/
+/**
+@defgroup   ECG4_HR
+@brief      ECG_4 Beat-to-beat Heart Rate
+@{
+
+Instantaneous heart rate from the RR intervals of the QRS detector, measured in sample time (512 Hz),
+next to the averaged heart rate row of the device, which is reported about once per second.
+
+A beat-to-beat value is confident when all of the following hold:
+
+- the RR interval is between 123 and 1024 samples (250 - 30 BPM),
+- it is within 20% of the running average of the accepted intervals, two intervals in a row,
+- the last signal quality row did not report the sensor off,
+- the next beat is not overdue (twice the average interval since the last R peak).
+
+Otherwise ecg4_hr_get returns the last device value. A rate step larger than 20% is accepted
+after three consecutive intervals which agree with each other. After ecg4_hr_warm_start the restored
+average counts as the first accepted interval, so the first measured interval within 20% of it is confident.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+#include "__ecg4_qrs.h"
+
+#ifndef _ECG4_HR_H_
+#define _ECG4_HR_H_
+
+/** @defgroup ECG4_HR_TYPES Types */                          /** @{ */
+
+/**
+ * @struct T_ecg4_hr
+ * @brief Heart rate context
+ */
+typedef struct
+{
+    uint16_t rr_avg_q4;     /**< Running average of the accepted RR intervals, Q4, 0 - none */
+    uint16_t rr;            /**< Last RR interval in samples */
+    uint8_t  bpm;           /**< Beat-to-beat heart rate of the last RR interval */
+    uint8_t  good_cnt;      /**< Consecutive accepted RR intervals */
+    uint16_t pend_rr;       /**< Last rejected RR interval */
+    uint8_t  pend_cnt;      /**< Consecutive rejected RR intervals which agree with each other */
+    uint32_t last_beat;     /**< Sample index of the last R peak */
+    uint8_t  overdue;
+    uint8_t  quality;       /**< Last signal quality row, 0xFF - none yet */
+    uint8_t  device_bpm;    /**< Last heart rate row */
+
+}T_ecg4_hr;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_HR_FUNC Heart Rate Functions */            /** @{ */
+
+/**
+ * @brief Heart Rate Init function
+ *
+ * @param[in] hr  Heart rate context
+ */
+void ecg4_hr_init( T_ecg4_hr *hr );
+
+/**
+ * @brief Heart Rate Warm Start function
+ *
+ * @param[in] hr         Heart rate context
+ * @param[in] rr_avg_q4  Average RR interval of a previous run (Q4)
+ * @param[in] rr         Last RR interval of a previous run
+ *
+ * Function initializes the context with the RR average of a previous run. The first RR interval after a
+ * restart is measured at the second beat, so a matching rhythm gets a confident value from that beat on
+ * instead of the third one. An average outside 30 - 250 BPM is ignored.
+ */
+void ecg4_hr_warm_start( T_ecg4_hr *hr, uint16_t rr_avg_q4, uint16_t rr );
+
+/**
+ * @brief Heart Rate Update function
+ *
+ * @param[in] hr    Heart rate context
+ * @param[in] qrs   QRS detector context
+ * @param[in] beat  Value returned by ecg4_qrs_process for the last sample
+ *
+ * @returns 1 - new beat-to-beat value is confident, 0 - otherwise
+ *
+ * Function must be called after every ecg4_qrs_process call.
+ * @note The beat is reported ECG4_QRS_DELAY samples (160 ms) or more after its R peak.
+ */
+uint8_t ecg4_hr_update( T_ecg4_hr *hr, T_ecg4_qrs *qrs, uint8_t beat );
+
+/**
+ * @brief Heart Rate Quality function
+ *
+ * @param[in] hr       Heart rate context
+ * @param[in] quality  Signal quality row value (_ECG4_SIGNAL_QUALITY_CODE_BYTE)
+ */
+void ecg4_hr_quality( T_ecg4_hr *hr, uint8_t quality );
+
+/**
+ * @brief Heart Rate Device Value function
+ *
+ * @param[in] hr   Heart rate context
+ * @param[in] bpm  Heart rate row value (_ECG4_HEART_RATE_CODE_BYTE)
+ */
+void ecg4_hr_device( T_ecg4_hr *hr, uint8_t bpm );
+
+/**
+ * @brief Heart Rate Confident function
+ *
+ * @returns 1 - beat-to-beat heart rate is confident, 0 - device heart rate is used
+ */
+uint8_t ecg4_hr_confident( T_ecg4_hr *hr );
+
+/**
+ * @brief Heart Rate Get function
+ *
+ * @returns Beat-to-beat heart rate in BPM when confident, otherwise the last device heart rate
+ */
+uint8_t ecg4_hr_get( T_ecg4_hr *hr );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_hr.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
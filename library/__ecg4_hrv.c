@@ -0,0 +1,340 @@
+/*
+    __ecg4_hrv.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_hrv.h"
+#ifdef ECG4_HRV_FLOAT
+#include <math.h>
+#endif
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define HRV_RR_MIN              128
+#define HRV_RR_MAX              1024
+#define HRV_RR_REF              512
+#define HRV_SUCCESSIVE          0x8000
+#define HRV_RR_MASK             0x7FFF
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint8_t hrv_nn50( int16_t diff )
+{
+    // 50 ms = 25.6 samples
+    if (diff < 0)
+    {
+        diff = -diff;
+    }
+
+    return (int32_t)diff * 125 > 50 * 64;
+}
+
+static void hrv_evict( T_ecg4_hrv *hrv, T_ecg4_hrv_win *win )
+{
+    int16_t rr;
+    int16_t dev;
+    int16_t diff;
+
+    rr = hrv->ring[ win->tail ] & HRV_RR_MASK;
+    dev = rr - HRV_RR_REF;
+    win->sum -= dev;
+    win->sum_sq -= (T_ecg4_hrv_sq)((int32_t)dev * dev);
+    win->span -= rr;
+    win->n--;
+
+    if (++win->tail == ECG4_HRV_RING)
+    {
+        win->tail = 0;
+    }
+
+    // the difference to the next interval leaves with this one
+    if ((win->n != 0) && (hrv->ring[ win->tail ] & HRV_SUCCESSIVE))
+    {
+        diff = (int16_t)(hrv->ring[ win->tail ] & HRV_RR_MASK) - rr;
+        win->sum_sq_diff -= (T_ecg4_hrv_sq)((int32_t)diff * diff);
+        win->n_diff--;
+
+        if (hrv_nn50( diff ))
+        {
+            win->nn50--;
+        }
+    }
+}
+
+static void hrv_add( T_ecg4_hrv *hrv, T_ecg4_hrv_win *win, uint16_t idx, uint16_t prev )
+{
+    int16_t rr;
+    int16_t dev;
+    int16_t diff;
+
+    rr = hrv->ring[ idx ] & HRV_RR_MASK;
+    dev = rr - HRV_RR_REF;
+
+    if (win->n == 0)
+    {
+        win->tail = idx;
+    }
+
+    win->sum += dev;
+    win->sum_sq += (T_ecg4_hrv_sq)((int32_t)dev * dev);
+    win->span += rr;
+    win->n++;
+
+    if ((win->n > 1) && (hrv->ring[ idx ] & HRV_SUCCESSIVE))
+    {
+        diff = rr - (int16_t)(hrv->ring[ prev ] & HRV_RR_MASK);
+        win->sum_sq_diff += (T_ecg4_hrv_sq)((int32_t)diff * diff);
+        win->n_diff++;
+
+        if (hrv_nn50( diff ))
+        {
+            win->nn50++;
+        }
+    }
+
+    while (win->span > win->len)
+    {
+        hrv_evict( hrv, win );
+    }
+}
+
+#ifndef ECG4_HRV_FLOAT
+static uint16_t hrv_isqrt( uint32_t val )
+{
+    uint32_t res;
+    uint32_t bit;
+
+    res = 0;
+    bit = (uint32_t)1 << 30;
+
+    while (bit > val)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (val >= res + bit)
+        {
+            val -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else
+        {
+            res >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return (uint16_t)res;
+}
+
+// sum_sq / n in Q8, without overflowing 32 bits
+static uint32_t hrv_mean_sq_q8( uint32_t sum_sq, uint16_t n )
+{
+    return (sum_sq / n) * 256 + ((sum_sq % n) * 256) / n;
+}
+
+// samples in Q4 to 0.1 ms
+static uint16_t hrv_ms10( uint32_t val_q4 )
+{
+    return (uint16_t)((val_q4 * 1250 + 512) / 1024);
+}
+#endif
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_hrv_init( T_ecg4_hrv *hrv )
+{
+    hrv->head = 0;
+    hrv->count = 0;
+    hrv->gap = 1;
+    hrv->n_win = 0;
+}
+
+uint8_t ecg4_hrv_window( T_ecg4_hrv *hrv, uint32_t len_ms )
+{
+    T_ecg4_hrv_win *win;
+
+    if (hrv->n_win == ECG4_HRV_WINDOWS)
+    {
+        return 0xFF;
+    }
+
+    win = &hrv->win[ hrv->n_win ];
+    win->len = len_ms * 64 / 125;
+    win->span = 0;
+    win->tail = 0;
+    win->n = 0;
+    win->sum = 0;
+    win->sum_sq = 0;
+    win->n_diff = 0;
+    win->sum_sq_diff = 0;
+    win->nn50 = 0;
+
+    return hrv->n_win++;
+}
+
+uint8_t ecg4_hrv_push( T_ecg4_hrv *hrv, uint16_t rr )
+{
+    uint16_t prev;
+    uint8_t cnt;
+
+    if ((rr < HRV_RR_MIN) || (rr > HRV_RR_MAX))
+    {
+        hrv->gap = 1;
+        return 0;
+    }
+
+    // the slot of the oldest interval is reused, windows still holding it let it go first
+    if (hrv->count == ECG4_HRV_RING)
+    {
+        for (cnt = 0; cnt < hrv->n_win; cnt++)
+        {
+            if ((hrv->win[ cnt ].n != 0) && (hrv->win[ cnt ].tail == hrv->head))
+            {
+                hrv_evict( hrv, &hrv->win[ cnt ] );
+            }
+        }
+    }
+    else
+    {
+        hrv->count++;
+    }
+
+    hrv->ring[ hrv->head ] = rr;
+
+    if (!hrv->gap)
+    {
+        hrv->ring[ hrv->head ] |= HRV_SUCCESSIVE;
+    }
+
+    hrv->gap = 0;
+    prev = (hrv->head == 0) ? ECG4_HRV_RING - 1 : hrv->head - 1;
+
+    for (cnt = 0; cnt < hrv->n_win; cnt++)
+    {
+        hrv_add( hrv, &hrv->win[ cnt ], hrv->head, prev );
+    }
+
+    if (++hrv->head == ECG4_HRV_RING)
+    {
+        hrv->head = 0;
+    }
+
+    return 1;
+}
+
+void ecg4_hrv_gap( T_ecg4_hrv *hrv )
+{
+    hrv->gap = 1;
+}
+
+uint8_t ecg4_hrv_get( T_ecg4_hrv *hrv, uint8_t idx, T_ecg4_hrv_result *res )
+{
+    T_ecg4_hrv_win *win;
+#ifdef ECG4_HRV_FLOAT
+    double mean;
+    double var;
+#else
+    int32_t quot;
+    int32_t rem;
+    uint32_t var_q8;
+#endif
+
+    if (idx >= hrv->n_win)
+    {
+        return 0;
+    }
+
+    win = &hrv->win[ idx ];
+    res->n = win->n;
+    res->span_ms = win->span * 125 / 64;
+
+    if (win->n < 2)
+    {
+        return 0;
+    }
+
+#ifdef ECG4_HRV_FLOAT
+    mean = win->sum / win->n;
+    var = win->sum_sq / win->n - mean * mean;
+    res->mean_rr = (HRV_RR_REF + mean) * 1000.0 / 512;
+    res->sdnn = sqrt( var > 0 ? var : 0 ) * 1000.0 / 512;
+    res->rmssd = 0;
+    res->pnn50 = 0;
+
+    if (win->n_diff != 0)
+    {
+        res->rmssd = sqrt( win->sum_sq_diff / win->n_diff ) * 1000.0 / 512;
+        res->pnn50 = win->nn50 * 100.0 / win->n_diff;
+    }
+#else
+    // sum = quot * n + rem, so n * sum_sq - sum^2 = n * (sum_sq - quot * (sum + rem)) - rem^2
+    quot = win->sum / (int32_t)win->n;
+    rem = win->sum % (int32_t)win->n;
+    var_q8 = hrv_mean_sq_q8( win->sum_sq - (uint32_t)(quot * (win->sum + rem)), win->n );
+    var_q8 -= (uint32_t)(rem * 256 / (int32_t)win->n * rem) / win->n;
+
+    res->mean_rr = hrv_ms10( (uint32_t)(HRV_RR_REF * 16 + win->sum * 16 / (int32_t)win->n) );
+    res->sdnn = hrv_ms10( hrv_isqrt( var_q8 ) );
+    res->rmssd = 0;
+    res->pnn50 = 0;
+
+    if (win->n_diff != 0)
+    {
+        res->rmssd = hrv_ms10( hrv_isqrt( hrv_mean_sq_q8( win->sum_sq_diff, win->n_diff ) ) );
+        res->pnn50 = (uint16_t)(((uint32_t)win->nn50 * 1000 + win->n_diff / 2) / win->n_diff);
+    }
+#endif
+
+    return 1;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_hrv.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
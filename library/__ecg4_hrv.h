@@ -0,0 +1,232 @@
+/*
+    __ecg4_hrv.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_hrv.h
+@brief    ECG_4 Heart Rate Variability
+*/
+/**
+@defgroup   ECG4_HRV
+@brief      ECG_4 Heart Rate Variability
+@{
+
+Incremental time-domain HRV metrics (mean RR, SDNN, RMSSD, pNN50) over sliding time windows, e.g. 1 and 5 minutes,
+fed with the RR intervals of the QRS detector (ecg4_qrs_rr, in samples of 1/512 s).
+
+The RR intervals are kept in a ring of ECG4_HRV_RING entries. Every window keeps running sums of the intervals, of
+their squares and of the squared successive differences over its own span of the ring: a new interval is added, and
+the oldest intervals leave the window while the window spans more than its length. Each interval enters and leaves
+a window once, so the update is O(1) per beat (amortized) and a query is O(1). SDNN is computed from the sums as
+sqrt( sum(x^2) / n - (sum(x) / n)^2 ), with x taken relative to 1 s to keep the sums small.
+
+By default the sums are 32 bit integers and the results are in 0.1 ms and 0.1 %, resolution 1/16 sample (0.12 ms).
+With ECG4_HRV_FLOAT defined (host builds), the sums are doubles and the results are in ms and %.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_HRV_H_
+#define _ECG4_HRV_H_
+
+/** @defgroup ECG4_HRV_VAR Variables */                       /** @{ */
+
+/**
+ * @macro ECG4_HRV_RING
+ * @brief Number of RR intervals kept, 1024 at most, a window never holds more
+ */
+#ifndef ECG4_HRV_RING
+#if defined( __MIKROC_PRO_FOR_PIC__ ) || defined( __MIKROC_PRO_FOR_AVR__ )
+#define ECG4_HRV_RING           384
+#else
+#define ECG4_HRV_RING           1024
+#endif
+#endif
+
+/**
+ * @macro ECG4_HRV_WINDOWS
+ * @brief Largest number of windows
+ */
+#ifndef ECG4_HRV_WINDOWS
+#define ECG4_HRV_WINDOWS        2
+#endif
+
+/**
+ * Compilation fails here when the ring is too large for the 32 bit sums.
+ */
+typedef char T_ecg4_hrv_ring_check[ ( ECG4_HRV_RING <= 1024 ) ? 1 : -1 ];
+
+                                                                       /** @} */
+/** @defgroup ECG4_HRV_TYPES Types */                         /** @{ */
+
+#ifdef ECG4_HRV_FLOAT
+typedef double   T_ecg4_hrv_sum;
+typedef double   T_ecg4_hrv_sq;
+typedef double   T_ecg4_hrv_val;    /**< ms, % */
+#else
+typedef int32_t  T_ecg4_hrv_sum;
+typedef uint32_t T_ecg4_hrv_sq;
+typedef uint16_t T_ecg4_hrv_val;    /**< 0.1 ms, 0.1 % */
+#endif
+
+/**
+ * @struct T_ecg4_hrv_win
+ * @brief Sliding window
+ */
+typedef struct
+{
+    uint32_t       len;             /**< Window length in samples */
+    uint32_t       span;            /**< Sum of the RR intervals in the window, in samples */
+    uint16_t       tail;            /**< Ring index of the oldest interval in the window */
+    uint16_t       n;               /**< RR intervals in the window */
+    T_ecg4_hrv_sum sum;             /**< Sum of RR - 512 */
+    T_ecg4_hrv_sq  sum_sq;          /**< Sum of (RR - 512)^2 */
+    uint16_t       n_diff;          /**< Successive differences in the window */
+    T_ecg4_hrv_sq  sum_sq_diff;     /**< Sum of the squared successive differences */
+    uint16_t       nn50;            /**< Successive differences larger than 50 ms */
+
+}T_ecg4_hrv_win;
+
+/**
+ * @struct T_ecg4_hrv
+ * @brief HRV context
+ */
+typedef struct
+{
+    uint16_t       ring[ ECG4_HRV_RING ];   /**< RR intervals in samples, bit 15 - successive to the previous one */
+    uint16_t       head;                    /**< Ring index of the next interval */
+    uint16_t       count;                   /**< RR intervals in the ring */
+    uint8_t        gap;                     /**< Next interval is not successive to the previous one */
+    uint8_t        n_win;
+    T_ecg4_hrv_win win[ ECG4_HRV_WINDOWS ];
+
+}T_ecg4_hrv;
+
+/**
+ * @struct T_ecg4_hrv_result
+ * @brief HRV metrics of a window
+ */
+typedef struct
+{
+    uint16_t       n;               /**< RR intervals in the window */
+    uint32_t       span_ms;         /**< Time covered by the window */
+    T_ecg4_hrv_val mean_rr;
+    T_ecg4_hrv_val sdnn;
+    T_ecg4_hrv_val rmssd;
+    T_ecg4_hrv_val pnn50;
+
+}T_ecg4_hrv_result;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_HRV_FUNC HRV Functions */                  /** @{ */
+
+/**
+ * @brief HRV Init function
+ *
+ * @param[in] hrv  HRV context
+ *
+ * Function initializes the context without windows.
+ */
+void ecg4_hrv_init( T_ecg4_hrv *hrv );
+
+/**
+ * @brief HRV Window function
+ *
+ * @param[in] hrv     HRV context
+ * @param[in] len_ms  Window length in ms, 60000 - 1 minute
+ *
+ * @returns Window index, 0xFF - ECG4_HRV_WINDOWS windows already added
+ */
+uint8_t ecg4_hrv_window( T_ecg4_hrv *hrv, uint32_t len_ms );
+
+/**
+ * @brief HRV Push function
+ *
+ * @param[in] hrv  HRV context
+ * @param[in] rr   RR interval in samples (ecg4_qrs_rr)
+ *
+ * @returns 1 - interval added, 0 - interval out of the 128 - 1024 samples range (30 - 240 BPM), ignored as a gap
+ *
+ * @note Push only the intervals of confident beats (ecg4_hr_confident), and call ecg4_hrv_gap for the others.
+ */
+uint8_t ecg4_hrv_push( T_ecg4_hrv *hrv, uint16_t rr );
+
+/**
+ * @brief HRV Gap function
+ *
+ * @param[in] hrv  HRV context
+ *
+ * Function marks a gap (missed or rejected beat), no successive difference is taken across it.
+ */
+void ecg4_hrv_gap( T_ecg4_hrv *hrv );
+
+/**
+ * @brief HRV Get function
+ *
+ * @param[in]  hrv  HRV context
+ * @param[in]  idx  Window index
+ * @param[out] res  HRV metrics
+ *
+ * @returns 1 - metrics valid, 0 - fewer than 2 intervals in the window
+ */
+uint8_t ecg4_hrv_get( T_ecg4_hrv *hrv, uint8_t idx, T_ecg4_hrv_result *res );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_hrv.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
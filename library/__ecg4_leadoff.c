@@ -0,0 +1,224 @@
+/*
+    __ecg4_leadoff.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_leadoff.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define LEADOFF_WIN_LEN         16
+#define LEADOFF_SAT_MIN         8
+#define LEADOFF_BAD_MIN         2
+#define LEADOFF_GOOD_MIN        8
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_LEADOFF_SATURATED            = 0x01;
+const uint8_t _ECG4_LEADOFF_FLAT                 = 0x02;
+const uint8_t _ECG4_LEADOFF_VARIANCE             = 0x04;
+
+const uint8_t _ECG4_LEADS_ON                     = 0x00;
+const uint8_t _ECG4_LEADS_OFF                    = 0x01;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void leadoff_window_reset( T_ecg4_leadoff *lo )
+{
+    lo->win_cnt = 0;
+    lo->sat_cnt = 0;
+    lo->win_min = 32767;
+    lo->win_max = -32768;
+    lo->sum = 0;
+    lo->sum_sq = 0;
+}
+
+static uint8_t leadoff_window_check( T_ecg4_leadoff *lo )
+{
+    uint8_t reason;
+    uint32_t sum_2;
+    uint32_t var;
+
+    reason = 0;
+
+    if ((lo->sat_level != 0) && (lo->sat_cnt >= LEADOFF_SAT_MIN))
+    {
+        reason |= _ECG4_LEADOFF_SATURATED;
+    }
+
+    if ((lo->flat_span != 0) && ((uint16_t)((int32_t)lo->win_max - lo->win_min) < lo->flat_span))
+    {
+        reason |= _ECG4_LEADOFF_FLAT;
+    }
+
+    if (lo->var_max != 0)
+    {
+        // (n sum(x^2) - sum(x)^2) / n^2, n = 16
+        sum_2 = (uint32_t)((int32_t)lo->sum * lo->sum);
+        var = (lo->sum_sq * LEADOFF_WIN_LEN - sum_2) >> 8;
+
+        if (var > lo->var_max)
+        {
+            reason |= _ECG4_LEADOFF_VARIANCE;
+        }
+    }
+
+    return reason;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_leadoff_init( T_ecg4_leadoff *lo )
+{
+    lo->sat_level = 32000;
+    lo->flat_span = 4;
+    lo->var_max = 250000;
+    lo->bad_cnt = 0;
+    lo->good_cnt = 0;
+    lo->state = _ECG4_LEADS_ON;
+    lo->reason = 0;
+    leadoff_window_reset( lo );
+}
+
+void ecg4_leadoff_config( T_ecg4_leadoff *lo, int16_t sat_level, uint16_t flat_span, uint32_t var_max )
+{
+    lo->sat_level = sat_level;
+    lo->flat_span = flat_span;
+    lo->var_max = var_max;
+}
+
+uint8_t ecg4_leadoff_process( T_ecg4_leadoff *lo, int16_t sample )
+{
+    int16_t x_16;
+    uint8_t reason;
+
+    if ((sample >= lo->sat_level) || (sample <= -lo->sat_level))
+    {
+        lo->sat_cnt++;
+    }
+
+    if (sample < lo->win_min)
+    {
+        lo->win_min = sample;
+    }
+
+    if (sample > lo->win_max)
+    {
+        lo->win_max = sample;
+    }
+
+    x_16 = sample >> 4;
+    lo->sum += x_16;
+    lo->sum_sq += (uint32_t)((int32_t)x_16 * x_16);
+
+    if (++lo->win_cnt < LEADOFF_WIN_LEN)
+    {
+        return 0;
+    }
+
+    reason = leadoff_window_check( lo );
+    leadoff_window_reset( lo );
+
+    if (reason)
+    {
+        lo->reason = reason;
+        lo->good_cnt = 0;
+
+        if (lo->bad_cnt < LEADOFF_BAD_MIN)
+        {
+            lo->bad_cnt++;
+        }
+
+        if ((lo->state == _ECG4_LEADS_ON) && (lo->bad_cnt >= LEADOFF_BAD_MIN))
+        {
+            lo->state = _ECG4_LEADS_OFF;
+            return 1;
+        }
+    }
+    else
+    {
+        lo->bad_cnt = 0;
+
+        if (lo->good_cnt < LEADOFF_GOOD_MIN)
+        {
+            lo->good_cnt++;
+        }
+
+        if ((lo->state == _ECG4_LEADS_OFF) && (lo->good_cnt >= LEADOFF_GOOD_MIN))
+        {
+            lo->state = _ECG4_LEADS_ON;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t ecg4_leadoff_block( T_ecg4_leadoff *lo, const int16_t *samples, uint16_t n_samples )
+{
+    uint16_t cnt;
+
+    for (cnt = 0; cnt < n_samples; cnt++)
+    {
+        ecg4_leadoff_process( lo, samples[ cnt ] );
+    }
+
+    return lo->state;
+}
+
+uint8_t ecg4_leadoff_state( T_ecg4_leadoff *lo )
+{
+    return lo->state;
+}
+
+uint8_t ecg4_leadoff_reason( T_ecg4_leadoff *lo )
+{
+    return lo->reason;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_leadoff.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,185 @@
+/*
+    __ecg4_leadoff.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_leadoff.h
+@brief    ECG_4 Lead-off Detector
+*/
+/**
+@defgroup   ECG4_LEADOFF
+@brief      ECG_4 Lead-off Detector
+@{
+
+Lead-off detection from the 512 Hz raw data, without waiting for the signal quality row (about 1 Hz).
+The raw data is checked in windows of 16 samples (31 ms):
+
+| Check      | Window is bad when                                                    |
+|:----------:|:----------------------------------------------------------------------|
+| Saturated  | half of the samples or more are at or beyond +-sat_level              |
+| Flat-line  | maximum - minimum is below flat_span                                  |
+| Variance   | variance of x / 16 is above var_max                                   |
+
+Two bad windows in a row (62 ms) set the lead-off state, eight good windows in a row (250 ms) clear it.
+The per-sample cost is a few additions and one 16 x 16 bit multiplication.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_LEADOFF_H_
+#define _ECG4_LEADOFF_H_
+
+/** @defgroup ECG4_LEADOFF_VAR Variables */                   /** @{ */
+
+extern const uint8_t _ECG4_LEADOFF_SATURATED            ;
+extern const uint8_t _ECG4_LEADOFF_FLAT                 ;
+extern const uint8_t _ECG4_LEADOFF_VARIANCE             ;
+
+extern const uint8_t _ECG4_LEADS_ON                     ;
+extern const uint8_t _ECG4_LEADS_OFF                    ;
+
+                                                                       /** @} */
+/** @defgroup ECG4_LEADOFF_TYPES Types */                     /** @{ */
+
+/**
+ * @struct T_ecg4_leadoff
+ * @brief Lead-off detector context
+ */
+typedef struct
+{
+    int16_t  sat_level;     /**< Saturation level */
+    uint16_t flat_span;     /**< Minimum peak to peak span of a good window */
+    uint32_t var_max;       /**< Maximum variance of x / 16 of a good window */
+    uint8_t  win_cnt;       /**< Samples in the current window */
+    uint8_t  sat_cnt;
+    int16_t  win_min;
+    int16_t  win_max;
+    int16_t  sum;           /**< Sum of x / 16 */
+    uint32_t sum_sq;        /**< Sum of (x / 16)^2 */
+    uint8_t  bad_cnt;       /**< Consecutive bad windows */
+    uint8_t  good_cnt;      /**< Consecutive good windows */
+    uint8_t  state;         /**< _ECG4_LEADS_ON or _ECG4_LEADS_OFF */
+    uint8_t  reason;        /**< Checks failed by the last bad window */
+
+}T_ecg4_leadoff;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_LEADOFF_FUNC Lead-off Detector Functions */ /** @{ */
+
+/**
+ * @brief Lead-off Detector Init function
+ *
+ * @param[in] lo  Lead-off detector context
+ *
+ * Function initializes the detector in the leads on state, with the saturation level 32000,
+ * the flat-line span 4 and the variance limit 250000 (standard deviation of about 8000).
+ */
+void ecg4_leadoff_init( T_ecg4_leadoff *lo );
+
+/**
+ * @brief Lead-off Detector Config function
+ *
+ * @param[in] lo         Lead-off detector context
+ * @param[in] sat_level  Saturation level, 0 - check off
+ * @param[in] flat_span  Minimum peak to peak span of a good window, 0 - check off
+ * @param[in] var_max    Maximum variance of x / 16 of a good window, 0 - check off
+ */
+void ecg4_leadoff_config( T_ecg4_leadoff *lo, int16_t sat_level, uint16_t flat_span, uint32_t var_max );
+
+/**
+ * @brief Lead-off Detector Process function
+ *
+ * @param[in] lo      Lead-off detector context
+ * @param[in] sample  Raw data sample
+ *
+ * @returns 1 - lead-off state changed, 0 - no change
+ */
+uint8_t ecg4_leadoff_process( T_ecg4_leadoff *lo, int16_t sample );
+
+/**
+ * @brief Lead-off Detector Block function
+ *
+ * @param[in] lo         Lead-off detector context
+ * @param[in] samples    Raw data samples
+ * @param[in] n_samples  Number of samples
+ *
+ * @returns Lead-off state at the end of the block, _ECG4_LEADS_ON or _ECG4_LEADS_OFF
+ *
+ * Function processes a block of raw data samples, windows may span several blocks.
+ */
+uint8_t ecg4_leadoff_block( T_ecg4_leadoff *lo, const int16_t *samples, uint16_t n_samples );
+
+/**
+ * @brief Lead-off Detector State function
+ *
+ * @returns _ECG4_LEADS_ON or _ECG4_LEADS_OFF
+ */
+uint8_t ecg4_leadoff_state( T_ecg4_leadoff *lo );
+
+/**
+ * @brief Lead-off Detector Reason function
+ *
+ * @returns Checks failed by the last bad window, combination of _ECG4_LEADOFF_SATURATED,
+ *          _ECG4_LEADOFF_FLAT and _ECG4_LEADOFF_VARIANCE
+ */
+uint8_t ecg4_leadoff_reason( T_ecg4_leadoff *lo );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_leadoff.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
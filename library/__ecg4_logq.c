@@ -0,0 +1,179 @@
+/*
+    __ecg4_logq.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_logq.h"
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint16_t logq_len( char *text )
+{
+    uint16_t len;
+
+    len = 0;
+
+    while (text[ len ] != 0)
+    {
+        len++;
+    }
+
+    return len;
+}
+
+static void logq_put( T_ecg4_logq *q, char *text, uint16_t len )
+{
+    uint16_t cnt;
+
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        q->buf[ q->head ] = text[ cnt ];
+
+        if (++q->head == ECG4_LOGQ_SIZE)
+        {
+            q->head = 0;
+        }
+    }
+
+    q->fill += len;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_logq_init( T_ecg4_logq *q, T_ecg4_logq_write write )
+{
+    q->head = 0;
+    q->tail = 0;
+    q->fill = 0;
+    q->dropped = 0;
+    q->write = write;
+}
+
+uint8_t ecg4_logq_text( T_ecg4_logq *q, char *text )
+{
+    uint16_t len;
+
+    len = logq_len( text );
+
+    if (len > ECG4_LOGQ_SIZE - q->fill)
+    {
+        q->dropped++;
+
+        return 0;
+    }
+
+    logq_put( q, text, len );
+
+    return 1;
+}
+
+uint8_t ecg4_logq_line( T_ecg4_logq *q, char *text )
+{
+    uint16_t len;
+
+    len = logq_len( text );
+
+    if (len + 2 > ECG4_LOGQ_SIZE - q->fill)
+    {
+        q->dropped++;
+
+        return 0;
+    }
+
+    logq_put( q, text, len );
+    logq_put( q, "\r\n", 2 );
+
+    return 1;
+}
+
+uint16_t ecg4_logq_drain( T_ecg4_logq *q, uint16_t budget )
+{
+    char chunk[ ECG4_LOGQ_CHUNK + 1 ];
+    uint16_t len;
+    uint16_t cnt;
+
+    if (budget > ECG4_LOGQ_CHUNK)
+    {
+        budget = ECG4_LOGQ_CHUNK;
+    }
+
+    len = (q->fill < budget) ? q->fill : budget;
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        chunk[ cnt ] = q->buf[ q->tail ];
+
+        if (++q->tail == ECG4_LOGQ_SIZE)
+        {
+            q->tail = 0;
+        }
+    }
+
+    chunk[ len ] = 0;
+    q->fill -= len;
+    q->write( chunk );
+
+    return len;
+}
+
+uint16_t ecg4_logq_free( T_ecg4_logq *q )
+{
+    return ECG4_LOGQ_SIZE - q->fill;
+}
+
+uint8_t ecg4_logq_occupancy( T_ecg4_logq *q )
+{
+    return (uint8_t)(((uint32_t)q->fill * 100) / ECG4_LOGQ_SIZE);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_logq.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,189 @@
+/*
+    __ecg4_logq.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_logq.h
+@brief    ECG_4 Log Queue
+*/
+/**
+@defgroup   ECG4_LOGQ
+@brief      ECG_4 Log Queue
+@{
+
+Queue of the log text, which keeps the blocking log writes out of the packet time.
+
+A log write of the mikroSDK waits until every byte is sent, 3.3 ms for a 19 byte plot line at 57600 baud,
+while a BMD101 raw data packet arrives every 1.95 ms and the driver holds a single one, so the plot and status
+text written from the processing lose packets. The text is queued instead, by ecg4_logq_text and
+ecg4_logq_line, each text whole or not at all, and ecg4_logq_drain writes at most a byte budget of it after
+every packet, e.g. 6 bytes (1 ms at 57600 baud) of the 1.95 ms packet time. Text which does not fit is dropped
+and counted, ecg4_logq_free tells the room before a line is made of several texts.
+
+The queue occupancy (ecg4_logq_occupancy) is what the plot decimator follows (ecg4_decim_queue), so the
+plot stream is decimated to what the budget drains.
+
+The queue size is set at compile time by defining ECG4_LOGQ_SIZE in the project, 256 bytes by default.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_LOGQ_H_
+#define _ECG4_LOGQ_H_
+
+/** @defgroup ECG4_LOGQ_VAR Variables */                      /** @{ */
+
+#ifndef ECG4_LOGQ_SIZE
+#define ECG4_LOGQ_SIZE          256
+#endif
+
+/**
+ * Largest byte budget of a drain, the size of its chunk buffer on the stack.
+ */
+#define ECG4_LOGQ_CHUNK         32
+
+                                                                       /** @} */
+/** @defgroup ECG4_LOGQ_TYPES Types */                        /** @{ */
+
+/**
+ * @brief Blocking write of a text to the log link
+ */
+typedef void ( *T_ecg4_logq_write )( char *text );
+
+/**
+ * @struct T_ecg4_logq
+ * @brief Log queue context
+ */
+typedef struct
+{
+    char     buf[ ECG4_LOGQ_SIZE ];
+    uint16_t head;          /**< Index of the next queued byte */
+    uint16_t tail;          /**< Index of the next written byte */
+    uint16_t fill;          /**< Queued bytes */
+    uint32_t dropped;       /**< Texts dropped because the queue was full */
+    T_ecg4_logq_write write;
+
+}T_ecg4_logq;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_LOGQ_FUNC Log Queue Functions */           /** @{ */
+
+/**
+ * @brief Log Queue Init function
+ *
+ * @param[in] q      Log queue context
+ * @param[in] write  Function which writes a text to the log link, e.g. with mikrobus_logWrite and _LOG_TEXT
+ *
+ * Function empties the queue.
+ */
+void ecg4_logq_init( T_ecg4_logq *q, T_ecg4_logq_write write );
+
+/**
+ * @brief Log Queue Text function
+ *
+ * @param[in] q     Log queue context
+ * @param[in] text  Text to queue
+ *
+ * @returns 1 - queued, 0 - dropped, the queue has no room for the whole text
+ */
+uint8_t ecg4_logq_text( T_ecg4_logq *q, char *text );
+
+/**
+ * @brief Log Queue Line function
+ *
+ * @param[in] q     Log queue context
+ * @param[in] text  Text to queue, followed by a line end
+ *
+ * @returns 1 - queued, 0 - dropped, the queue has no room for the whole text and the line end
+ */
+uint8_t ecg4_logq_line( T_ecg4_logq *q, char *text );
+
+/**
+ * @brief Log Queue Drain function
+ *
+ * @param[in] q       Log queue context
+ * @param[in] budget  Largest number of bytes to write, up to ECG4_LOGQ_CHUNK
+ *
+ * @returns Number of bytes written
+ *
+ * Function writes the oldest queued bytes, at most budget of them, in a single write.
+ */
+uint16_t ecg4_logq_drain( T_ecg4_logq *q, uint16_t budget );
+
+/**
+ * @brief Log Queue Free function
+ *
+ * @param[in] q  Log queue context
+ *
+ * @returns Room left in the queue in bytes
+ */
+uint16_t ecg4_logq_free( T_ecg4_logq *q );
+
+/**
+ * @brief Log Queue Occupancy function
+ *
+ * @param[in] q  Log queue context
+ *
+ * @returns Queue occupancy in percent, 0 - 100
+ */
+uint8_t ecg4_logq_occupancy( T_ecg4_logq *q );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_logq.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
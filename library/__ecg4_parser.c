@@ -0,0 +1,250 @@
+/*
+    __ecg4_parser.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_parser.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define PARSER_SYNC_BYTE            0xAA
+#define PARSER_EXCODE_BYTE          0x55
+#define PARSER_QUALITY_CODE_BYTE    0x02
+#define PARSER_HEART_RATE_CODE_BYTE 0x03
+#define PARSER_RAW_DATA_CODE_BYTE   0x80
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_PARSER_NONE                  = 0x00;
+const uint8_t _ECG4_PARSER_PACKET                = 0x01;
+const uint8_t _ECG4_PARSER_QUALITY               = 0x02;
+const uint8_t _ECG4_PARSER_ERROR                 = 0x04;
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_parser_init( T_ecg4_parser *prs, T_ecg4_parser_hdl hdl )
+{
+    prs->hdl = hdl;
+    prs->quality = 0;
+    ecg4_parser_reset( prs );
+}
+
+void ecg4_parser_reset( T_ecg4_parser *prs )
+{
+    prs->rx_cnt = 0;
+    prs->rx_idx = 0;
+    prs->row_check = 0;
+    prs->checksum = 0;
+    prs->row_cnt = 0;
+    prs->quality_row_rcvd = 0;
+}
+
+uint8_t ecg4_parser_byte( T_ecg4_parser *prs, uint8_t rx_dat )
+{
+    uint8_t res;
+
+    if ((prs->rx_cnt == 0) && (rx_dat != PARSER_SYNC_BYTE))
+    {
+        prs->rx_cnt = 0;
+
+        return _ECG4_PARSER_NONE;
+    }
+    else if ((prs->rx_cnt == 1) && (rx_dat != PARSER_SYNC_BYTE))
+    {
+        prs->rx_cnt = 0;
+
+        return _ECG4_PARSER_NONE;
+    }
+    else if (prs->rx_cnt == 2)
+    {
+        prs->payload_size = rx_dat;
+        prs->rx_cnt++;
+        prs->row_check = 1;
+
+        return _ECG4_PARSER_NONE;
+    }
+    else if (prs->rx_cnt > 2)
+    {
+        if (prs->rx_cnt - 3 < prs->payload_size)
+        {
+            // an extended code level byte only precedes a code, 0x55 is a plain value anywhere else
+            if ((prs->row_check == 1) && (rx_dat == PARSER_EXCODE_BYTE))
+            {
+                prs->row_check = 1;
+                prs->checksum += rx_dat;
+                prs->rx_cnt++;
+
+                return _ECG4_PARSER_NONE;
+            }
+
+            if (prs->row_check == 1)
+            {
+                prs->op_code = rx_dat;
+                prs->row_check = 0;
+                prs->checksum += rx_dat;
+
+                if ((prs->op_code == PARSER_QUALITY_CODE_BYTE) || (prs->op_code == PARSER_HEART_RATE_CODE_BYTE))
+                {
+                    prs->row_size = 1;
+                    prs->row_size_check = 0;
+                }
+                else if (prs->op_code == PARSER_RAW_DATA_CODE_BYTE)
+                {
+                    prs->row_size_check = 1;
+                }
+                else
+                {
+                    prs->rx_cnt = 0;
+                    prs->checksum = 0;
+                    prs->row_cnt = 0;
+                    prs->quality_row_rcvd = 0;
+
+                    return _ECG4_PARSER_NONE;
+                }
+
+                prs->rx_idx = 0;
+                prs->rx_cnt++;
+
+                return _ECG4_PARSER_NONE;
+            }
+
+            if (prs->row_size_check == 1)
+            {
+                prs->row_size = rx_dat;
+                prs->row_size_check = 0;
+                prs->checksum += rx_dat;
+                prs->rx_cnt++;
+
+                return _ECG4_PARSER_NONE;
+            }
+
+            if (prs->rx_idx < prs->row_size)
+            {
+                prs->rx_buff[ prs->rx_idx ] = rx_dat;
+                prs->rx_idx++;
+                prs->checksum += rx_dat;
+
+                if (prs->rx_idx == prs->row_size)
+                {
+                    if (prs->op_code == PARSER_QUALITY_CODE_BYTE)
+                    {
+                        prs->quality_row = prs->rx_buff[ 0 ];
+                        prs->quality_row_rcvd = 1;
+                    }
+
+                    if (prs->hdl != 0)
+                    {
+                        prs->hdl( &prs->op_code, &prs->row_size, prs->rx_buff, &prs->row_cnt );
+                    }
+
+                    prs->row_cnt++;
+                    prs->row_check = 1;
+                }
+
+                prs->rx_cnt++;
+
+                return _ECG4_PARSER_NONE;
+            }
+        }
+        else
+        {
+            prs->checksum = ~prs->checksum;
+
+            if (prs->checksum == rx_dat)
+            {
+                res = _ECG4_PARSER_PACKET;
+
+                if (prs->quality_row_rcvd)
+                {
+                    prs->quality = prs->quality_row;
+                    res |= _ECG4_PARSER_QUALITY;
+                }
+            }
+            else
+            {
+                res = _ECG4_PARSER_ERROR;
+            }
+
+            prs->quality_row_rcvd = 0;
+            prs->checksum = 0;
+            prs->row_cnt = 0;
+            prs->rx_cnt = 0;
+            prs->rx_idx = 0;
+
+            return res;
+        }
+    }
+
+    prs->rx_cnt++;
+
+    return _ECG4_PARSER_NONE;
+}
+
+uint8_t ecg4_parser_block( T_ecg4_parser *prs, const uint8_t *buf, uint16_t len, uint16_t *used )
+{
+    uint16_t cnt;
+    uint8_t res;
+
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        res = ecg4_parser_byte( prs, buf[ cnt ] );
+
+        if (res != _ECG4_PARSER_NONE)
+        {
+            *used = cnt + 1;
+
+            return res;
+        }
+    }
+
+    *used = len;
+
+    return _ECG4_PARSER_NONE;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_parser.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+    __ecg4_parser.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_parser.h
+@brief    ECG_4 Stream Parser
+*/
+/**
+@defgroup   ECG4_PARSER
+@brief      ECG_4 Stream Parser
+@{
+
+Parser of the BMD101 (ThinkGear) stream, with its state in a context: ecg4_uart_isr feeds it from the uart,
+host tools feed it from buffers. Every completed row is passed to the handler, and the end of a packet is
+returned as a verified packet or a checksum error. Extended code level bytes (0x55) are skipped only in front of
+a row code, so raw data values holding a 0x55 byte are passed on unchanged.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_PARSER_H_
+#define _ECG4_PARSER_H_
+
+/** @defgroup ECG4_PARSER_VAR Variables */                    /** @{ */
+
+extern const uint8_t _ECG4_PARSER_NONE                  ;
+extern const uint8_t _ECG4_PARSER_PACKET                ;
+extern const uint8_t _ECG4_PARSER_QUALITY               ;
+extern const uint8_t _ECG4_PARSER_ERROR                 ;
+
+                                                                       /** @} */
+/** @defgroup ECG4_PARSER_TYPES Types */                      /** @{ */
+
+typedef void ( *T_ecg4_parser_hdl )( uint8_t*, uint8_t*, uint8_t*, uint8_t* );
+
+/**
+ * @struct T_ecg4_parser
+ * @brief Parser context
+ */
+typedef struct
+{
+    uint8_t rx_buff[ 256 ];
+    uint8_t rx_cnt;
+    uint8_t rx_idx;
+    uint8_t payload_size;
+    uint8_t row_check;
+    uint8_t op_code;
+    uint8_t row_size;
+    uint8_t row_size_check;
+    uint8_t checksum;
+    uint8_t row_cnt;
+    uint8_t quality_row;
+    uint8_t quality_row_rcvd;
+    uint8_t quality;            /**< Signal quality of the last verified packet with a signal quality row */
+    T_ecg4_parser_hdl hdl;
+
+}T_ecg4_parser;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_PARSER_FUNC Parser Functions */            /** @{ */
+
+/**
+ * @brief Parser Init function
+ *
+ * @param[in] prs  Parser context
+ * @param[in] hdl  Row handler (op code, row size, row data, row counter), 0 - none
+ */
+void ecg4_parser_init( T_ecg4_parser *prs, T_ecg4_parser_hdl hdl );
+
+/**
+ * @brief Parser Reset function
+ *
+ * Function drops the packet in progress, the parser waits for the next sync bytes.
+ */
+void ecg4_parser_reset( T_ecg4_parser *prs );
+
+/**
+ * @brief Parser Byte function
+ *
+ * @param[in] prs     Parser context
+ * @param[in] rx_dat  Received byte
+ *
+ * @returns _ECG4_PARSER_NONE, _ECG4_PARSER_ERROR (checksum error) or _ECG4_PARSER_PACKET (verified packet),
+ *          or-ed with _ECG4_PARSER_QUALITY when the packet holds a signal quality row
+ */
+uint8_t ecg4_parser_byte( T_ecg4_parser *prs, uint8_t rx_dat );
+
+/**
+ * @brief Parser Block function
+ *
+ * @param[in]  prs   Parser context
+ * @param[in]  buf   Received bytes
+ * @param[in]  len   Number of bytes
+ * @param[out] used  Bytes parsed, up to the end of the first packet
+ *
+ * @returns Result of ecg4_parser_byte for the end of the packet, _ECG4_PARSER_NONE - all bytes parsed
+ */
+uint8_t ecg4_parser_block( T_ecg4_parser *prs, const uint8_t *buf, uint16_t len, uint16_t *used );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_parser.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
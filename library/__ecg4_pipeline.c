@@ -0,0 +1,212 @@
+/*
+    __ecg4_pipeline.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_pipeline.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define PIPE_QUALITY_NONE       0xFF
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_PIPE_OFF                     = 0x00;
+const uint8_t _ECG4_PIPE_SETTLING                = 0x01;
+const uint8_t _ECG4_PIPE_ON                      = 0x02;
+
+const uint8_t _ECG4_PIPE_RUN_SETTLING            = 0x01;
+
+const uint8_t _ECG4_PIPE_OK                      = 0x00;
+const uint8_t _ECG4_PIPE_ERR_FULL                = 0x01;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void pipe_settle( T_ecg4_pipeline *pipe )
+{
+    pipe->settle_left = pipe->settle_len;
+
+    if (pipe->settle_len == 0)
+    {
+        pipe->state = _ECG4_PIPE_ON;
+    }
+    else
+    {
+        pipe->state = _ECG4_PIPE_SETTLING;
+    }
+}
+
+static void pipe_update( T_ecg4_pipeline *pipe )
+{
+    uint8_t cnt;
+
+    if ((pipe->quality == 0) || pipe->leadoff)
+    {
+        if (pipe->state != _ECG4_PIPE_OFF)
+        {
+            pipe->state = _ECG4_PIPE_OFF;
+            pipe->stats.suspends++;
+        }
+    }
+    else if (pipe->state == _ECG4_PIPE_OFF)
+    {
+        for (cnt = 0; cnt < pipe->n_stages; cnt++)
+        {
+            if (pipe->stages[ cnt ].reset != 0)
+            {
+                pipe->stages[ cnt ].reset( pipe->stages[ cnt ].ctx );
+            }
+        }
+
+        pipe->stats.resumes++;
+        pipe_settle( pipe );
+    }
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_pipe_init( T_ecg4_pipeline *pipe, uint16_t settle_len )
+{
+    pipe->n_stages = 0;
+    pipe->quality = PIPE_QUALITY_NONE;
+    pipe->leadoff = 0;
+    pipe->settle_len = settle_len;
+
+    pipe->stats.samples_on = 0;
+    pipe->stats.samples_settling = 0;
+    pipe->stats.samples_off = 0;
+    pipe->stats.suspends = 0;
+    pipe->stats.resumes = 0;
+
+    pipe_settle( pipe );
+}
+
+uint8_t ecg4_pipe_register( T_ecg4_pipeline *pipe, T_ecg4_pipe_process process, T_ecg4_pipe_reset reset,
+                            void *ctx, uint8_t flags )
+{
+    T_ecg4_pipe_stage *stage;
+
+    if (pipe->n_stages == ECG4_PIPE_STAGES_MAX)
+    {
+        return _ECG4_PIPE_ERR_FULL;
+    }
+
+    stage = &pipe->stages[ pipe->n_stages++ ];
+    stage->process = process;
+    stage->reset = reset;
+    stage->ctx = ctx;
+    stage->flags = flags;
+
+    return _ECG4_PIPE_OK;
+}
+
+void ecg4_pipe_quality( T_ecg4_pipeline *pipe, uint8_t quality )
+{
+    pipe->quality = quality;
+    pipe_update( pipe );
+}
+
+void ecg4_pipe_leadoff( T_ecg4_pipeline *pipe, uint8_t leadoff )
+{
+    pipe->leadoff = leadoff;
+    pipe_update( pipe );
+}
+
+void ecg4_pipe_process( T_ecg4_pipeline *pipe, int16_t *samples, uint16_t n_samples )
+{
+    uint8_t cnt;
+
+    if (pipe->state == _ECG4_PIPE_OFF)
+    {
+        pipe->stats.samples_off += n_samples;
+        return;
+    }
+
+    if (pipe->state == _ECG4_PIPE_ON)
+    {
+        for (cnt = 0; cnt < pipe->n_stages; cnt++)
+        {
+            pipe->stages[ cnt ].process( pipe->stages[ cnt ].ctx, samples, n_samples );
+        }
+
+        pipe->stats.samples_on += n_samples;
+        return;
+    }
+
+    for (cnt = 0; cnt < pipe->n_stages; cnt++)
+    {
+        if (pipe->stages[ cnt ].flags & _ECG4_PIPE_RUN_SETTLING)
+        {
+            pipe->stages[ cnt ].process( pipe->stages[ cnt ].ctx, samples, n_samples );
+        }
+    }
+
+    pipe->stats.samples_settling += n_samples;
+
+    if (pipe->settle_left > n_samples)
+    {
+        pipe->settle_left -= n_samples;
+    }
+    else
+    {
+        pipe->settle_left = 0;
+        pipe->state = _ECG4_PIPE_ON;
+    }
+}
+
+uint8_t ecg4_pipe_state( T_ecg4_pipeline *pipe )
+{
+    return pipe->state;
+}
+
+void ecg4_pipe_stats_get( T_ecg4_pipeline *pipe, T_ecg4_pipe_stats *stats )
+{
+    *stats = pipe->stats;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_pipeline.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
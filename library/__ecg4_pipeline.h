@@ -0,0 +1,235 @@
+/*
+    __ecg4_pipeline.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_pipeline.h
+@brief    ECG_4 Processing Pipeline
+*/
+/**
+@defgroup   ECG4_PIPELINE
+@brief      ECG_4 Processing Pipeline
+@{
+
+Signal quality gated chain of raw data processing stages (filters, QRS detection, storage, telemetry).
+
+| State    | Entered when                                       | Stages run                              |
+|:--------:|:---------------------------------------------------|:----------------------------------------|
+| OFF      | quality row 0 (sensor off) or raw data lead-off    | none, samples are only counted          |
+| SETTLING | sensor back on, the stage reset functions are      | stages registered with                  |
+|          | called to re-prime their state                     | _ECG4_PIPE_RUN_SETTLING                 |
+| ON       | settle_len samples after SETTLING was entered      | all stages                              |
+
+While the sensor is off a block costs one comparison, so a patch which is not attached burns almost no CPU.
+Stages run in the order they were registered and work in place, each one sees the output of the previous one.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_PIPELINE_H_
+#define _ECG4_PIPELINE_H_
+
+/** @defgroup ECG4_PIPELINE_VAR Variables */                  /** @{ */
+
+/**
+ * @macro ECG4_PIPE_STAGES_MAX
+ * @brief Largest number of registered stages
+ */
+#ifndef ECG4_PIPE_STAGES_MAX
+#define ECG4_PIPE_STAGES_MAX    6
+#endif
+
+extern const uint8_t _ECG4_PIPE_OFF                     ;
+extern const uint8_t _ECG4_PIPE_SETTLING                ;
+extern const uint8_t _ECG4_PIPE_ON                      ;
+
+extern const uint8_t _ECG4_PIPE_RUN_SETTLING            ;
+
+extern const uint8_t _ECG4_PIPE_OK                      ;
+extern const uint8_t _ECG4_PIPE_ERR_FULL                ;
+
+                                                                       /** @} */
+/** @defgroup ECG4_PIPELINE_TYPES Types */                    /** @{ */
+
+/**
+ * @brief Stage process function, works on the samples in place
+ */
+typedef void ( *T_ecg4_pipe_process )( void *ctx, int16_t *samples, uint16_t n_samples );
+
+/**
+ * @brief Stage reset function, re-primes the stage state when the sensor is back on
+ */
+typedef void ( *T_ecg4_pipe_reset )( void *ctx );
+
+/**
+ * @struct T_ecg4_pipe_stage
+ * @brief Registered stage
+ */
+typedef struct
+{
+    T_ecg4_pipe_process process;
+    T_ecg4_pipe_reset   reset;
+    void                *ctx;
+    uint8_t             flags;
+
+}T_ecg4_pipe_stage;
+
+/**
+ * @struct T_ecg4_pipe_stats
+ * @brief Pipeline statistics
+ */
+typedef struct
+{
+    uint32_t samples_on;
+    uint32_t samples_settling;
+    uint32_t samples_off;       /**< Samples skipped while the sensor was off */
+    uint16_t suspends;
+    uint16_t resumes;
+
+}T_ecg4_pipe_stats;
+
+/**
+ * @struct T_ecg4_pipeline
+ * @brief Pipeline context
+ */
+typedef struct
+{
+    T_ecg4_pipe_stage stages[ ECG4_PIPE_STAGES_MAX ];
+    uint8_t  n_stages;
+    uint8_t  state;
+    uint8_t  quality;           /**< Last signal quality row, 0xFF - none yet */
+    uint8_t  leadoff;           /**< Raw data lead-off */
+    uint16_t settle_len;
+    uint16_t settle_left;
+    T_ecg4_pipe_stats stats;
+
+}T_ecg4_pipeline;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_PIPELINE_FUNC Pipeline Functions */        /** @{ */
+
+/**
+ * @brief Pipeline Init function
+ *
+ * @param[in] pipe        Pipeline context
+ * @param[in] settle_len  Samples run in the SETTLING state after the sensor is back on (512 - 1 s)
+ *
+ * Function initializes the pipeline without stages, in the SETTLING state.
+ */
+void ecg4_pipe_init( T_ecg4_pipeline *pipe, uint16_t settle_len );
+
+/**
+ * @brief Pipeline Register function
+ *
+ * @param[in] pipe     Pipeline context
+ * @param[in] process  Stage process function
+ * @param[in] reset    Stage reset function, 0 - none
+ * @param[in] ctx      Passed to the stage functions
+ * @param[in] flags    _ECG4_PIPE_RUN_SETTLING - stage also runs while settling, 0 - only when on
+ *
+ * @returns _ECG4_PIPE_OK or _ECG4_PIPE_ERR_FULL
+ */
+uint8_t ecg4_pipe_register( T_ecg4_pipeline *pipe, T_ecg4_pipe_process process, T_ecg4_pipe_reset reset,
+                            void *ctx, uint8_t flags );
+
+/**
+ * @brief Pipeline Quality function
+ *
+ * @param[in] pipe     Pipeline context
+ * @param[in] quality  Signal quality row value (_ECG4_SIGNAL_QUALITY_CODE_BYTE), 0 - sensor off
+ */
+void ecg4_pipe_quality( T_ecg4_pipeline *pipe, uint8_t quality );
+
+/**
+ * @brief Pipeline Lead-off function
+ *
+ * @param[in] pipe     Pipeline context
+ * @param[in] leadoff  1 - raw data lead-off detected, 0 - leads on
+ */
+void ecg4_pipe_leadoff( T_ecg4_pipeline *pipe, uint8_t leadoff );
+
+/**
+ * @brief Pipeline Process function
+ *
+ * @param[in]     pipe       Pipeline context
+ * @param[in,out] samples    Raw data samples
+ * @param[in]     n_samples  Number of samples
+ *
+ * Function runs the stages allowed in the current state over the samples.
+ */
+void ecg4_pipe_process( T_ecg4_pipeline *pipe, int16_t *samples, uint16_t n_samples );
+
+/**
+ * @brief Pipeline State function
+ *
+ * @returns _ECG4_PIPE_OFF, _ECG4_PIPE_SETTLING or _ECG4_PIPE_ON
+ */
+uint8_t ecg4_pipe_state( T_ecg4_pipeline *pipe );
+
+/**
+ * @brief Pipeline Statistics function
+ *
+ * @param[in]  pipe   Pipeline context
+ * @param[out] stats  Pipeline statistics
+ */
+void ecg4_pipe_stats_get( T_ecg4_pipeline *pipe, T_ecg4_pipe_stats *stats );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_pipeline.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
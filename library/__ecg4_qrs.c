@@ -0,0 +1,489 @@
+/*
+    __ecg4_qrs.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_qrs.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define QRS_LEARN_SAMPLES       1024
+#define QRS_SETTLE_SAMPLES      192
+#define QRS_REFRACTORY          102
+#define QRS_T_WAVE_WINDOW       184
+#define QRS_RR_INIT             512
+#define QRS_RR_MAX              1536
+#define QRS_CHUNK               32
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static int16_t qrs_bandpass( T_ecg4_qrs *qrs, int16_t sample )
+{
+    uint8_t x_idx;
+    uint8_t lp_idx;
+    int32_t lp_y;
+    int16_t lp;
+    int32_t hp;
+
+    x_idx = qrs->bp_idx & 0x1F;
+    lp_idx = qrs->bp_idx & 0x3F;
+
+    lp_y = 2 * qrs->lp_y1 - qrs->lp_y2 + sample - 2 * (int32_t)qrs->x_buf[ (x_idx + 16) & 0x1F ] + qrs->x_buf[ x_idx ];
+    qrs->x_buf[ x_idx ] = sample;
+    qrs->lp_y2 = qrs->lp_y1;
+    qrs->lp_y1 = lp_y;
+    lp = (int16_t)(lp_y >> 8);
+
+    qrs->hp_sum += (int32_t)lp - qrs->lp_buf[ lp_idx ];
+    qrs->lp_buf[ lp_idx ] = lp;
+    hp = (int32_t)qrs->lp_buf[ (lp_idx + 32) & 0x3F ] - (qrs->hp_sum >> 6);
+    qrs->bp_idx++;
+
+    if (hp > 32767)
+    {
+        hp = 32767;
+    }
+    else if (hp < -32768)
+    {
+        hp = -32768;
+    }
+
+    return (int16_t)hp;
+}
+
+static uint16_t qrs_slope( const int16_t *hp )
+{
+    int16_t d;
+    uint32_t sq;
+
+    d = (int16_t)((2 * (int32_t)hp[ 4 ] + hp[ 3 ] - hp[ 1 ] - 2 * (int32_t)hp[ 0 ]) >> 3);
+    sq = (uint32_t)((int32_t)d * d) >> 2;
+
+    if (sq > 0xFFFF)
+    {
+        sq = 0xFFFF;
+    }
+
+    return (uint16_t)sq;
+}
+
+static void qrs_slope_block( const int16_t *hp, uint16_t *sq, uint16_t n )
+{
+    uint16_t i;
+
+    i = 0;
+#ifdef __SSE2__
+    {
+        const __m128i bias = _mm_set1_epi32( 0x8000 );
+        const __m128i limit = _mm_set1_epi32( 0xFFFF );
+        __m128i a0, a1, a3, a4, d, lo, hi, s, over;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            a0 = _mm_loadl_epi64( (const __m128i*)(hp + i) );
+            a1 = _mm_loadl_epi64( (const __m128i*)(hp + i + 1) );
+            a3 = _mm_loadl_epi64( (const __m128i*)(hp + i + 3) );
+            a4 = _mm_loadl_epi64( (const __m128i*)(hp + i + 4) );
+            a0 = _mm_srai_epi32( _mm_unpacklo_epi16( a0, a0 ), 16 );
+            a1 = _mm_srai_epi32( _mm_unpacklo_epi16( a1, a1 ), 16 );
+            a3 = _mm_srai_epi32( _mm_unpacklo_epi16( a3, a3 ), 16 );
+            a4 = _mm_srai_epi32( _mm_unpacklo_epi16( a4, a4 ), 16 );
+
+            d = _mm_sub_epi32( _mm_add_epi32( _mm_add_epi32( a4, a4 ), a3 ), _mm_add_epi32( _mm_add_epi32( a0, a0 ), a1 ) );
+            d = _mm_srai_epi32( d, 3 );
+            d = _mm_packs_epi32( d, d );
+
+            lo = _mm_mullo_epi16( d, d );
+            hi = _mm_mulhi_epi16( d, d );
+            s = _mm_srli_epi32( _mm_unpacklo_epi16( lo, hi ), 2 );
+            over = _mm_cmpgt_epi32( s, limit );
+            s = _mm_or_si128( _mm_and_si128( over, limit ), _mm_andnot_si128( over, s ) );
+            s = _mm_packs_epi32( _mm_sub_epi32( s, bias ), _mm_setzero_si128() );
+            s = _mm_xor_si128( s, _mm_set1_epi16( (short)0x8000 ) );
+            _mm_storel_epi64( (__m128i*)(sq + i), s );
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        sq[ i ] = qrs_slope( hp + i );
+    }
+}
+
+static uint16_t qrs_integrate( T_ecg4_qrs *qrs, uint16_t sq )
+{
+    uint8_t idx;
+
+    idx = qrs->mwi_idx & 0x3F;
+    qrs->mwi_sum += (uint32_t)sq - qrs->mwi_buf[ idx ];
+    qrs->mwi_buf[ idx ] = sq;
+    qrs->mwi_idx++;
+
+    return (uint16_t)(qrs->mwi_sum >> 6);
+}
+
+static void qrs_threshold( T_ecg4_qrs *qrs )
+{
+    if (qrs->spki > qrs->npki)
+    {
+        qrs->thr = qrs->npki + ((qrs->spki - qrs->npki) >> 2);
+    }
+    else
+    {
+        qrs->thr = qrs->npki;
+    }
+}
+
+static void qrs_beat( T_ecg4_qrs *qrs, uint32_t pos, uint16_t peak )
+{
+    uint32_t rr;
+
+    rr = pos - qrs->last_pos;
+
+    if (qrs->last_peak == 0)
+    {
+        qrs->rr = 0;
+    }
+    else
+    {
+        if (rr > 0xFFFF)
+        {
+            rr = 0xFFFF;
+        }
+
+        qrs->rr = (uint16_t)rr;
+
+        if (rr < QRS_RR_MAX)
+        {
+            qrs->rr_avg = qrs->rr_avg - (qrs->rr_avg >> 3) + (qrs->rr >> 3);
+        }
+    }
+
+    qrs->last_pos = pos;
+    qrs->last_peak = peak;
+    qrs->beat = pos - ECG4_QRS_DELAY;
+    qrs->sb_val = 0;
+    qrs->sb_deadline = pos + qrs->rr_avg + (qrs->rr_avg >> 1) + (qrs->rr_avg >> 3);
+
+    qrs_threshold( qrs );
+}
+
+static uint8_t qrs_classify( T_ecg4_qrs *qrs )
+{
+    uint16_t peak;
+    uint32_t dist;
+
+    peak = qrs->peak_val;
+    dist = qrs->peak_pos - qrs->last_pos;
+
+    // before the first beat last_pos is the end of the learning phase, no refractory period applies
+    if (qrs->last_peak == 0)
+    {
+        dist = QRS_T_WAVE_WINDOW;
+    }
+
+    if ((peak > qrs->thr) && (dist > QRS_REFRACTORY) &&
+        ((dist >= QRS_T_WAVE_WINDOW) || (peak >= (qrs->last_peak >> 1))))
+    {
+        qrs->spki = qrs->spki - (qrs->spki >> 3) + (peak >> 3);
+        qrs_beat( qrs, qrs->peak_pos, peak );
+
+        return 1;
+    }
+
+    qrs->npki = qrs->npki - (qrs->npki >> 3) + (peak >> 3);
+
+    if ((dist > QRS_REFRACTORY) && (peak > (qrs->thr >> 1)) && (peak > qrs->sb_val))
+    {
+        qrs->sb_val = peak;
+        qrs->sb_pos = qrs->peak_pos;
+    }
+
+    qrs_threshold( qrs );
+
+    return 0;
+}
+
+static uint8_t qrs_search_back( T_ecg4_qrs *qrs )
+{
+    if (qrs->sb_val != 0)
+    {
+        qrs->spki = qrs->spki - (qrs->spki >> 2) + (qrs->sb_val >> 2);
+        qrs_beat( qrs, qrs->sb_pos, qrs->sb_val );
+
+        return 1;
+    }
+
+    qrs->spki -= qrs->spki >> 2;
+    qrs->sb_deadline = qrs->n + (qrs->rr_avg >> 1);
+    qrs_threshold( qrs );
+
+    return 0;
+}
+
+static void qrs_learn( T_ecg4_qrs *qrs, uint16_t mwi )
+{
+    if (mwi > qrs->learn_max)
+    {
+        qrs->learn_max = mwi;
+    }
+
+    qrs->learn_sum += mwi;
+    qrs->learn_cnt++;
+
+    if (qrs->learn_cnt == QRS_LEARN_SAMPLES)
+    {
+        if (!qrs->warm)
+        {
+            qrs->spki = qrs->learn_max / 3;
+            qrs->npki = (uint16_t)(qrs->learn_sum / (QRS_LEARN_SAMPLES * 2));
+        }
+
+        qrs->last_pos = qrs->n;
+        qrs->sb_deadline = qrs->n + qrs->rr_avg + (qrs->rr_avg >> 1) + (qrs->rr_avg >> 3);
+        qrs_threshold( qrs );
+    }
+}
+
+static uint8_t qrs_decide( T_ecg4_qrs *qrs, uint16_t mwi )
+{
+    uint8_t beat;
+
+    beat = 0;
+
+    if (qrs->learn_cnt < QRS_LEARN_SAMPLES)
+    {
+        qrs_learn( qrs, mwi );
+    }
+    else
+    {
+        if (qrs->peak_armed)
+        {
+            if (mwi > qrs->peak_val)
+            {
+                qrs->peak_val = mwi;
+                qrs->peak_pos = qrs->n;
+            }
+            else if (mwi < qrs->peak_val - (qrs->peak_val >> 2))
+            {
+                beat = qrs_classify( qrs );
+                qrs->peak_armed = 0;
+                qrs->peak_val = 0;
+            }
+        }
+        else if (mwi > qrs->mwi_prev)
+        {
+            qrs->peak_armed = 1;
+            qrs->peak_val = mwi;
+            qrs->peak_pos = qrs->n;
+        }
+
+        if ((beat == 0) && ((int32_t)(qrs->n - qrs->sb_deadline) >= 0))
+        {
+            beat = qrs_search_back( qrs );
+        }
+    }
+
+    qrs->mwi_prev = mwi;
+    qrs->n++;
+
+    return beat;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_qrs_init( T_ecg4_qrs *qrs )
+{
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < 32; cnt++)
+    {
+        qrs->x_buf[ cnt ] = 0;
+    }
+
+    for (cnt = 0; cnt < 64; cnt++)
+    {
+        qrs->lp_buf[ cnt ] = 0;
+        qrs->mwi_buf[ cnt ] = 0;
+    }
+
+    for (cnt = 0; cnt < 4; cnt++)
+    {
+        qrs->hp_hist[ cnt ] = 0;
+    }
+
+    qrs->lp_y1 = 0;
+    qrs->lp_y2 = 0;
+    qrs->hp_sum = 0;
+    qrs->mwi_sum = 0;
+    qrs->bp_idx = 0;
+    qrs->mwi_idx = 0;
+    qrs->mwi_prev = 0;
+    qrs->n = 0;
+
+    qrs->learn_cnt = 0;
+    qrs->learn_max = 0;
+    qrs->learn_sum = 0;
+    qrs->warm = 0;
+
+    qrs->spki = 0;
+    qrs->npki = 0;
+    qrs->thr = 0;
+    qrs->peak_armed = 0;
+    qrs->peak_val = 0;
+    qrs->peak_pos = 0;
+    qrs->sb_val = 0;
+    qrs->sb_pos = 0;
+    qrs->sb_deadline = 0;
+
+    qrs->last_pos = 0;
+    qrs->last_peak = 0;
+    qrs->rr_avg = QRS_RR_INIT;
+    qrs->rr = 0;
+    qrs->beat = 0;
+}
+
+void ecg4_qrs_warm_start( T_ecg4_qrs *qrs, uint16_t spki, uint16_t npki, uint16_t rr_avg )
+{
+    ecg4_qrs_init( qrs );
+
+    // the filters still have to settle, only the level learning is skipped
+    qrs->learn_cnt = QRS_LEARN_SAMPLES - QRS_SETTLE_SAMPLES;
+    qrs->warm = 1;
+    qrs->spki = spki;
+    qrs->npki = npki;
+
+    if ((rr_avg != 0) && (rr_avg < QRS_RR_MAX))
+    {
+        qrs->rr_avg = rr_avg;
+    }
+}
+
+uint8_t ecg4_qrs_process( T_ecg4_qrs *qrs, int16_t sample )
+{
+    int16_t hp[ 5 ];
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < 4; cnt++)
+    {
+        hp[ cnt ] = qrs->hp_hist[ cnt ];
+    }
+
+    hp[ 4 ] = qrs_bandpass( qrs, sample );
+
+    for (cnt = 0; cnt < 4; cnt++)
+    {
+        qrs->hp_hist[ cnt ] = hp[ cnt + 1 ];
+    }
+
+    return qrs_decide( qrs, qrs_integrate( qrs, qrs_slope( hp ) ) );
+}
+
+uint16_t ecg4_qrs_process_block( T_ecg4_qrs *qrs, const int16_t *samples, uint16_t n_samples,
+                                 uint32_t *beats, uint16_t max_beats )
+{
+    int16_t hp[ 4 + QRS_CHUNK ];
+    uint16_t sq[ QRS_CHUNK ];
+    uint16_t chunk;
+    uint16_t cnt;
+    uint16_t n_beats;
+
+    n_beats = 0;
+
+    while (n_samples > 0)
+    {
+        chunk = (n_samples > QRS_CHUNK) ? QRS_CHUNK : n_samples;
+
+        for (cnt = 0; cnt < 4; cnt++)
+        {
+            hp[ cnt ] = qrs->hp_hist[ cnt ];
+        }
+
+        for (cnt = 0; cnt < chunk; cnt++)
+        {
+            hp[ cnt + 4 ] = qrs_bandpass( qrs, samples[ cnt ] );
+        }
+
+        for (cnt = 0; cnt < 4; cnt++)
+        {
+            qrs->hp_hist[ cnt ] = hp[ chunk + cnt ];
+        }
+
+        qrs_slope_block( hp, sq, chunk );
+
+        for (cnt = 0; cnt < chunk; cnt++)
+        {
+            if (qrs_decide( qrs, qrs_integrate( qrs, sq[ cnt ] ) ) && (n_beats < max_beats))
+            {
+                beats[ n_beats ] = qrs->beat;
+                n_beats++;
+            }
+        }
+
+        samples += chunk;
+        n_samples -= chunk;
+    }
+
+    return n_beats;
+}
+
+uint32_t ecg4_qrs_beat( T_ecg4_qrs *qrs )
+{
+    return qrs->beat;
+}
+
+uint16_t ecg4_qrs_rr( T_ecg4_qrs *qrs )
+{
+    return qrs->rr;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_qrs.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,221 @@
+/*
+    __ecg4_qrs.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_qrs.h
+@brief    ECG_4 QRS Detector
+*/
+/**
+@defgroup   ECG4_QRS
+@brief      ECG_4 QRS Detector
+@{
+
+Integer-only streaming QRS detector (Pan-Tompkins) for the 512 Hz raw data of the BMD101.
+
+| Stage           | Operation                                                         |
+|:---------------:|:------------------------------------------------------------------|
+| Low-pass        | y(n) = 2y(n-1) - y(n-2) + x(n) - 2x(n-16) + x(n-32), gain 256      |
+| High-pass       | x(n-32) - (64 samples moving average)                             |
+| Derivative      | (2x(n) + x(n-1) - x(n-3) - 2x(n-4)) / 8                           |
+| Squaring        | x(n)^2 / 4, saturated to 16 bits                                  |
+| Integration     | 64 samples (125 ms) moving window                                 |
+| Decision        | adaptive signal and noise peak levels, 200 ms refractory period, |
+|                 | T-wave rejection and search-back at 1.625 of the average RR        |
+
+Every stage works on running sums, so the per-sample cost is fixed: no loop runs over a sample window
+and the only multiplication is the 16 x 16 bit squaring. The first 2 s are used to learn the peak levels,
+unless the levels of a previous run are restored with ecg4_qrs_warm_start.
+
+The block function runs the same kernel over sample blocks. On a host with SSE2 the derivative and squaring
+stages are vectorised, the results are identical to the per-sample function.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_QRS_H_
+#define _ECG4_QRS_H_
+
+/** @defgroup ECG4_QRS_VAR Variables */                       /** @{ */
+
+/**
+ * @macro ECG4_QRS_DELAY
+ * @brief Delay in samples from the R peak to the integrated peak used for the detection
+ */
+#define ECG4_QRS_DELAY      81
+
+                                                                       /** @} */
+/** @defgroup ECG4_QRS_TYPES Types */                         /** @{ */
+
+/**
+ * @struct T_ecg4_qrs
+ * @brief QRS detector context
+ */
+typedef struct
+{
+    int16_t  x_buf[ 32 ];       /**< Low-pass input history */
+    int16_t  lp_buf[ 64 ];      /**< High-pass input history */
+    int16_t  hp_hist[ 4 ];      /**< Derivative input history, oldest first */
+    uint16_t mwi_buf[ 64 ];     /**< Integrator input history */
+    int32_t  lp_y1;
+    int32_t  lp_y2;
+    int32_t  hp_sum;
+    uint32_t mwi_sum;
+    uint8_t  bp_idx;
+    uint8_t  mwi_idx;
+    uint16_t mwi_prev;
+    uint32_t n;                 /**< Index of the next sample */
+
+    uint16_t learn_cnt;
+    uint16_t learn_max;
+    uint32_t learn_sum;
+    uint8_t  warm;              /**< Peak levels restored by ecg4_qrs_warm_start */
+
+    uint16_t spki;              /**< Signal peak level */
+    uint16_t npki;              /**< Noise peak level */
+    uint16_t thr;               /**< Detection threshold */
+    uint8_t  peak_armed;
+    uint16_t peak_val;
+    uint32_t peak_pos;
+    uint16_t sb_val;            /**< Search-back candidate */
+    uint32_t sb_pos;
+    uint32_t sb_deadline;
+
+    uint32_t last_pos;          /**< Integrated peak position of the last beat */
+    uint16_t last_peak;
+    uint16_t rr_avg;            /**< Average RR interval in samples */
+    uint16_t rr;                /**< Last RR interval in samples, 0 - no previous beat */
+    uint32_t beat;              /**< Sample index of the last detected R peak */
+
+}T_ecg4_qrs;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_QRS_FUNC QRS Detector Functions */         /** @{ */
+
+/**
+ * @brief QRS Detector Init function
+ *
+ * @param[in] qrs  QRS detector context
+ *
+ * Function initializes the detector and starts the 2 s learning phase.
+ */
+void ecg4_qrs_init( T_ecg4_qrs *qrs );
+
+/**
+ * @brief QRS Detector Warm Start function
+ *
+ * @param[in] qrs     QRS detector context
+ * @param[in] spki    Signal peak level of a previous run
+ * @param[in] npki    Noise peak level of a previous run
+ * @param[in] rr_avg  Average RR interval of a previous run in samples
+ *
+ * Function initializes the detector with the peak levels of a previous run, the 2 s learning phase is replaced
+ * by a 375 ms filter settling time, so the first beat is detected about one beat after the start.
+ */
+void ecg4_qrs_warm_start( T_ecg4_qrs *qrs, uint16_t spki, uint16_t npki, uint16_t rr_avg );
+
+/**
+ * @brief QRS Detector Process function
+ *
+ * @param[in] qrs     QRS detector context
+ * @param[in] sample  Raw data sample
+ *
+ * @returns 1 - beat detected, 0 - no beat
+ *
+ * Function processes one raw data sample. When a beat is detected, its R peak position is returned by
+ * ecg4_qrs_beat and the interval from the previous beat by ecg4_qrs_rr.
+ * @note A beat is reported ECG4_QRS_DELAY samples or more after its R peak, search-back beats later.
+ */
+uint8_t ecg4_qrs_process( T_ecg4_qrs *qrs, int16_t sample );
+
+/**
+ * @brief QRS Detector Block function
+ *
+ * @param[in]  qrs        QRS detector context
+ * @param[in]  samples    Raw data samples
+ * @param[in]  n_samples  Number of samples
+ * @param[out] beats      R peak positions of the detected beats
+ * @param[in]  max_beats  Size of the beats array
+ *
+ * @returns Number of detected beats
+ *
+ * Function processes a block of raw data samples, with the same results as ecg4_qrs_process.
+ * @note Beats are at least 200 ms apart, so n_samples / 100 + 2 entries are always enough.
+ *       Beats which do not fit in the beats array are dropped from the output only.
+ */
+uint16_t ecg4_qrs_process_block( T_ecg4_qrs *qrs, const int16_t *samples, uint16_t n_samples,
+                                 uint32_t *beats, uint16_t max_beats );
+
+/**
+ * @brief QRS Detector Beat function
+ *
+ * @returns Sample index of the R peak of the last detected beat
+ */
+uint32_t ecg4_qrs_beat( T_ecg4_qrs *qrs );
+
+/**
+ * @brief QRS Detector RR function
+ *
+ * @returns Interval between the last two beats in samples, 0 - first beat
+ */
+uint16_t ecg4_qrs_rr( T_ecg4_qrs *qrs );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_qrs.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
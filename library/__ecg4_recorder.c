@@ -0,0 +1,560 @@
+/*
+    __ecg4_recorder.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_recorder.h"
+#include "__ecg4_crc.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define REC_MAGIC_0             0x45
+#define REC_MAGIC_1             0x34
+#define REC_VERSION             0x02
+
+#define REC_TYPE_SAMPLES        0x01
+#define REC_TYPE_EVENT          0x02
+#define REC_SAMPLES_LEN         5
+#define REC_EVENT_LEN           7
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_REC_OK                       = 0x00;
+const uint8_t _ECG4_REC_ERR_IO                   = 0x01;
+const uint8_t _ECG4_REC_ERR_GEOMETRY             = 0x02;
+
+const uint8_t _ECG4_REC_ITEM_SAMPLES             = 0x01;
+const uint8_t _ECG4_REC_ITEM_EVENT               = 0x02;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void rec_put32( uint8_t *buf, uint32_t val )
+{
+    buf[ 0 ] = val >> 24;
+    buf[ 1 ] = val >> 16;
+    buf[ 2 ] = val >> 8;
+    buf[ 3 ] = val;
+}
+
+static uint32_t rec_get32( const uint8_t *buf )
+{
+    return ((uint32_t)buf[ 0 ] << 24) | ((uint32_t)buf[ 1 ] << 16) | ((uint32_t)buf[ 2 ] << 8) | buf[ 3 ];
+}
+
+static uint32_t rec_next_page( T_ecg4_recorder *rec, uint32_t page )
+{
+    if (++page == rec->dev->n_pages)
+    {
+        page = 0;
+    }
+
+    return page;
+}
+
+static uint16_t rec_page_crc( const uint8_t *page, uint16_t used )
+{
+    uint16_t crc;
+
+    crc = ecg4_crc16( ECG4_CRC16_INIT, page, 8 );
+
+    return ecg4_crc16( crc, page + ECG4_REC_HEADER_LEN, used );
+}
+
+static uint8_t rec_page_magic( const uint8_t *page )
+{
+    return (page[ 0 ] == REC_MAGIC_0) && (page[ 1 ] == REC_MAGIC_1);
+}
+
+static uint8_t rec_header_check( const uint8_t *page )
+{
+    uint8_t check;
+
+    check = (uint8_t)ecg4_crc16( ECG4_CRC16_INIT, page, 8 );
+
+    // never 0xFF, a header cut before its last byte does not pass
+    return (check == 0xFF) ? 0x00 : check;
+}
+
+static uint8_t rec_page_header( const uint8_t *page )
+{
+    return rec_page_magic( page ) && (page[ 11 ] == rec_header_check( page ));
+}
+
+static uint8_t rec_page_valid( T_ecg4_recorder *rec, const uint8_t *page )
+{
+    uint16_t used;
+
+    if (!rec_page_header( page ))
+    {
+        return 0;
+    }
+
+    used = ((uint16_t)page[ 6 ] << 8) | page[ 7 ];
+
+    if (used > rec->dev->page_size - ECG4_REC_HEADER_LEN)
+    {
+        return 0;
+    }
+
+    return rec_page_crc( page, used ) == (((uint16_t)page[ 8 ] << 8) | page[ 9 ]);
+}
+
+static uint16_t rec_record_parse( const uint8_t *payload, uint16_t used, uint16_t pos, T_ecg4_rec_item *item )
+{
+    uint16_t block_used;
+
+    if (pos + REC_SAMPLES_LEN > used)
+    {
+        return 0;
+    }
+
+    item->n = rec_get32( payload + pos + 1 );
+
+    if (payload[ pos ] == REC_TYPE_EVENT)
+    {
+        if (pos + REC_EVENT_LEN > used)
+        {
+            return 0;
+        }
+
+        item->type = _ECG4_REC_ITEM_EVENT;
+        item->code = payload[ pos + 5 ];
+        item->value = payload[ pos + 6 ];
+        item->n_samples = 0;
+
+        return REC_EVENT_LEN;
+    }
+
+    if (payload[ pos ] != REC_TYPE_SAMPLES)
+    {
+        return 0;
+    }
+
+    // the sample count is checked before decoding, item->samples holds ECG4_REC_BLOCK_MAX samples only
+    if ((pos + REC_SAMPLES_LEN + 2 > used) || (payload[ pos + REC_SAMPLES_LEN + 1 ] > ECG4_REC_BLOCK_MAX))
+    {
+        return 0;
+    }
+
+    item->type = _ECG4_REC_ITEM_SAMPLES;
+    item->n_samples = ecg4_rice_decode( payload + pos + REC_SAMPLES_LEN, used - pos - REC_SAMPLES_LEN,
+                                        item->samples, &block_used );
+
+    if (item->n_samples == 0)
+    {
+        return 0;
+    }
+
+    return REC_SAMPLES_LEN + block_used;
+}
+
+static uint8_t rec_program( T_ecg4_recorder *rec )
+{
+    T_ecg4_blockdev *dev;
+    uint16_t crc;
+    uint16_t cnt;
+
+    dev = rec->dev;
+
+    if ((dev->erase_pages != 0) && (rec->head % dev->erase_pages == 0))
+    {
+        if (dev->erase( dev->ctx, rec->head / dev->erase_pages ))
+        {
+            rec->stats.io_errors++;
+            return _ECG4_REC_ERR_IO;
+        }
+
+        rec->stats.erases++;
+    }
+
+    rec->page[ 0 ] = REC_MAGIC_0;
+    rec->page[ 1 ] = REC_MAGIC_1;
+    rec_put32( rec->page + 2, rec->seq );
+    rec->page[ 6 ] = rec->page_used >> 8;
+    rec->page[ 7 ] = rec->page_used;
+    crc = rec_page_crc( rec->page, rec->page_used );
+    rec->page[ 8 ] = crc >> 8;
+    rec->page[ 9 ] = crc;
+    rec->page[ 10 ] = REC_VERSION;
+    rec->page[ 11 ] = rec_header_check( rec->page );
+
+    for (cnt = ECG4_REC_HEADER_LEN + rec->page_used; cnt < dev->page_size; cnt++)
+    {
+        rec->page[ cnt ] = 0xFF;
+    }
+
+    // a failed page is skipped, the page buffer is kept for the next one
+    if (dev->prog( dev->ctx, rec->head, rec->page ))
+    {
+        rec->stats.io_errors++;
+        rec->head = rec_next_page( rec, rec->head );
+        rec->seq++;
+        return _ECG4_REC_ERR_IO;
+    }
+
+    rec->stats.pages++;
+    rec->head = rec_next_page( rec, rec->head );
+    rec->seq++;
+    rec->page_used = 0;
+
+    return _ECG4_REC_OK;
+}
+
+static uint8_t *rec_reserve( T_ecg4_recorder *rec, uint16_t len )
+{
+    uint8_t *rec_ptr;
+
+    if (ECG4_REC_HEADER_LEN + rec->page_used + len > rec->dev->page_size)
+    {
+        if (rec_program( rec ))
+        {
+            return 0;
+        }
+    }
+
+    rec_ptr = rec->page + ECG4_REC_HEADER_LEN + rec->page_used;
+    rec->page_used += len;
+    rec->stats.record_bytes += len;
+
+    return rec_ptr;
+}
+
+static uint8_t rec_block_flush( T_ecg4_recorder *rec )
+{
+    uint8_t *rec_ptr;
+    uint16_t len;
+    uint16_t cnt;
+
+    if (rec->n_samples == 0)
+    {
+        return _ECG4_REC_OK;
+    }
+
+    len = ecg4_rice_encode( rec->samples, rec->n_samples, rec->block );
+    rec->n_samples = 0;
+    rec_ptr = rec_reserve( rec, REC_SAMPLES_LEN + len );
+
+    if (rec_ptr == 0)
+    {
+        return _ECG4_REC_ERR_IO;
+    }
+
+    rec_ptr[ 0 ] = REC_TYPE_SAMPLES;
+    rec_put32( rec_ptr + 1, rec->block_n );
+
+    for (cnt = 0; cnt < len; cnt++)
+    {
+        rec_ptr[ REC_SAMPLES_LEN + cnt ] = rec->block[ cnt ];
+    }
+
+    return _ECG4_REC_OK;
+}
+
+static uint8_t rec_mount( T_ecg4_recorder *rec )
+{
+    T_ecg4_blockdev *dev;
+    T_ecg4_rec_item item;
+    uint32_t page;
+    uint32_t last;
+    uint32_t seq;
+    uint32_t end_n;
+    uint16_t used;
+    uint16_t pos;
+    uint16_t len;
+    uint16_t cnt;
+    uint8_t found;
+
+    dev = rec->dev;
+    found = 0;
+    last = 0;
+    rec->seq = 1;
+    rec->head = 0;
+    rec->n = 0;
+
+    // end of the log: newest sequence number, of the headers programmed whole, the sequence number of a page
+    // cut while it was programmed cannot be trusted
+    for (page = 0; page < dev->n_pages; page++)
+    {
+        if (dev->read( dev->ctx, page, 0, rec->page, ECG4_REC_HEADER_LEN ))
+        {
+            rec->stats.io_errors++;
+            return _ECG4_REC_ERR_IO;
+        }
+
+        rec->stats.scan_pages++;
+
+        if (rec_page_header( rec->page ))
+        {
+            seq = rec_get32( rec->page + 2 );
+
+            // wrap-aware, the sequence numbers in the log are less than 2^31 apart
+            if (!found || ((int32_t)(seq - rec->seq) >= 0))
+            {
+                rec->seq = seq + 1;
+                last = page;
+                found = 1;
+            }
+        }
+    }
+
+    if (!found)
+    {
+        return _ECG4_REC_OK;
+    }
+
+    rec->head = rec_next_page( rec, last );
+
+    // sample index: end of the records of the last valid page
+    for (page = 0; page < dev->n_pages; page++)
+    {
+        if (dev->read( dev->ctx, last, 0, rec->page, dev->page_size ))
+        {
+            rec->stats.io_errors++;
+            return _ECG4_REC_ERR_IO;
+        }
+
+        if (!rec_page_magic( rec->page ))
+        {
+            break;
+        }
+
+        if (rec_page_valid( rec, rec->page ))
+        {
+            used = ((uint16_t)rec->page[ 6 ] << 8) | rec->page[ 7 ];
+
+            for (pos = 0; (len = rec_record_parse( rec->page + ECG4_REC_HEADER_LEN, used, pos, &item )) != 0; pos += len)
+            {
+                end_n = item.n + item.n_samples;
+
+                if (end_n > rec->n)
+                {
+                    rec->n = end_n;
+                }
+            }
+
+            break;
+        }
+
+        rec->stats.bad_pages++;
+        last = (last == 0) ? dev->n_pages - 1 : last - 1;
+    }
+
+    // pages after the end of the log, up to the next erase block, must be erased to be programmed
+    while ((dev->erase_pages != 0) && (rec->head % dev->erase_pages != 0))
+    {
+        if (dev->read( dev->ctx, rec->head, 0, rec->page, dev->page_size ))
+        {
+            rec->stats.io_errors++;
+            return _ECG4_REC_ERR_IO;
+        }
+
+        cnt = 0;
+
+        while ((cnt < dev->page_size) && (rec->page[ cnt ] == 0xFF))
+        {
+            cnt++;
+        }
+
+        if (cnt == dev->page_size)
+        {
+            break;
+        }
+
+        rec->stats.bad_pages++;
+        rec->head = rec_next_page( rec, rec->head );
+    }
+
+    return _ECG4_REC_OK;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+uint8_t ecg4_rec_init( T_ecg4_recorder *rec, T_ecg4_blockdev *dev, uint8_t block_len )
+{
+    rec->dev = dev;
+    rec->page_used = 0;
+    rec->block_len = block_len;
+    rec->n_samples = 0;
+    rec->block_n = 0;
+
+    rec->stats.samples = 0;
+    rec->stats.events = 0;
+    rec->stats.record_bytes = 0;
+    rec->stats.pages = 0;
+    rec->stats.erases = 0;
+    rec->stats.flushes = 0;
+    rec->stats.io_errors = 0;
+    rec->stats.scan_pages = 0;
+    rec->stats.bad_pages = 0;
+
+    if ((block_len == 0) || (block_len > ECG4_REC_BLOCK_MAX) || (dev->page_size > ECG4_REC_PAGE_MAX) ||
+        (ECG4_REC_HEADER_LEN + REC_SAMPLES_LEN + ECG4_RICE_MAX_BYTES( block_len ) > dev->page_size) ||
+        (dev->n_pages == 0) || ((dev->erase_pages != 0) && (dev->n_pages % dev->erase_pages != 0)))
+    {
+        return _ECG4_REC_ERR_GEOMETRY;
+    }
+
+    return rec_mount( rec );
+}
+
+uint8_t ecg4_rec_push( T_ecg4_recorder *rec, int16_t sample )
+{
+    if (rec->n_samples == 0)
+    {
+        rec->block_n = rec->n;
+    }
+
+    rec->samples[ rec->n_samples++ ] = sample;
+    rec->n++;
+    rec->stats.samples++;
+
+    if (rec->n_samples == rec->block_len)
+    {
+        return rec_block_flush( rec );
+    }
+
+    return _ECG4_REC_OK;
+}
+
+uint8_t ecg4_rec_event( T_ecg4_recorder *rec, uint8_t code, uint8_t value )
+{
+    uint8_t *rec_ptr;
+
+    rec_ptr = rec_reserve( rec, REC_EVENT_LEN );
+
+    if (rec_ptr == 0)
+    {
+        return _ECG4_REC_ERR_IO;
+    }
+
+    rec_ptr[ 0 ] = REC_TYPE_EVENT;
+    rec_put32( rec_ptr + 1, rec->n );
+    rec_ptr[ 5 ] = code;
+    rec_ptr[ 6 ] = value;
+    rec->stats.events++;
+
+    return _ECG4_REC_OK;
+}
+
+uint8_t ecg4_rec_flush( T_ecg4_recorder *rec )
+{
+    if (rec_block_flush( rec ))
+    {
+        return _ECG4_REC_ERR_IO;
+    }
+
+    if (rec->page_used == 0)
+    {
+        return _ECG4_REC_OK;
+    }
+
+    rec->stats.flushes++;
+
+    return rec_program( rec );
+}
+
+void ecg4_rec_stats_get( T_ecg4_recorder *rec, T_ecg4_rec_stats *stats )
+{
+    *stats = rec->stats;
+}
+
+void ecg4_rec_iter_init( T_ecg4_recorder *rec, T_ecg4_rec_iter *it )
+{
+    it->page_idx = rec->head;
+    it->pages_left = rec->dev->n_pages;
+    it->seq = 0;
+    it->pos = 0;
+    it->used = 0;
+}
+
+uint8_t ecg4_rec_iter_next( T_ecg4_recorder *rec, T_ecg4_rec_iter *it, T_ecg4_rec_item *item )
+{
+    T_ecg4_blockdev *dev;
+    uint16_t len;
+
+    dev = rec->dev;
+
+    for (;;)
+    {
+        if (it->pos < it->used)
+        {
+            len = rec_record_parse( it->page + ECG4_REC_HEADER_LEN, it->used, it->pos, item );
+
+            if (len != 0)
+            {
+                it->pos += len;
+                return 1;
+            }
+
+            it->pos = it->used;
+        }
+
+        if (it->pages_left == 0)
+        {
+            return 0;
+        }
+
+        it->pages_left--;
+        it->pos = 0;
+        it->used = 0;
+
+        if (dev->read( dev->ctx, it->page_idx, 0, it->page, dev->page_size ))
+        {
+            rec->stats.io_errors++;
+        }
+        else if (rec_page_valid( rec, it->page ))
+        {
+            it->seq = rec_get32( it->page + 2 );
+            it->used = ((uint16_t)it->page[ 6 ] << 8) | it->page[ 7 ];
+        }
+
+        it->page_idx = rec_next_page( rec, it->page_idx );
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_recorder.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,306 @@
+/*
+    __ecg4_recorder.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_recorder.h
+@brief    ECG_4 Recorder
+*/
+/**
+@defgroup   ECG4_RECORDER
+@brief      ECG_4 Recorder
+@{
+
+Append-only, page aligned recorder of the raw data and of the heart rate and signal quality events,
+over a small block device HAL (SPI NOR flash, SD card, ...).
+
+Raw data is compressed in blocks with __ecg4_rice. Records are packed in pages, a page is programmed once,
+when it is full or on ecg4_rec_flush, and pages are written in a circle, erasing the oldest erase block
+when the log wraps.
+
+| Offset | Size | Page header                                                            |
+|:------:|:----:|:-----------------------------------------------------------------------|
+| 0      | 2    | magic 0x45 0x34                                                        |
+| 2      | 4    | page sequence number, big endian                                       |
+| 6      | 2    | payload bytes used, big endian                                         |
+| 8      | 2    | CRC-16 of the header bytes 0 - 7 and of the payload                    |
+| 10     | 1    | format version, 2                                                      |
+| 11     | 1    | header check, low byte of the CRC-16 of the bytes 0 - 7, 0x00 for 0xFF |
+
+| Record  | Content                                                                       |
+|:-------:|:------------------------------------------------------------------------------|
+| Samples | 0x01, sample index of the first sample (4 bytes), __ecg4_rice block           |
+| Event   | 0x02, sample index (4 bytes), code, value                                     |
+
+Event codes are the data row codes (_ECG4_SIGNAL_QUALITY_CODE_BYTE, _ECG4_HEART_RATE_CODE_BYTE) or
+application codes.
+
+ecg4_rec_init mounts the device with a recovery scan: the page with the newest sequence number (compared
+wrap-aware) among the pages with a whole header is the end of the log. The header is programmed first and its
+check byte last, and the check is never 0xFF, so a page cut inside its header is not taken for the end of the
+log with a sequence number left erased. Pages with a bad CRC (interrupted programming) are skipped, and the
+sample index continues from the last valid page. Only the data in the RAM page buffer is lost on a power cut, ecg4_rec_flush bounds it at
+the cost of partly filled pages.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+#include "__ecg4_rice.h"
+
+#ifndef _ECG4_RECORDER_H_
+#define _ECG4_RECORDER_H_
+
+/** @defgroup ECG4_RECORDER_VAR Variables */                  /** @{ */
+
+/**
+ * @macro ECG4_REC_PAGE_MAX
+ * @brief Largest supported page size in bytes
+ */
+#ifndef ECG4_REC_PAGE_MAX
+#define ECG4_REC_PAGE_MAX       512
+#endif
+
+/**
+ * @macro ECG4_REC_BLOCK_MAX
+ * @brief Largest number of samples in a compressed block
+ */
+#ifndef ECG4_REC_BLOCK_MAX
+#define ECG4_REC_BLOCK_MAX      64
+#endif
+
+#define ECG4_REC_HEADER_LEN     12
+
+extern const uint8_t _ECG4_REC_OK                       ;
+extern const uint8_t _ECG4_REC_ERR_IO                   ;
+extern const uint8_t _ECG4_REC_ERR_GEOMETRY             ;
+
+extern const uint8_t _ECG4_REC_ITEM_SAMPLES             ;
+extern const uint8_t _ECG4_REC_ITEM_EVENT               ;
+
+                                                                       /** @} */
+/** @defgroup ECG4_RECORDER_TYPES Types */                    /** @{ */
+
+/**
+ * @struct T_ecg4_blockdev
+ * @brief Block device HAL, the functions return 0 on success
+ */
+typedef struct
+{
+    void     *ctx;              /**< Passed to the functions */
+    uint16_t page_size;         /**< Program unit in bytes */
+    uint16_t erase_pages;       /**< Pages in an erase block, 0 - pages can be rewritten without erase */
+    uint32_t n_pages;           /**< Number of pages, a multiple of erase_pages */
+    uint8_t ( *read )( void *ctx, uint32_t page, uint16_t offset, uint8_t *buf, uint16_t len );
+    uint8_t ( *prog )( void *ctx, uint32_t page, const uint8_t *buf );
+    uint8_t ( *erase )( void *ctx, uint32_t block );
+
+}T_ecg4_blockdev;
+
+/**
+ * @struct T_ecg4_rec_stats
+ * @brief Recorder statistics
+ */
+typedef struct
+{
+    uint32_t samples;           /**< Samples pushed */
+    uint32_t events;            /**< Events recorded */
+    uint32_t record_bytes;      /**< Record bytes appended to pages */
+    uint32_t pages;             /**< Pages programmed */
+    uint32_t erases;            /**< Erase blocks erased */
+    uint32_t flushes;           /**< Partly filled pages programmed by ecg4_rec_flush */
+    uint32_t io_errors;
+    uint32_t scan_pages;        /**< Pages examined by the last recovery scan */
+    uint32_t bad_pages;         /**< Pages skipped by the last recovery scan */
+
+}T_ecg4_rec_stats;
+
+/**
+ * @struct T_ecg4_recorder
+ * @brief Recorder context
+ */
+typedef struct
+{
+    T_ecg4_blockdev *dev;
+    uint8_t  page[ ECG4_REC_PAGE_MAX ];
+    uint16_t page_used;         /**< Payload bytes in the page buffer */
+    uint32_t head;              /**< Next page to program */
+    uint32_t seq;               /**< Sequence number of the next page */
+    uint8_t  block_len;         /**< Samples per compressed block */
+    uint8_t  n_samples;         /**< Samples in the block buffer */
+    int16_t  samples[ ECG4_REC_BLOCK_MAX ];
+    uint8_t  block[ ECG4_RICE_MAX_BYTES( ECG4_REC_BLOCK_MAX ) ];
+    uint32_t block_n;           /**< Sample index of the first sample in the block buffer */
+    uint32_t n;                 /**< Index of the next pushed sample */
+    T_ecg4_rec_stats stats;
+
+}T_ecg4_recorder;
+
+/**
+ * @struct T_ecg4_rec_item
+ * @brief Record read back by ecg4_rec_iter_next
+ */
+typedef struct
+{
+    uint8_t  type;              /**< _ECG4_REC_ITEM_SAMPLES or _ECG4_REC_ITEM_EVENT */
+    uint32_t n;                 /**< Sample index of the first sample, or of the event */
+    uint8_t  code;              /**< Event code */
+    uint8_t  value;             /**< Event value */
+    uint8_t  n_samples;
+    int16_t  samples[ ECG4_REC_BLOCK_MAX ];
+
+}T_ecg4_rec_item;
+
+/**
+ * @struct T_ecg4_rec_iter
+ * @brief Read back position
+ */
+typedef struct
+{
+    uint8_t  page[ ECG4_REC_PAGE_MAX ];
+    uint32_t page_idx;          /**< Next page to load */
+    uint32_t pages_left;
+    uint32_t seq;               /**< Sequence number of the loaded page */
+    uint16_t pos;
+    uint16_t used;
+
+}T_ecg4_rec_iter;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_RECORDER_FUNC Recorder Functions */        /** @{ */
+
+/**
+ * @brief Recorder Init function
+ *
+ * @param[in] rec        Recorder context
+ * @param[in] dev        Block device
+ * @param[in] block_len  Samples per compressed block, 1 - ECG4_REC_BLOCK_MAX
+ *
+ * @returns _ECG4_REC_OK, _ECG4_REC_ERR_IO or _ECG4_REC_ERR_GEOMETRY
+ *
+ * Function mounts the device with the recovery scan, recording continues after the last valid page.
+ * @note The scan reads the header of every page once.
+ */
+uint8_t ecg4_rec_init( T_ecg4_recorder *rec, T_ecg4_blockdev *dev, uint8_t block_len );
+
+/**
+ * @brief Recorder Push function
+ *
+ * @param[in] rec     Recorder context
+ * @param[in] sample  Raw data sample
+ *
+ * @returns _ECG4_REC_OK or _ECG4_REC_ERR_IO
+ */
+uint8_t ecg4_rec_push( T_ecg4_recorder *rec, int16_t sample );
+
+/**
+ * @brief Recorder Event function
+ *
+ * @param[in] rec    Recorder context
+ * @param[in] code   Event code
+ * @param[in] value  Event value
+ *
+ * @returns _ECG4_REC_OK or _ECG4_REC_ERR_IO
+ *
+ * Function records an event at the index of the next pushed sample.
+ */
+uint8_t ecg4_rec_event( T_ecg4_recorder *rec, uint8_t code, uint8_t value );
+
+/**
+ * @brief Recorder Flush function
+ *
+ * @param[in] rec  Recorder context
+ *
+ * @returns _ECG4_REC_OK or _ECG4_REC_ERR_IO
+ *
+ * Function compresses the buffered samples and programs the partly filled page.
+ */
+uint8_t ecg4_rec_flush( T_ecg4_recorder *rec );
+
+/**
+ * @brief Recorder Statistics function
+ *
+ * @param[in]  rec    Recorder context
+ * @param[out] stats  Recorder statistics
+ */
+void ecg4_rec_stats_get( T_ecg4_recorder *rec, T_ecg4_rec_stats *stats );
+
+/**
+ * @brief Recorder Read Back Init function
+ *
+ * @param[in]  rec  Recorder context
+ * @param[out] it   Read back position, at the oldest page
+ */
+void ecg4_rec_iter_init( T_ecg4_recorder *rec, T_ecg4_rec_iter *it );
+
+/**
+ * @brief Recorder Read Back function
+ *
+ * @param[in]  rec   Recorder context
+ * @param[in]  it    Read back position
+ * @param[out] item  Record
+ *
+ * @returns 1 - record read, 0 - end of the log
+ *
+ * Function reads the programmed pages from the oldest to the newest, pages with a bad CRC are skipped.
+ * @note Records still in the RAM page buffer are not read back.
+ */
+uint8_t ecg4_rec_iter_next( T_ecg4_recorder *rec, T_ecg4_rec_iter *it, T_ecg4_rec_item *item );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_recorder.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
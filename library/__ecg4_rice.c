@@ -0,0 +1,371 @@
+/*
+    __ecg4_rice.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_rice.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define RICE_HEADER_LEN         4
+#define RICE_K_MAX              15
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_RICE_BLOCK_RICE              = 0x00;
+const uint8_t _ECG4_RICE_BLOCK_RAW               = 0x01;
+
+/* ----------------------------------------------------------------- TYPEDEFS */
+
+typedef struct
+{
+    uint8_t  *buf;
+    uint16_t idx;
+    uint8_t  bits;      /**< Bits used in buf[ idx ] */
+
+}T_rice_writer;
+
+typedef struct
+{
+    const uint8_t *buf;
+    uint16_t len;
+    uint16_t idx;
+    uint8_t  bits;      /**< Bits consumed from buf[ idx ] */
+
+}T_rice_reader;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static uint16_t rice_zigzag( int16_t cur, int16_t prev )
+{
+    uint16_t delta;
+
+    delta = (uint16_t)cur - (uint16_t)prev;
+
+    if (delta & 0x8000)
+    {
+        delta = ~delta;
+        return (delta << 1) | 1;
+    }
+
+    return delta << 1;
+}
+
+static int16_t rice_unzigzag( uint16_t zz, int16_t prev )
+{
+    uint16_t delta;
+
+    if (zz & 1)
+    {
+        delta = ~(zz >> 1);
+    }
+    else
+    {
+        delta = zz >> 1;
+    }
+
+    return (int16_t)((uint16_t)prev + delta);
+}
+
+static void rice_put_bit( T_rice_writer *wr, uint8_t bit )
+{
+    if (wr->bits == 0)
+    {
+        wr->buf[ wr->idx ] = 0;
+    }
+
+    if (bit)
+    {
+        wr->buf[ wr->idx ] |= 0x80 >> wr->bits;
+    }
+
+    if (++wr->bits == 8)
+    {
+        wr->bits = 0;
+        wr->idx++;
+    }
+}
+
+static int8_t rice_get_bit( T_rice_reader *rd )
+{
+    uint8_t bit;
+
+    if (rd->idx >= rd->len)
+    {
+        return -1;
+    }
+
+    bit = (rd->buf[ rd->idx ] >> (7 - rd->bits)) & 1;
+
+    if (++rd->bits == 8)
+    {
+        rd->bits = 0;
+        rd->idx++;
+    }
+
+    return bit;
+}
+
+static uint8_t rice_pick_k( const int16_t *samples, uint8_t n_samples, uint32_t *bits )
+{
+    uint32_t sum;
+    uint32_t cost[ 3 ];
+    uint16_t zz;
+    uint8_t  k;
+    uint8_t  cnt;
+    uint8_t  best;
+
+    sum = 0;
+
+    for (cnt = 1; cnt < n_samples; cnt++)
+    {
+        sum += rice_zigzag( samples[ cnt ], samples[ cnt - 1 ] );
+    }
+
+    // k close to log2 of the mean, the exact cost decides between k - 1, k and k + 1
+    k = 0;
+
+    while ((k < RICE_K_MAX - 1) && (((uint32_t)(n_samples - 1) << (k + 1)) <= sum))
+    {
+        k++;
+    }
+
+    if (k == 0)
+    {
+        k = 1;
+    }
+
+    cost[ 0 ] = 0;
+    cost[ 1 ] = 0;
+    cost[ 2 ] = 0;
+
+    for (cnt = 1; cnt < n_samples; cnt++)
+    {
+        zz = rice_zigzag( samples[ cnt ], samples[ cnt - 1 ] );
+        cost[ 0 ] += (uint32_t)(zz >> (k - 1)) + k;
+        cost[ 1 ] += (uint32_t)(zz >> k) + k + 1;
+        cost[ 2 ] += (uint32_t)(zz >> (k + 1)) + k + 2;
+    }
+
+    best = 0;
+
+    for (cnt = 1; cnt < 3; cnt++)
+    {
+        if (cost[ cnt ] < cost[ best ])
+        {
+            best = cnt;
+        }
+    }
+
+    *bits = cost[ best ];
+
+    return k - 1 + best;
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+uint16_t ecg4_rice_encode( const int16_t *samples, uint8_t n_samples, uint8_t *block )
+{
+    T_rice_writer wr;
+    uint32_t bits;
+    uint16_t zz;
+    uint16_t q;
+    uint8_t  k;
+    uint8_t  cnt;
+    int8_t   bit;
+
+    if (n_samples == 0)
+    {
+        return 0;
+    }
+
+    block[ 1 ] = n_samples;
+    block[ 2 ] = (uint16_t)samples[ 0 ] >> 8;
+    block[ 3 ] = (uint16_t)samples[ 0 ] & 0xFF;
+
+    k = rice_pick_k( samples, n_samples, &bits );
+
+    if (((bits + 7) >> 3) >= 2 * (uint32_t)(n_samples - 1))
+    {
+        block[ 0 ] = _ECG4_RICE_BLOCK_RAW << 4;
+
+        for (cnt = 1; cnt < n_samples; cnt++)
+        {
+            block[ 2 * cnt + 2 ] = (uint16_t)samples[ cnt ] >> 8;
+            block[ 2 * cnt + 3 ] = (uint16_t)samples[ cnt ] & 0xFF;
+        }
+
+        return ECG4_RICE_MAX_BYTES( n_samples );
+    }
+
+    block[ 0 ] = (_ECG4_RICE_BLOCK_RICE << 4) | k;
+
+    wr.buf = block;
+    wr.idx = RICE_HEADER_LEN;
+    wr.bits = 0;
+
+    for (cnt = 1; cnt < n_samples; cnt++)
+    {
+        zz = rice_zigzag( samples[ cnt ], samples[ cnt - 1 ] );
+
+        for (q = zz >> k; q != 0; q--)
+        {
+            rice_put_bit( &wr, 1 );
+        }
+
+        rice_put_bit( &wr, 0 );
+
+        for (bit = k - 1; bit >= 0; bit--)
+        {
+            rice_put_bit( &wr, (zz >> bit) & 1 );
+        }
+    }
+
+    if (wr.bits != 0)
+    {
+        wr.idx++;
+    }
+
+    return wr.idx;
+}
+
+uint8_t ecg4_rice_decode( const uint8_t *block, uint16_t block_len, int16_t *samples, uint16_t *used )
+{
+    T_rice_reader rd;
+    uint16_t zz;
+    uint16_t q;
+    uint8_t  k;
+    uint8_t  n_samples;
+    uint8_t  cnt;
+    uint8_t  bit_cnt;
+    int8_t   bit;
+
+    if (block_len < RICE_HEADER_LEN)
+    {
+        return 0;
+    }
+
+    n_samples = block[ 1 ];
+    k = block[ 0 ] & 0x0F;
+
+    if (n_samples == 0)
+    {
+        return 0;
+    }
+
+    samples[ 0 ] = (int16_t)(((uint16_t)block[ 2 ] << 8) | block[ 3 ]);
+
+    if ((block[ 0 ] >> 4) == _ECG4_RICE_BLOCK_RAW)
+    {
+        if (block_len < ECG4_RICE_MAX_BYTES( n_samples ))
+        {
+            return 0;
+        }
+
+        for (cnt = 1; cnt < n_samples; cnt++)
+        {
+            samples[ cnt ] = (int16_t)(((uint16_t)block[ 2 * cnt + 2 ] << 8) | block[ 2 * cnt + 3 ]);
+        }
+
+        *used = ECG4_RICE_MAX_BYTES( n_samples );
+
+        return n_samples;
+    }
+
+    if (((block[ 0 ] >> 4) != _ECG4_RICE_BLOCK_RICE) || (k > RICE_K_MAX))
+    {
+        return 0;
+    }
+
+    rd.buf = block;
+    rd.len = block_len;
+    rd.idx = RICE_HEADER_LEN;
+    rd.bits = 0;
+
+    for (cnt = 1; cnt < n_samples; cnt++)
+    {
+        q = 0;
+
+        while ((bit = rice_get_bit( &rd )) == 1)
+        {
+            q++;
+        }
+
+        if (bit < 0)
+        {
+            return 0;
+        }
+
+        zz = q << k;
+
+        for (bit_cnt = k; bit_cnt != 0; bit_cnt--)
+        {
+            bit = rice_get_bit( &rd );
+
+            if (bit < 0)
+            {
+                return 0;
+            }
+
+            zz |= (uint16_t)bit << (bit_cnt - 1);
+        }
+
+        samples[ cnt ] = rice_unzigzag( zz, samples[ cnt - 1 ] );
+    }
+
+    if (rd.bits != 0)
+    {
+        rd.idx++;
+    }
+
+    *used = rd.idx;
+
+    return n_samples;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_rice.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+    __ecg4_rice.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_rice.h
+@brief    ECG_4 Raw Data Compression
+*/
+/**
+@defgroup   ECG4_RICE
+@brief      ECG_4 Raw Data Compression
+@{
+
+Lossless, integer-only compression of the raw data: delta coding followed by Rice coding with a parameter
+picked per block. Blocks are independent and self-delimiting, so they can be concatenated on a link
+and decoded one after another.
+
+| Offset | Size         | Content                                                               |
+|:------:|:------------:|:----------------------------------------------------------------------|
+| 0      | 1            | block type (high nibble, 0 - Rice, 1 - raw) and Rice parameter k      |
+| 1      | 1            | number of samples n, 1 - 255                                          |
+| 2      | 2            | first sample, big endian                                              |
+| 4      | rest         | Rice: n - 1 zigzag coded deltas, unary quotient (ones ended by a zero)|
+|        |              | and k bits of remainder, MSB first, padded to a byte                  |
+|        |              | Raw: n - 1 samples, big endian                                        |
+
+A block is never larger than its raw form, 2 + 2 n bytes: the encoder falls back to the raw type
+when the Rice code would be larger. Deltas are taken modulo 2^16, so any input is coded losslessly.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+
+#ifndef _ECG4_RICE_H_
+#define _ECG4_RICE_H_
+
+/** @defgroup ECG4_RICE_VAR Variables */                      /** @{ */
+
+/**
+ * @macro ECG4_RICE_MAX_BYTES
+ * @brief Largest block size in bytes for n samples
+ */
+#define ECG4_RICE_MAX_BYTES( n )    ( 2 + 2 * ( n ) )
+
+extern const uint8_t _ECG4_RICE_BLOCK_RICE              ;
+extern const uint8_t _ECG4_RICE_BLOCK_RAW               ;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_RICE_FUNC Compression Functions */         /** @{ */
+
+/**
+ * @brief Rice Encode function
+ *
+ * @param[in]  samples    Raw data samples
+ * @param[in]  n_samples  Number of samples, 1 - 255
+ * @param[out] block      Encoded block, ECG4_RICE_MAX_BYTES( n_samples ) bytes
+ *
+ * @returns Size of the encoded block in bytes, 0 - invalid number of samples
+ */
+uint16_t ecg4_rice_encode( const int16_t *samples, uint8_t n_samples, uint8_t *block );
+
+/**
+ * @brief Rice Decode function
+ *
+ * @param[in]  block      Encoded block
+ * @param[in]  block_len  Number of bytes available at block
+ * @param[out] samples    Decoded samples, 255 samples at most
+ * @param[out] used       Size of the decoded block in bytes
+ *
+ * @returns Number of decoded samples, 0 - incomplete or invalid block
+ */
+uint8_t ecg4_rice_decode( const uint8_t *block, uint16_t block_len, int16_t *samples, uint16_t *used );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_rice.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
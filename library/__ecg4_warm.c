@@ -0,0 +1,195 @@
+/*
+    __ecg4_warm.c
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "__ecg4_warm.h"
+#include "__ecg4_crc.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define WARM_MAGIC_0            0x45
+#define WARM_MAGIC_1            0x57
+#define WARM_VERSION            0x01
+
+#define WARM_SECTION_QRS        0x01
+#define WARM_SECTION_FILTER     0x02
+#define WARM_SECTION_HR         0x04
+
+#define WARM_QRS_OFFSET         4
+#define WARM_FILTER_OFFSET      10
+#define WARM_HR_OFFSET          17
+#define WARM_CRC_OFFSET         21
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+const uint8_t _ECG4_WARM_OK                      = 0x00;
+const uint8_t _ECG4_WARM_ERR_NVM                 = 0x01;
+const uint8_t _ECG4_WARM_ERR_BLOB                = 0x02;
+
+/* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
+
+static void warm_put16( uint8_t *buf, uint16_t val )
+{
+    buf[ 0 ] = val >> 8;
+    buf[ 1 ] = val;
+}
+
+static uint16_t warm_get16( const uint8_t *buf )
+{
+    return ((uint16_t)buf[ 0 ] << 8) | buf[ 1 ];
+}
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+
+void ecg4_warm_pack( T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr, uint8_t *blob )
+{
+    uint8_t cnt;
+
+    for (cnt = 0; cnt < ECG4_WARM_BLOB_LEN; cnt++)
+    {
+        blob[ cnt ] = 0;
+    }
+
+    blob[ 0 ] = WARM_MAGIC_0;
+    blob[ 1 ] = WARM_MAGIC_1;
+    blob[ 2 ] = WARM_VERSION;
+
+    if (qrs != 0)
+    {
+        blob[ 3 ] |= WARM_SECTION_QRS;
+        warm_put16( blob + WARM_QRS_OFFSET, qrs->spki );
+        warm_put16( blob + WARM_QRS_OFFSET + 2, qrs->npki );
+        warm_put16( blob + WARM_QRS_OFFSET + 4, qrs->rr_avg );
+    }
+
+    if (flt != 0)
+    {
+        blob[ 3 ] |= WARM_SECTION_FILTER;
+        blob[ WARM_FILTER_OFFSET ] = flt->hp_shift;
+        warm_put16( blob + WARM_FILTER_OFFSET + 1, (uint16_t)flt->hp_x1 );
+        warm_put16( blob + WARM_FILTER_OFFSET + 3, (uint16_t)((uint32_t)flt->hp_acc >> 16) );
+        warm_put16( blob + WARM_FILTER_OFFSET + 5, (uint16_t)flt->hp_acc );
+    }
+
+    if (hr != 0)
+    {
+        blob[ 3 ] |= WARM_SECTION_HR;
+        warm_put16( blob + WARM_HR_OFFSET, hr->rr_avg_q4 );
+        warm_put16( blob + WARM_HR_OFFSET + 2, hr->rr );
+    }
+
+    warm_put16( blob + WARM_CRC_OFFSET, ecg4_crc16( ECG4_CRC16_INIT, blob, WARM_CRC_OFFSET ) );
+}
+
+uint8_t ecg4_warm_unpack( const uint8_t *blob, T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr )
+{
+    if ((blob[ 0 ] != WARM_MAGIC_0) || (blob[ 1 ] != WARM_MAGIC_1) || (blob[ 2 ] != WARM_VERSION) ||
+        (warm_get16( blob + WARM_CRC_OFFSET ) != ecg4_crc16( ECG4_CRC16_INIT, blob, WARM_CRC_OFFSET )))
+    {
+        return _ECG4_WARM_ERR_BLOB;
+    }
+
+    if ((qrs != 0) && (blob[ 3 ] & WARM_SECTION_QRS))
+    {
+        ecg4_qrs_warm_start( qrs, warm_get16( blob + WARM_QRS_OFFSET ), warm_get16( blob + WARM_QRS_OFFSET + 2 ),
+                             warm_get16( blob + WARM_QRS_OFFSET + 4 ) );
+    }
+
+    if ((flt != 0) && (blob[ 3 ] & WARM_SECTION_FILTER) && (blob[ WARM_FILTER_OFFSET ] == flt->hp_shift))
+    {
+        flt->hp_x1 = (int16_t)warm_get16( blob + WARM_FILTER_OFFSET + 1 );
+        flt->hp_acc = (int32_t)(((uint32_t)warm_get16( blob + WARM_FILTER_OFFSET + 3 ) << 16) |
+                                warm_get16( blob + WARM_FILTER_OFFSET + 5 ));
+    }
+
+    if ((hr != 0) && (blob[ 3 ] & WARM_SECTION_HR))
+    {
+        ecg4_hr_warm_start( hr, warm_get16( blob + WARM_HR_OFFSET ), warm_get16( blob + WARM_HR_OFFSET + 2 ) );
+    }
+
+    return _ECG4_WARM_OK;
+}
+
+uint8_t ecg4_warm_save( T_ecg4_nvm *nvm, T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr )
+{
+    uint8_t blob[ ECG4_WARM_BLOB_LEN ];
+
+    ecg4_warm_pack( qrs, flt, hr, blob );
+
+    if (nvm->write( nvm->addr, blob, ECG4_WARM_BLOB_LEN ))
+    {
+        return _ECG4_WARM_ERR_NVM;
+    }
+
+    return _ECG4_WARM_OK;
+}
+
+uint8_t ecg4_warm_load( T_ecg4_nvm *nvm, T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr )
+{
+    uint8_t blob[ ECG4_WARM_BLOB_LEN ];
+    uint8_t err;
+
+    if (nvm->read( nvm->addr, blob, ECG4_WARM_BLOB_LEN ))
+    {
+        err = _ECG4_WARM_ERR_NVM;
+    }
+    else
+    {
+        err = ecg4_warm_unpack( blob, qrs, flt, hr );
+    }
+
+    if ((err != _ECG4_WARM_OK) && (qrs != 0))
+    {
+        ecg4_qrs_init( qrs );
+    }
+
+    return err;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_warm.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
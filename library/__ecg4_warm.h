@@ -0,0 +1,183 @@
+/*
+    __ecg4_warm.h
+
+-----------------------------------------------------------------------------
+
+  This file is part of mikroSDK.
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+/**
+@file   __ecg4_warm.h
+@brief    ECG_4 Warm Start
+*/
+/**
+@defgroup   ECG4_WARM
+@brief      ECG_4 Warm Start
+@{
+
+Snapshot of the adaptive state of the QRS detector, of the baseline filter and of the heart rate in a small
+versioned blob, saved to and restored from EEPROM or flash through the read and write hooks of T_ecg4_nvm.
+Restoring it at start-up, or after ecg4_reset, skips the 2 s learning phase of the QRS detector.
+The time of the last R peak is not kept, so the first RR interval is measured at the second beat after
+the restart; with the restored heart rate average it is confident from that beat on when the rhythm
+has not changed by more than 20%.
+
+| Offset | Size | Content                                                                   |
+|:------:|:----:|:--------------------------------------------------------------------------|
+| 0      | 2    | magic 0x45 0x57                                                           |
+| 2      | 1    | version                                                                   |
+| 3      | 1    | sections present: 0x01 - QRS detector, 0x02 - filter, 0x04 - heart rate   |
+| 4      | 6    | QRS detector: signal peak level, noise peak level, average RR interval    |
+| 10     | 7    | filter: high-pass shift, last input, high-pass accumulator                |
+| 17     | 4    | heart rate: average RR interval (Q4), last RR interval                    |
+| 21     | 2    | CRC-16 of the bytes 0 - 20                                                |
+
+Multi-byte values are big endian. A blob with an unknown version or a bad CRC is not restored.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#include "stdint.h"
+#include "__ecg4_qrs.h"
+#include "__ecg4_filter.h"
+#include "__ecg4_hr.h"
+
+#ifndef _ECG4_WARM_H_
+#define _ECG4_WARM_H_
+
+/** @defgroup ECG4_WARM_VAR Variables */                      /** @{ */
+
+/**
+ * @macro ECG4_WARM_BLOB_LEN
+ * @brief Size of the blob in bytes
+ */
+#define ECG4_WARM_BLOB_LEN      23
+
+extern const uint8_t _ECG4_WARM_OK                      ;
+extern const uint8_t _ECG4_WARM_ERR_NVM                 ;
+extern const uint8_t _ECG4_WARM_ERR_BLOB                ;
+
+                                                                       /** @} */
+/** @defgroup ECG4_WARM_TYPES Types */                        /** @{ */
+
+/**
+ * @struct T_ecg4_nvm
+ * @brief EEPROM or flash hooks, the functions return 0 on success
+ */
+typedef struct
+{
+    uint8_t ( *read )( uint16_t addr, uint8_t *buf, uint16_t len );
+    uint8_t ( *write )( uint16_t addr, const uint8_t *buf, uint16_t len );
+    uint16_t addr;              /**< Address of the blob */
+
+}T_ecg4_nvm;
+
+                                                                       /** @} */
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/** @defgroup ECG4_WARM_FUNC Warm Start Functions */          /** @{ */
+
+/**
+ * @brief Warm Start Pack function
+ *
+ * @param[in]  qrs   QRS detector context, 0 - not saved
+ * @param[in]  flt   Filter chain state, 0 - not saved
+ * @param[in]  hr    Heart rate context, 0 - not saved
+ * @param[out] blob  ECG4_WARM_BLOB_LEN bytes
+ */
+void ecg4_warm_pack( T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr, uint8_t *blob );
+
+/**
+ * @brief Warm Start Unpack function
+ *
+ * @param[in] blob  ECG4_WARM_BLOB_LEN bytes
+ * @param[in] qrs   QRS detector context, warm started, 0 - not restored
+ * @param[in] flt   Filter chain state, initialized by ecg4_filter_init, 0 - not restored
+ * @param[in] hr    Heart rate context, warm started, 0 - not restored
+ *
+ * @returns _ECG4_WARM_OK or _ECG4_WARM_ERR_BLOB
+ *
+ * Function restores the sections present in the blob. The filter section is skipped when the high-pass
+ * shift differs from the one of flt. Nothing is restored from an invalid blob.
+ */
+uint8_t ecg4_warm_unpack( const uint8_t *blob, T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr );
+
+/**
+ * @brief Warm Start Save function
+ *
+ * @param[in] nvm  EEPROM or flash hooks
+ * @param[in] qrs  QRS detector context, 0 - not saved
+ * @param[in] flt  Filter chain state, 0 - not saved
+ * @param[in] hr   Heart rate context, 0 - not saved
+ *
+ * @returns _ECG4_WARM_OK or _ECG4_WARM_ERR_NVM
+ *
+ * @note Save only while the detector is locked on the signal, e.g. when ecg4_hr_confident returns 1.
+ */
+uint8_t ecg4_warm_save( T_ecg4_nvm *nvm, T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr );
+
+/**
+ * @brief Warm Start Load function
+ *
+ * @param[in] nvm  EEPROM or flash hooks
+ * @param[in] qrs  QRS detector context, warm started, 0 - not restored
+ * @param[in] flt  Filter chain state, initialized by ecg4_filter_init, 0 - not restored
+ * @param[in] hr   Heart rate context, initialized by ecg4_hr_init, 0 - not restored
+ *
+ * @returns _ECG4_WARM_OK, _ECG4_WARM_ERR_NVM or _ECG4_WARM_ERR_BLOB
+ *
+ * Function falls back to a cold start of the QRS detector when no valid blob is stored.
+ */
+uint8_t ecg4_warm_load( T_ecg4_nvm *nvm, T_ecg4_qrs *qrs, T_ecg4_filter *flt, T_ecg4_hr *hr );
+
+                                                                       /** @} */
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif
+                                                                       /** @} */
+/* -------------------------------------------------------------------------- */
+/*
+  __ecg4_warm.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file